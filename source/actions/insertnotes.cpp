@@ -19,6 +19,7 @@
 
 #include <optional>
 #include <score/system.h>
+#include <score/utils.h>
 #include <score/voiceutils.h>
 
 InsertNotes::InsertNotes(const ScoreLocation &location,
@@ -71,32 +72,32 @@ InsertNotes::InsertNotes(const ScoreLocation &location,
 void InsertNotes::redo()
 {
     // Shift existing notes / barlines to the right if necessary.
-    for (int i = 0; i < myShiftAmount; ++i)
+    if (myShiftAmount > 0)
     {
-        SystemUtils::shiftForward(myLocation.getSystem(),
-                                  myLocation.getPositionIndex());
+        SystemUtils::shift(myLocation.getSystem(),
+                           myLocation.getPositionIndex(), myShiftAmount);
     }
 
     // Insert the new items.
-    for (const Position &pos : myNewPositions)
-        myLocation.getVoice().insertPosition(pos);
-    for (const IrregularGrouping &group : myNewGroups)
-        myLocation.getVoice().insertIrregularGrouping(group);
+    myLocation.getVoice().insertPositions(myNewPositions);
+    myLocation.getVoice().insertIrregularGroupings(myNewGroups);
 }
 
 void InsertNotes::undo()
 {
-    // Remove the items that were added.
-    for (const Position &pos : myNewPositions)
-        myLocation.getVoice().removePosition(pos);
+    // Remove the items that were added. Any existing items in this range were
+    // shifted out of the way.
+    myLocation.getVoice().removePositions(
+        ScoreUtils::InPositionRange(myNewPositions.front().getPosition(),
+                                    myNewPositions.back().getPosition()));
 
     for (const IrregularGrouping &group : myNewGroups)
         myLocation.getVoice().removeIrregularGrouping(group);
 
     // Undo any shifting that was performed.
-    for (int i = 0; i < myShiftAmount; ++i)
+    if (myShiftAmount > 0)
     {
-        SystemUtils::shiftBackward(myLocation.getSystem(),
-                                   myLocation.getPositionIndex());
+        SystemUtils::shift(myLocation.getSystem(),
+                           myLocation.getPositionIndex(), -myShiftAmount);
     }
 }
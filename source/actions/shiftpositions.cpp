@@ -30,28 +30,12 @@ ShiftPositions::ShiftPositions(const ScoreLocation &location,
 
 void ShiftPositions::redo()
 {
-    if (myShiftType == Forward)
-    {
-        SystemUtils::shiftForward(myLocation.getSystem(),
-                                  myLocation.getPositionIndex());
-    }
-    else
-    {
-        SystemUtils::shiftBackward(myLocation.getSystem(),
-                                   myLocation.getPositionIndex());
-    }
+    SystemUtils::shift(myLocation.getSystem(), myLocation.getPositionIndex(),
+                       myShiftType == Forward ? 1 : -1);
 }
 
 void ShiftPositions::undo()
 {
-    if (myShiftType == Forward)
-    {
-        SystemUtils::shiftBackward(myLocation.getSystem(),
-                                   myLocation.getPositionIndex());
-    }
-    else
-    {
-        SystemUtils::shiftForward(myLocation.getSystem(),
-                                  myLocation.getPositionIndex());
-    }
+    SystemUtils::shift(myLocation.getSystem(), myLocation.getPositionIndex(),
+                       myShiftType == Forward ? -1 : 1);
 }
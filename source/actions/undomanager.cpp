@@ -17,6 +17,37 @@
 
 #include "undomanager.h"
 
+#include <memory>
+#include <util/tracing.h>
+
+namespace
+{
+/// Wraps a command to record trace spans when it is undone or redone.
+class TracedCommand : public QUndoCommand
+{
+public:
+    explicit TracedCommand(QUndoCommand *cmd)
+        : QUndoCommand(cmd->actionText()), myCommand(cmd)
+    {
+    }
+
+    void redo() override
+    {
+        PTE_TRACE_SCOPE_DETAIL("Redo", myCommand->actionText().toStdString());
+        myCommand->redo();
+    }
+
+    void undo() override
+    {
+        PTE_TRACE_SCOPE_DETAIL("Undo", myCommand->actionText().toStdString());
+        myCommand->undo();
+    }
+
+private:
+    std::unique_ptr<QUndoCommand> myCommand;
+};
+} // namespace
+
 UndoManager::UndoManager(QObject *parent) :
     QUndoGroup(parent)
 {
@@ -49,6 +80,14 @@ void UndoManager::push(QUndoCommand *cmd)
 
 void UndoManager::push(QUndoCommand *cmd, int affectedSystem)
 {
+    PTE_TRACE_SCOPE_DETAIL("UndoManager::push",
+                           cmd->actionText().toStdString());
+
+    // Only wrap the command while tracing, since the wrapper hides the
+    // command's id() from QUndoStack's merging.
+    if (Util::Tracing::isEnabled())
+        cmd = new TracedCommand(cmd);
+
     beginMacro(cmd->actionText());
 
     auto onUndo = new SignalOnUndo();
@@ -0,0 +1,270 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "autosave.h"
+
+#include <app/documentmanager.h>
+#include <formats/powertab/powertabexporter.h>
+#include <fstream>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QLockFile>
+#include <score/score.h>
+
+static const char *theLockFileName = "lock";
+static const char *theOriginalPathExtension = ".path";
+
+/// Returns a new directory name that is unique to this session.
+static std::filesystem::path getSessionDirectory(
+    const std::filesystem::path &dir)
+{
+    const auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+
+    const std::string name =
+        std::to_string(QCoreApplication::applicationPid()) + "-" +
+        std::to_string(timestamp.count());
+
+    std::filesystem::path path = dir / name;
+    for (int i = 1; std::filesystem::exists(path); ++i)
+        path = dir / (name + "-" + std::to_string(i));
+
+    return path;
+}
+
+Autosave::Autosave(const std::filesystem::path &dir)
+    : myDirectory(dir),
+      mySessionDirectory(getSessionDirectory(dir)),
+      myLastSnapshotTime(0),
+      myThreadPool(1)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(mySessionDirectory, ec);
+    if (ec)
+    {
+        qWarning() << "Could not create autosave directory:"
+                   << QString::fromStdString(ec.message());
+    }
+
+    // Other sessions use the lock to tell whether this session is still
+    // running.
+    myLock = std::make_unique<QLockFile>(QString::fromStdString(
+        (mySessionDirectory / theLockFileName).u8string()));
+    myLock->setStaleLockTime(0);
+    if (!myLock->tryLock())
+        qWarning() << "Could not lock autosave directory";
+}
+
+Autosave::~Autosave()
+{
+    myThreadPool.waitForAll();
+
+    myLock->unlock();
+
+    std::error_code ec;
+    std::filesystem::remove_all(mySessionDirectory, ec);
+}
+
+void Autosave::markModified(const Document &doc)
+{
+    myEntries[&doc].myIsModified = true;
+}
+
+bool Autosave::isModified(const Document &doc) const
+{
+    auto it = myEntries.find(&doc);
+    return it == myEntries.end() || it->second.myIsModified;
+}
+
+void Autosave::save(const Document &doc)
+{
+    Entry &entry = myEntries[&doc];
+    if (entry.myPath.empty())
+    {
+        entry.myPath = mySessionDirectory /
+                       ("document" + std::to_string(++myFileCount) + ".pt2");
+    }
+    entry.myIsModified = false;
+
+    // Only the snapshot is taken on the GUI thread, since the score may be
+    // modified again while it is being written out.
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const Score> snapshot = doc.getScore().clone();
+    myLastSnapshotTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    qDebug() << "Autosave snapshot took" << myLastSnapshotTime.count()
+             << "us";
+
+    std::optional<std::filesystem::path> original_path;
+    if (doc.hasFilename())
+        original_path = doc.getFilename();
+
+    myThreadPool.submit([path = entry.myPath, original_path, snapshot]() {
+        try
+        {
+            write(path, original_path, *snapshot);
+        }
+        catch (const std::exception &e)
+        {
+            qWarning() << "Error autosaving file:" << e.what();
+        }
+    });
+}
+
+void Autosave::remove(const Document &doc)
+{
+    auto it = myEntries.find(&doc);
+    if (it == myEntries.end())
+        return;
+
+    std::filesystem::path path = it->second.myPath;
+    myEntries.erase(it);
+
+    if (path.empty())
+        return;
+
+    // Queue the removal after any pending writes for the file.
+    myThreadPool.submit([path]() {
+        std::filesystem::path original_path = path;
+        original_path += theOriginalPathExtension;
+
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        std::filesystem::remove(original_path, ec);
+    });
+}
+
+std::chrono::microseconds Autosave::getLastSnapshotTime() const
+{
+    return myLastSnapshotTime;
+}
+
+void Autosave::waitForAll()
+{
+    myThreadPool.waitForAll();
+}
+
+void Autosave::write(const std::filesystem::path &path,
+                     const std::optional<std::filesystem::path> &original_path,
+                     const Score &score)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::filesystem::path original_path_file = path;
+    original_path_file += theOriginalPathExtension;
+
+    if (original_path)
+    {
+        std::ofstream file(original_path_file,
+                           std::ios::out | std::ios::binary);
+        file << original_path->u8string();
+    }
+    else
+    {
+        std::error_code ec;
+        std::filesystem::remove(original_path_file, ec);
+    }
+
+    // Write to a temporary file first, so that a crash while writing does not
+    // destroy the previous copy.
+    std::filesystem::path temp_path = path;
+    temp_path += ".tmp";
+
+    PowerTabExporter exporter;
+    exporter.save(temp_path, score);
+    std::filesystem::rename(temp_path, path);
+
+    auto end = std::chrono::steady_clock::now();
+    qDebug() << "Autosaved" << QString::fromStdString(path.u8string()) << "in"
+             << std::chrono::duration_cast<std::chrono::milliseconds>(end -
+                                                                      start)
+                    .count()
+             << "ms";
+}
+
+std::vector<std::filesystem::path> Autosave::findAbandonedSessions() const
+{
+    std::vector<std::filesystem::path> sessions;
+
+    std::error_code ec;
+    for (auto &&entry : std::filesystem::directory_iterator(myDirectory, ec))
+    {
+        const std::filesystem::path &dir = entry.path();
+        if (!entry.is_directory() || dir == mySessionDirectory)
+            continue;
+
+        // If the lock can be acquired, the session is no longer running. The
+        // lock should only be considered stale if its process has exited, not
+        // based on its age.
+        QLockFile lock(
+            QString::fromStdString((dir / theLockFileName).u8string()));
+        lock.setStaleLockTime(0);
+        if (lock.tryLock())
+        {
+            lock.unlock();
+            sessions.push_back(dir);
+        }
+    }
+
+    return sessions;
+}
+
+std::vector<Autosave::RecoverableFile> Autosave::findRecoverableFiles() const
+{
+    std::vector<RecoverableFile> files;
+
+    for (const std::filesystem::path &dir : findAbandonedSessions())
+    {
+        std::error_code ec;
+        for (auto &&entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            const std::filesystem::path &path = entry.path();
+            if (path.extension() != ".pt2")
+                continue;
+
+            RecoverableFile file;
+            file.myAutosavePath = path;
+
+            std::filesystem::path original_path_file = path;
+            original_path_file += theOriginalPathExtension;
+
+            std::ifstream input(original_path_file,
+                                std::ios::in | std::ios::binary);
+            std::string original_path;
+            if (input && std::getline(input, original_path) &&
+                !original_path.empty())
+            {
+                file.myOriginalPath =
+                    std::filesystem::u8path(original_path);
+            }
+
+            files.push_back(file);
+        }
+    }
+
+    return files;
+}
+
+void Autosave::discardRecoverableFiles()
+{
+    for (const std::filesystem::path &dir : findAbandonedSessions())
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+}
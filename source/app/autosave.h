@@ -0,0 +1,111 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef APP_AUTOSAVE_H
+#define APP_AUTOSAVE_H
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <util/threadpool.h>
+#include <vector>
+
+class Document;
+class QLockFile;
+class Score;
+
+/// Periodically writes a backup copy of modified documents, so that they can
+/// be recovered if the application crashes.
+/// A snapshot of the score is taken on the GUI thread, and the snapshot is
+/// then serialized and compressed on a background thread.
+class Autosave
+{
+public:
+    /// A document that was autosaved by a previous session which did not exit
+    /// cleanly.
+    struct RecoverableFile
+    {
+        std::filesystem::path myAutosavePath;
+        /// The file that the document was originally opened from, if any.
+        std::optional<std::filesystem::path> myOriginalPath;
+    };
+
+    /// Each session writes its files to a separate subdirectory of the given
+    /// directory, which is locked while the session is running.
+    explicit Autosave(const std::filesystem::path &dir);
+    /// Waits for any pending writes, and then removes this session's files.
+    ~Autosave();
+
+    Autosave(const Autosave &) = delete;
+    Autosave &operator=(const Autosave &) = delete;
+
+    /// Records that the document has changed since it was last autosaved.
+    void markModified(const Document &doc);
+    /// Returns whether the document has changed since it was last autosaved.
+    bool isModified(const Document &doc) const;
+
+    /// Takes a snapshot of the document's score and writes it out in the
+    /// background.
+    void save(const Document &doc);
+    /// Removes the autosaved copy of the document, e.g. after it is saved or
+    /// closed.
+    void remove(const Document &doc);
+
+    /// Returns the time taken to snapshot the most recently autosaved score.
+    std::chrono::microseconds getLastSnapshotTime() const;
+
+    /// Blocks until all pending writes have finished.
+    void waitForAll();
+
+    /// Returns the files left behind by any previous sessions that crashed.
+    std::vector<RecoverableFile> findRecoverableFiles() const;
+    /// Deletes the files left behind by any previous sessions, once they have
+    /// been recovered or the user has chosen to discard them.
+    void discardRecoverableFiles();
+
+private:
+    struct Entry
+    {
+        std::filesystem::path myPath;
+        bool myIsModified = true;
+    };
+
+    /// Runs on the worker thread.
+    static void write(const std::filesystem::path &path,
+                      const std::optional<std::filesystem::path> &original_path,
+                      const Score &score);
+
+    /// Returns the directories for previous sessions that are no longer
+    /// running.
+    std::vector<std::filesystem::path> findAbandonedSessions() const;
+
+    const std::filesystem::path myDirectory;
+    const std::filesystem::path mySessionDirectory;
+    std::unique_ptr<QLockFile> myLock;
+
+    std::unordered_map<const Document *, Entry> myEntries;
+    int myFileCount = 0;
+    std::chrono::microseconds myLastSnapshotTime;
+
+    /// Use a single worker, so that writes and removals for a document happen
+    /// in the order they were requested.
+    Util::ThreadPool myThreadPool;
+};
+
+#endif
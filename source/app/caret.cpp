@@ -218,11 +218,24 @@ bool Caret::moveToSystem(int system, bool keepStaff)
 
 void Caret::moveToLocation(const ConstScoreLocation &location)
 {
-    myLocation.setSystemIndex(location.getSystemIndex());
-    myLocation.setStaffIndex(location.getStaffIndex());
-    myLocation.setPositionIndex(location.getPositionIndex());
-    myLocation.setSelectionStart(location.getSelectionStart());
-    myLocation.setString(location.getString());
+    // Clamp the location before notifying any subscribers, since the score
+    // may have been edited since the location was recorded.
+    myLocation.setSystemIndex(
+        std::clamp(location.getSystemIndex(), 0, getLastSystemIndex()));
+
+    const int num_staves =
+        static_cast<int>(myLocation.getSystem().getStaves().size());
+    myLocation.setStaffIndex(
+        std::clamp(location.getStaffIndex(), 0, num_staves - 1));
+
+    const int last_position = getLastPosition();
+    myLocation.setPositionIndex(
+        std::clamp(location.getPositionIndex(), 0, last_position));
+    myLocation.setSelectionStart(
+        std::clamp(location.getSelectionStart(), 0, last_position));
+
+    const int num_strings = myLocation.getStaff().getStringCount();
+    myLocation.setString(std::clamp(location.getString(), 0, num_strings - 1));
 
     onLocationChanged();
 }
@@ -84,7 +84,8 @@ public:
     /// previous system if necessary.
     void moveToPrevBar();
 
-    /// Moves to the specified location.
+    /// Moves to the specified location, or the nearest valid location if it
+    /// is no longer in the score.
     void moveToLocation(const ConstScoreLocation &location);
 
     /// Ensures that the caret is still at a valid position.
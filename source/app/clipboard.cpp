@@ -24,13 +24,18 @@
 #include <QMessageBox>
 #include <QMimeData>
 #include <QString>
+#include <score/binaryserialization.h>
 #include <score/position.h>
 #include <score/scorelocation.h>
 #include <score/serialization.h>
 #include <score/staff.h>
 #include <sstream>
 
+/// The JSON format, which is also understood by older versions.
 static const QString PTB_MIME_TYPE = "application/ptb";
+/// The preferred format, which is much faster to copy and paste for large
+/// selections.
+static const QString PTB_BINARY_MIME_TYPE = "application/ptb-binary";
 
 class ClipboardSelection
 {
@@ -79,6 +84,53 @@ private:
     std::vector<IrregularGrouping> myGroups;
 };
 
+/// Holds the selection in the binary format, and only converts it to the JSON
+/// format if that is requested (e.g. by an older version of the application).
+class ClipboardMimeData : public QMimeData
+{
+public:
+    explicit ClipboardMimeData(std::string data) : myData(std::move(data))
+    {
+    }
+
+    QStringList formats() const override
+    {
+        return { PTB_BINARY_MIME_TYPE, PTB_MIME_TYPE };
+    }
+
+    bool hasFormat(const QString &mime_type) const override
+    {
+        return mime_type == PTB_BINARY_MIME_TYPE || mime_type == PTB_MIME_TYPE;
+    }
+
+protected:
+    QVariant retrieveData(const QString &mime_type,
+                          QVariant::Type type) const override
+    {
+        if (mime_type == PTB_BINARY_MIME_TYPE)
+            return toByteArray(myData);
+        else if (mime_type == PTB_MIME_TYPE)
+        {
+            ClipboardSelection selection;
+            ScoreUtils::loadBinary(myData, selection);
+
+            std::ostringstream ss;
+            ScoreUtils::save(ss, "clipboard_selection", selection);
+            return toByteArray(ss.str());
+        }
+
+        return QMimeData::retrieveData(mime_type, type);
+    }
+
+private:
+    static QByteArray toByteArray(const std::string &data)
+    {
+        return QByteArray(data.c_str(), static_cast<int>(data.length()));
+    }
+
+    std::string myData;
+};
+
 void Clipboard::copySelection(const ScoreLocation &location)
 {
     const auto selectedPositions = location.getSelectedPositions();
@@ -91,16 +143,8 @@ void Clipboard::copySelection(const ScoreLocation &location)
     ClipboardSelection selection(numStrings, selectedPositions,
                                  location.getSelectedIrregularGroupings());
 
-    // Serialize the notes to a string.
-    std::ostringstream ss;
-    ScoreUtils::save(ss, "clipboard_selection", selection);
-    const std::string data = ss.str();
-
-    // Copy the data to the clipboard.
-    auto mimeData = new QMimeData();
-    mimeData->setData(
-        PTB_MIME_TYPE,
-        QByteArray(data.c_str(), static_cast<int>(data.length())));
+    // Serialize the notes and copy them to the clipboard.
+    auto mimeData = new ClipboardMimeData(ScoreUtils::saveBinary(selection));
 
     QClipboard *clipboard = QApplication::clipboard();
     clipboard->setMimeData(mimeData);
@@ -111,15 +155,39 @@ void Clipboard::paste(QWidget *parent, UndoManager &undoManager,
 {
     const int currentStaffSize = location.getStaff().getStringCount();
 
-    // Load data from the clipboard and deserialize.
-    const QByteArray rawData =
-        QApplication::clipboard()->mimeData()->data(PTB_MIME_TYPE);
-    Q_ASSERT(!rawData.isEmpty());
+    // Load data from the clipboard and deserialize, preferring the binary
+    // format.
+    const QMimeData *mimeData = QApplication::clipboard()->mimeData();
+    ClipboardSelection selection;
+    bool loaded = false;
 
-    std::istringstream inputData(std::string(rawData.data(), rawData.length()));
+    const QByteArray binaryData = mimeData->data(PTB_BINARY_MIME_TYPE);
+    if (!binaryData.isEmpty())
+    {
+        try
+        {
+            ScoreUtils::loadBinary(
+                std::string_view(binaryData.constData(), binaryData.length()),
+                selection);
+            loaded = true;
+        }
+        catch (const std::exception &)
+        {
+            // e.g. the data was copied from a newer version, so fall back to
+            // the JSON format.
+            selection = ClipboardSelection();
+        }
+    }
 
-    ClipboardSelection selection;
-    ScoreUtils::load(inputData, "clipboard_selection", selection);
+    if (!loaded)
+    {
+        const QByteArray rawData = mimeData->data(PTB_MIME_TYPE);
+        Q_ASSERT(!rawData.isEmpty());
+
+        std::istringstream inputData(
+            std::string(rawData.data(), rawData.length()));
+        ScoreUtils::load(inputData, "clipboard_selection", selection);
+    }
 
     // For safety, prevent pasting into a tuning with a different number of
     // strings.
@@ -139,8 +207,7 @@ void Clipboard::paste(QWidget *parent, UndoManager &undoManager,
 
 bool Clipboard::hasData()
 {
-    return !QApplication::clipboard()
-                ->mimeData()
-                ->data(PTB_MIME_TYPE)
-                .isEmpty();
+    const QMimeData *mimeData = QApplication::clipboard()->mimeData();
+    return mimeData->hasFormat(PTB_BINARY_MIME_TYPE) ||
+           mimeData->hasFormat(PTB_MIME_TYPE);
 }
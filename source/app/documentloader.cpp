@@ -0,0 +1,171 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "documentloader.h"
+
+#include <algorithm>
+#include <app/documentmanager.h>
+#include <chrono>
+#include <formats/fileformatmanager.h>
+#include <QDebug>
+#include <score/score.h>
+#include <util/tracing.h>
+
+DocumentLoader::Job::Job(const std::filesystem::path &path,
+                         const FileFormat &format)
+    : myPath(path), myFormat(format), myCancelled(false)
+{
+}
+
+DocumentLoader::DocumentLoader(FileFormatManager &format_manager,
+                               LoadedCallback on_loaded,
+                               ErrorCallback on_error,
+                               ProgressCallback on_progress, QObject *parent)
+    : QObject(parent),
+      myFormatManager(format_manager),
+      myOnLoaded(std::move(on_loaded)),
+      myOnError(std::move(on_error)),
+      myOnProgress(std::move(on_progress))
+{
+}
+
+DocumentLoader::~DocumentLoader()
+{
+    cancelAll();
+    myThreadPool.waitForAll();
+}
+
+void DocumentLoader::load(const std::filesystem::path &path,
+                          const FileFormat &format)
+{
+    auto job = std::make_shared<Job>(path, format);
+    myPendingJobs.push_back(job);
+
+    myThreadPool.submit([this, job]() {
+        run(*job);
+
+        // Hand the result back to the GUI thread. If the loader is destroyed
+        // before the event is processed, the event is discarded.
+        QMetaObject::invokeMethod(this, [this, job]() { finish(job); },
+                                  Qt::QueuedConnection);
+    });
+
+    myOnProgress(myFinishedCount,
+                 myFinishedCount + static_cast<int>(myPendingJobs.size()));
+}
+
+bool DocumentLoader::isLoading(const std::filesystem::path &path) const
+{
+    for (auto &&job : myPendingJobs)
+    {
+        if (job->myPath == path && !job->myCancelled)
+            return true;
+    }
+
+    return false;
+}
+
+bool DocumentLoader::isBusy() const
+{
+    return !myPendingJobs.empty();
+}
+
+void DocumentLoader::cancelAll()
+{
+    for (auto &&job : myPendingJobs)
+        job->myCancelled = true;
+}
+
+void DocumentLoader::run(Job &job)
+{
+    if (job.myCancelled)
+        return;
+
+    Util::Tracing::setThreadName("DocumentLoader");
+    PTE_TRACE_SCOPE("DocumentLoader::run");
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    try
+    {
+        auto doc = std::make_unique<Document>();
+        myFormatManager.importFile(doc->getScore(), job.myPath, job.myFormat);
+        doc->setFilename(job.myPath);
+
+        auto end = std::chrono::high_resolution_clock::now();
+        qDebug() << "File loaded in"
+                 << std::chrono::duration_cast<std::chrono::milliseconds>(
+                        end - start).count()
+                 << "ms";
+
+        // Compute the layout for each staff, which is the most expensive part
+        // of rendering the score and does not need to run on the GUI thread.
+        const Score &score = doc->getScore();
+        std::vector<SystemLayout> layouts;
+        layouts.reserve(score.getSystems().size());
+
+        for (int i = 0, n = static_cast<int>(score.getSystems().size()); i < n;
+             ++i)
+        {
+            if (job.myCancelled)
+                return;
+
+            const System &system = score.getSystems()[i];
+
+            SystemLayout system_layout;
+            for (int j = 0, m = static_cast<int>(system.getStaves().size());
+                 j < m; ++j)
+            {
+                system_layout.push_back(std::make_shared<LayoutInfo>(
+                    ConstScoreLocation(score, i, j)));
+            }
+
+            layouts.push_back(std::move(system_layout));
+        }
+
+        job.myResult.myDocument = std::move(doc);
+        job.myResult.myLayouts = std::move(layouts);
+    }
+    catch (const std::exception &e)
+    {
+        job.myError = e.what();
+    }
+}
+
+void DocumentLoader::finish(const std::shared_ptr<Job> &job)
+{
+    myPendingJobs.erase(
+        std::remove(myPendingJobs.begin(), myPendingJobs.end(), job),
+        myPendingJobs.end());
+    ++myFinishedCount;
+
+    if (!job->myCancelled)
+    {
+        if (job->myResult.myDocument)
+            myOnLoaded(job->myResult);
+        else
+            myOnError(job->myPath, job->myError);
+    }
+
+    const int total =
+        myFinishedCount + static_cast<int>(myPendingJobs.size());
+    myOnProgress(myFinishedCount, total);
+
+    // Reset the progress once everything has finished.
+    if (myPendingJobs.empty())
+        myFinishedCount = 0;
+}
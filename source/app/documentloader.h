@@ -0,0 +1,105 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef APP_DOCUMENTLOADER_H
+#define APP_DOCUMENTLOADER_H
+
+#include <atomic>
+#include <filesystem>
+#include <formats/fileformat.h>
+#include <functional>
+#include <memory>
+#include <painters/layoutinfo.h>
+#include <QObject>
+#include <util/threadpool.h>
+#include <vector>
+
+class Document;
+class FileFormatManager;
+
+/// Imports files and computes their initial layout on a pool of background
+/// threads, so that opening large files does not block the UI. Several files
+/// can be loaded concurrently, and the results are delivered on the GUI thread
+/// as each file finishes.
+class DocumentLoader : public QObject
+{
+public:
+    /// A document that has finished loading, along with the precomputed layout
+    /// of each staff in the score.
+    struct LoadedDocument
+    {
+        std::unique_ptr<Document> myDocument;
+        std::vector<SystemLayout> myLayouts;
+    };
+
+    typedef std::function<void(LoadedDocument &)> LoadedCallback;
+    typedef std::function<void(const std::filesystem::path &,
+                               const std::string &)>
+        ErrorCallback;
+    /// Invoked with the number of finished files and the total number of files
+    /// since the loader was last idle.
+    typedef std::function<void(int, int)> ProgressCallback;
+
+    DocumentLoader(FileFormatManager &format_manager,
+                   LoadedCallback on_loaded, ErrorCallback on_error,
+                   ProgressCallback on_progress, QObject *parent = nullptr);
+    /// Cancels any pending files and waits for the worker threads to exit.
+    ~DocumentLoader();
+
+    /// Queues the file to be loaded in the background.
+    void load(const std::filesystem::path &path, const FileFormat &format);
+
+    /// Returns whether the file is currently being loaded.
+    bool isLoading(const std::filesystem::path &path) const;
+
+    /// Returns whether any files are currently being loaded.
+    bool isBusy() const;
+
+    /// Cancels all pending files. Files that are in the middle of being
+    /// imported will be discarded once the importer returns.
+    void cancelAll();
+
+private:
+    struct Job
+    {
+        Job(const std::filesystem::path &path, const FileFormat &format);
+
+        const std::filesystem::path myPath;
+        const FileFormat myFormat;
+        std::atomic<bool> myCancelled;
+
+        LoadedDocument myResult;
+        std::string myError;
+    };
+
+    /// Runs on a worker thread.
+    void run(Job &job);
+    /// Runs on the GUI thread after a job has finished.
+    void finish(const std::shared_ptr<Job> &job);
+
+    FileFormatManager &myFormatManager;
+    LoadedCallback myOnLoaded;
+    ErrorCallback myOnError;
+    ProgressCallback myOnProgress;
+
+    std::vector<std::shared_ptr<Job>> myPendingJobs;
+    int myFinishedCount = 0;
+
+    Util::ThreadPool myThreadPool;
+};
+
+#endif
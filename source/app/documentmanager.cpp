@@ -26,7 +26,12 @@ DocumentManager::DocumentManager()
 
 Document &DocumentManager::addDocument()
 {
-    myDocumentList.emplace_back(new Document());
+    return addDocument(std::make_unique<Document>());
+}
+
+Document &DocumentManager::addDocument(std::unique_ptr<Document> doc)
+{
+    myDocumentList.push_back(std::move(doc));
     myCurrentIndex = static_cast<int>(myDocumentList.size()) - 1;
     return *myDocumentList.back();
 }
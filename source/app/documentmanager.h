@@ -69,6 +69,9 @@ public:
 
     /// Add a new, blank document.
     Document &addDocument();
+    /// Add a document that was created elsewhere (e.g. loaded in the
+    /// background).
+    Document &addDocument(std::unique_ptr<Document> doc);
     /// Add a new document, and initialize it with a staff, player, etc.
     Document &addDefaultDocument(const SettingsManager &settings_manager);
 
@@ -0,0 +1,73 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memoryusage.h"
+
+#include <QGraphicsScene>
+#include <QUndoStack>
+#include <score/score.h>
+
+/// Rough size of a graphics item, including Qt's private data for the item
+/// and the pen, brush, font, or path that it draws with.
+static constexpr size_t SCENE_ITEM_SIZE = 400;
+
+/// Rough size of an undo command. Most commands store a copy of a few
+/// positions or notes, although some store an entire staff or system.
+static constexpr size_t UNDO_COMMAND_SIZE = 1024;
+
+size_t DocumentMemoryUsage::getTotalBytes() const
+{
+    return myScoreBytes + mySceneBytes + myUndoBytes;
+}
+
+size_t MemoryUsage::estimateScore(const Score &score)
+{
+    size_t bytes = sizeof(Score);
+    bytes += score.getPlayers().size() * sizeof(Player);
+    bytes += score.getInstruments().size() * sizeof(Instrument);
+
+    for (const System &system : score.getSystems())
+    {
+        bytes += sizeof(System);
+        bytes += system.getBarlines().size() * sizeof(Barline);
+
+        for (const Staff &staff : system.getStaves())
+        {
+            bytes += sizeof(Staff);
+
+            for (const Voice &voice : staff.getVoices())
+            {
+                bytes += voice.getPositions().size() * sizeof(Position);
+
+                for (const Position &pos : voice.getPositions())
+                    bytes += pos.getNotes().size() * sizeof(Note);
+            }
+        }
+    }
+
+    return bytes;
+}
+
+size_t MemoryUsage::estimateScene(const QGraphicsScene &scene)
+{
+    return scene.items().size() * SCENE_ITEM_SIZE;
+}
+
+size_t MemoryUsage::estimateUndoStack(const QUndoStack &stack)
+{
+    return stack.count() * UNDO_COMMAND_SIZE;
+}
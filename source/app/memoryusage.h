@@ -0,0 +1,51 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef APP_MEMORYUSAGE_H
+#define APP_MEMORYUSAGE_H
+
+#include <cstddef>
+
+class QGraphicsScene;
+class QUndoStack;
+class Score;
+
+/// Approximate breakdown of the memory used by an open document. This is
+/// used to decide when to release the rendered scenes of inactive tabs, so the
+/// estimates only need to be accurate enough to compare documents.
+struct DocumentMemoryUsage
+{
+    size_t myScoreBytes = 0;
+    size_t mySceneBytes = 0;
+    size_t myUndoBytes = 0;
+
+    size_t getTotalBytes() const;
+};
+
+namespace MemoryUsage
+{
+/// Estimates the memory used by the score's systems, staves, notes, etc.
+size_t estimateScore(const Score &score);
+
+/// Estimates the memory used by the items in a rendered scene.
+size_t estimateScene(const QGraphicsScene &scene);
+
+/// Estimates the memory held by the commands in an undo stack.
+size_t estimateUndoStack(const QUndoStack &stack);
+} // namespace MemoryUsage
+
+#endif
@@ -73,10 +73,13 @@
 #include <actions/volumeswell.h>
 
 #include <app/appinfo.h>
+#include <app/autosave.h>
 #include <app/caret.h>
 #include <app/clipboard.h>
 #include <app/command.h>
+#include <app/documentloader.h>
 #include <app/documentmanager.h>
+#include <app/memoryusage.h>
 #include <app/paths.h>
 #include <app/recentfiles.h>
 #include <app/scorearea.h>
@@ -87,8 +90,10 @@
 #include <audio/midiplayer.h>
 #include <audio/settings.h>
 
+#include <algorithm>
 #include <boost/range/algorithm/transform.hpp>
 #include <chrono>
+#include <limits>
 
 #include <dialogs/alterationofpacedialog.h>
 #include <dialogs/alternateendingdialog.h>
@@ -124,12 +129,14 @@
 
 #include <formats/fileformatmanager.h>
 
+#include <painters/pageexporter.h>
+
 #include <QCoreApplication>
 #include <QDebug>
 #include <QDesktopServices>
 #include <QDockWidget>
 #include <QFileDialog>
-#include <QFontDatabase>
+#include <QGuiApplication>
 #include <QKeyEvent>
 #include <QMenuBar>
 #include <QMessageBox>
@@ -137,16 +144,21 @@
 #include <QPrinter>
 #include <QPrintDialog>
 #include <QPrintPreviewDialog>
+#include <QProgressDialog>
+#include <QScreen>
 #include <QScrollArea>
 #include <QTabBar>
+#include <QTimer>
 #include <QUrl>
 #include <QVBoxLayout>
+#include <QWindow>
 
 #include <score/dynamic.h>
 #include <score/utils.h>
 #include <score/voiceutils.h>
 
 #include <util/tostring.h>
+#include <util/tracing.h>
 #include <util/version.h>
 
 #include <widgets/instruments/instrumentpanel.h>
@@ -178,11 +190,8 @@ PowerTabEditor::PowerTabEditor()
 
     setAcceptDrops(true);
 
-    // Load the music notation font.
-    QFontDatabase::addApplicationFont(":fonts/emmentaler-13.otf");
-    // Load the tab note font.
-    QFontDatabase::addApplicationFont(":fonts/LiberationSans-Regular.ttf");
-    QFontDatabase::addApplicationFont(":fonts/LiberationSerif-Regular.ttf");
+    // Allow exporting the printed score.
+    PageExporter::registerFormats(*myFileFormatManager);
 
     connect(myUndoManager.get(), &UndoManager::redrawNeeded, this,
             &PowerTabEditor::redrawSystem);
@@ -195,6 +204,8 @@ PowerTabEditor::PowerTabEditor()
     mySettingsManager->load(Paths::getConfigDir());
 
     createMidiThread();
+    createDocumentLoader();
+    createAutosave();
 
     createMixer();
     createInstrumentPanel();
@@ -234,6 +245,64 @@ void PowerTabEditor::openFiles(const QStringList &files)
         openFile(filename);
 }
 
+void PowerTabEditor::recoverAutosavedFiles()
+{
+    std::vector<Autosave::RecoverableFile> files =
+        myAutosave->findRecoverableFiles();
+    if (files.empty())
+    {
+        myAutosave->discardRecoverableFiles();
+        return;
+    }
+
+    QMessageBox msg(this);
+    msg.setWindowTitle(tr("Recover Documents"));
+    msg.setText(tr("Power Tab Editor did not exit cleanly, and %n unsaved "
+                   "document(s) can be recovered.",
+                   nullptr, static_cast<int>(files.size())));
+    msg.setInformativeText(tr("Do you want to recover them?"));
+    msg.setStandardButtons(QMessageBox::Yes | QMessageBox::Discard);
+    msg.setDefaultButton(QMessageBox::Yes);
+
+    if (msg.exec() == QMessageBox::Yes)
+    {
+        const FileFormat format = *myFileFormatManager->findFormat("pt2");
+
+        for (const Autosave::RecoverableFile &file : files)
+        {
+            Document &doc = myDocumentManager->addDocument();
+
+            try
+            {
+                myFileFormatManager->importFile(doc.getScore(),
+                                                file.myAutosavePath, format);
+            }
+            catch (const std::exception &e)
+            {
+                myDocumentManager->removeDocument(
+                    myDocumentManager->getCurrentDocumentIndex());
+
+                QMessageBox::warning(
+                    this, tr("Error Recovering File"),
+                    tr("Error recovering file: %1").arg(QString(e.what())));
+                continue;
+            }
+
+            if (file.myOriginalPath)
+                doc.setFilename(*file.myOriginalPath);
+
+            setupNewTab();
+
+            // The recovered document has not been saved, so flag it as
+            // modified. It will then be autosaved again by this session.
+            myUndoManager->stacks().back()->resetClean();
+            myAutosave->markModified(doc);
+        }
+    }
+
+    myAutosave->discardRecoverableFiles();
+}
+
 void PowerTabEditor::createNewDocument()
 {
     myDocumentManager->addDefaultDocument(*mySettingsManager);
@@ -263,7 +332,11 @@ void PowerTabEditor::openFile(QString filename)
         return;
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    if (myDocumentLoader->isLoading(path))
+    {
+        qDebug() << "File: " << filename << " is already being opened";
+        return;
+    }
 
     qDebug() << "Opening file: " << filename;
 
@@ -278,29 +351,9 @@ void PowerTabEditor::openFile(QString filename)
         return;
     }
 
-    try
-    {
-        Document &doc = myDocumentManager->addDocument();
-        myFileFormatManager->importFile(doc.getScore(), path, *format);
-        auto end = std::chrono::high_resolution_clock::now();
-        qDebug() << "File loaded in"
-                 << std::chrono::duration_cast<std::chrono::milliseconds>(end - start) .count()
-                 << "ms";
-
-        doc.setFilename(path);
-        setPreviousDirectory(filename);
-        myRecentFiles->add(filename);
-        setupNewTab();
-    }
-    catch (const std::exception &e)
-    {
-        myDocumentManager->removeDocument(
-            myDocumentManager->getCurrentDocumentIndex());
-
-        QMessageBox::warning(
-            this, tr("Error Opening File"),
-            tr("Error opening file: %1").arg(QString(e.what())));
-    }
+    // The file is imported in the background, and a new tab is set up once
+    // the document is ready.
+    myDocumentLoader->load(path, *format);
 }
 
 void PowerTabEditor::switchTab(int index)
@@ -310,10 +363,19 @@ void PowerTabEditor::switchTab(int index)
     if (index != -1)
     {
         const Document &doc = myDocumentManager->getCurrentDocument();
+
+        // The score may have been released while the tab was inactive.
+        ScoreArea *scorearea = getScoreArea();
+        if (!scorearea->hasScene())
+            scorearea->renderDocument(doc);
+        scorearea->markActivated();
+
         myMixer->reset(doc.getScore());
         myInstrumentPanel->reset(doc.getScore());
         myPlaybackWidget->reset(doc);
         updateLocationLabel();
+
+        releaseInactiveScenes();
     }
     else
     {
@@ -326,6 +388,73 @@ void PowerTabEditor::switchTab(int index)
     updateWindowTitle();
 }
 
+void PowerTabEditor::releaseInactiveScenes()
+{
+    int budget_mb;
+    {
+        auto settings = mySettingsManager->getReadHandle();
+        budget_mb = settings->get(Settings::SceneMemoryBudget);
+    }
+
+    const int num_docs =
+        static_cast<int>(myDocumentManager->getDocumentListSize());
+    const int current_index = myDocumentManager->getCurrentDocumentIndex();
+
+    auto get_score_area = [&](int i) {
+        return dynamic_cast<ScoreArea *>(myTabWidget->widget(i));
+    };
+
+    std::vector<DocumentMemoryUsage> usage(num_docs);
+    size_t total_bytes = 0;
+    for (int i = 0; i < num_docs; ++i)
+    {
+        const Document &doc = myDocumentManager->getDocument(i);
+        usage[i].myScoreBytes = MemoryUsage::estimateScore(doc.getScore());
+        usage[i].mySceneBytes = get_score_area(i)->estimateSceneMemory();
+        usage[i].myUndoBytes =
+            MemoryUsage::estimateUndoStack(*myUndoManager->stacks()[i]);
+        total_bytes += usage[i].getTotalBytes();
+
+        qDebug() << "Memory usage for" << myTabWidget->tabToolTip(i) << "-"
+                 << "score:" << usage[i].myScoreBytes / 1024 << "KB,"
+                 << "scene:" << usage[i].mySceneBytes / 1024 << "KB,"
+                 << "undo:" << usage[i].myUndoBytes / 1024 << "KB";
+    }
+
+    if (budget_mb <= 0)
+        return;
+
+    const size_t budget_bytes = static_cast<size_t>(budget_mb) * 1024 * 1024;
+    if (total_bytes <= budget_bytes)
+        return;
+
+    // Only the rendered scores can be released, since the score and undo
+    // history must be kept. Release the least recently used tabs first, but
+    // never the current tab.
+    std::vector<int> candidates;
+    for (int i = 0; i < num_docs; ++i)
+    {
+        if (i != current_index && get_score_area(i)->hasScene())
+            candidates.push_back(i);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [&](int a, int b) {
+        return get_score_area(a)->getLastActivated() <
+               get_score_area(b)->getLastActivated();
+    });
+
+    for (int i : candidates)
+    {
+        if (total_bytes <= budget_bytes)
+            break;
+
+        qDebug() << "Releasing rendered score for"
+                 << myTabWidget->tabToolTip(i);
+        get_score_area(i)->releaseScene();
+        total_bytes -= usage[i].mySceneBytes;
+    }
+}
+
 bool PowerTabEditor::closeTab(int index)
 {
     // Prompt to save modified documents.
@@ -352,6 +481,7 @@ bool PowerTabEditor::closeTab(int index)
     if (myDocumentManager->getDocument(index).getCaret().isInPlaybackMode())
         startStopPlayback();
 
+    myAutosave->remove(myDocumentManager->getDocument(index));
     myUndoManager->removeStack(index);
     myDocumentManager->removeDocument(index);
     delete myTabWidget->widget(index);
@@ -431,6 +561,7 @@ bool PowerTabEditor::saveFile(int doc_index, QString path)
 
         // Mark the file as being in an unmodified state.
         myUndoManager->stacks()[doc_index]->setClean();
+        myAutosave->remove(doc);
     }
 
     return true;
@@ -587,6 +718,125 @@ void PowerTabEditor::editFileInformation()
     }
 }
 
+void PowerTabEditor::createDocumentLoader()
+{
+    auto on_loaded = [this](DocumentLoader::LoadedDocument &loaded) {
+        const QString filename =
+            Paths::toQString(loaded.myDocument->getFilename());
+
+        // The new document becomes the active tab, which can't be changed
+        // during playback.
+        if (myIsPlaying)
+            startStopPlayback();
+
+        myDocumentManager->addDocument(std::move(loaded.myDocument));
+        setPreviousDirectory(filename);
+        myRecentFiles->add(filename);
+        setupNewTab(loaded.myLayouts);
+    };
+
+    auto on_error = [this](const std::filesystem::path &path,
+                           const std::string &error) {
+        QMessageBox::warning(this, tr("Error Opening File"),
+                             tr("Error opening file %1: %2")
+                                 .arg(Paths::toQString(path),
+                                      QString::fromStdString(error)));
+    };
+
+    myDocumentLoader = std::make_unique<DocumentLoader>(
+        *myFileFormatManager, on_loaded, on_error,
+        [this](int finished, int total) {
+            updateLoadingProgress(finished, total);
+        });
+}
+
+void PowerTabEditor::updateLoadingProgress(int finished, int total)
+{
+    if (finished == total)
+    {
+        if (myLoadingProgress)
+            myLoadingProgress->reset();
+        return;
+    }
+
+    if (!myLoadingProgress)
+    {
+        // The dialog is not modal, so that files which have already been
+        // opened can be viewed while the remaining files load.
+        myLoadingProgress = new QProgressDialog(this);
+        myLoadingProgress->setWindowTitle(tr("Opening Files"));
+        myLoadingProgress->setWindowModality(Qt::NonModal);
+        myLoadingProgress->setMinimumDuration(500);
+        myLoadingProgress->setAutoReset(false);
+        myLoadingProgress->setAutoClose(true);
+
+        connect(myLoadingProgress, &QProgressDialog::canceled, this,
+                [this]() { myDocumentLoader->cancelAll(); });
+    }
+    else if (myLoadingProgress->wasCanceled())
+    {
+        // Wait for the cancelled files to finish before showing the dialog
+        // again.
+        return;
+    }
+
+    myLoadingProgress->setLabelText(
+        tr("Opening file %1 of %2 ...").arg(finished + 1).arg(total));
+    // Use a busy indicator for a single file, since the importers do not
+    // report their progress.
+    myLoadingProgress->setRange(0, total == 1 ? 0 : total);
+    myLoadingProgress->setValue(finished);
+}
+
+void PowerTabEditor::createAutosave()
+{
+    myAutosave = std::make_unique<Autosave>(Paths::getUserDataDir() /
+                                            "autosave");
+
+    // Any change to the active document's undo stack means that the document
+    // needs to be autosaved again.
+    connect(myUndoManager.get(), &UndoManager::indexChanged, this, [this]() {
+        if (myDocumentManager->hasOpenDocuments())
+            myAutosave->markModified(myDocumentManager->getCurrentDocument());
+    });
+
+    myAutosaveTimer = new QTimer(this);
+    connect(myAutosaveTimer, &QTimer::timeout, this,
+            &PowerTabEditor::autosaveDocuments);
+
+    auto update_interval = [&]() {
+        auto settings = mySettingsManager->getReadHandle();
+        const int interval = settings->get(Settings::AutosaveInterval);
+
+        if (interval > 0)
+            myAutosaveTimer->start(interval * 1000);
+        else
+            myAutosaveTimer->stop();
+    };
+
+    update_interval();
+    mySettingsManager->subscribeToChanges(update_interval);
+}
+
+void PowerTabEditor::autosaveDocuments()
+{
+    const QList<QUndoStack *> stacks = myUndoManager->stacks();
+    const int num_documents =
+        static_cast<int>(myDocumentManager->getDocumentListSize());
+
+    for (int i = 0; i < num_documents; ++i)
+    {
+        const Document &doc = myDocumentManager->getDocument(i);
+
+        // If the document was undone back to its saved state, the autosaved
+        // copy is no longer needed.
+        if (stacks[i]->isClean())
+            myAutosave->remove(doc);
+        else if (myAutosave->isModified(doc))
+            myAutosave->save(doc);
+    }
+}
+
 void
 PowerTabEditor::createMidiThread()
 {
@@ -602,12 +852,32 @@ PowerTabEditor::createMidiThread()
             { QMessageBox::critical(this, tr("Midi Error"), msg); });
 
     connect(myMidiPlayer, &MidiPlayer::playbackSystemChanged, this,
-            &PowerTabEditor::moveCaretToSystem);
+            [this](int system) {
+                queuePlaybackLocation(SystemLocation(system, 0));
+            });
     connect(myMidiPlayer, &MidiPlayer::playbackPositionChanged, this,
-            &PowerTabEditor::moveCaretToPosition);
+            [this](int position) {
+                const int system = myPendingPlaybackLocation
+                                       ? myPendingPlaybackLocation->getSystem()
+                                       : getLocation().getSystemIndex();
+                queuePlaybackLocation(SystemLocation(system, position));
+            });
+
+    // Position changes can arrive for every note, which can be far more
+    // frequent than the display can be refreshed.
+    myPlaybackCaretTimer = new QTimer(this);
+    connect(myPlaybackCaretTimer, &QTimer::timeout, this,
+            &PowerTabEditor::updatePlaybackCaret);
     connect(myMidiPlayer, &MidiPlayer::playbackFinished, this,
             [this]() { startStopPlayback(); });
 
+    // The score can be edited during playback, so send a new snapshot to the
+    // MIDI player after each change.
+    connect(myUndoManager.get(), &UndoManager::indexChanged, this, [this]() {
+        if (myIsPlaying)
+            myMidiPlayer->updateScore(getLocation().getScore());
+    });
+
     // Start the thread and setup the MIDI device in the background.
     myMidiThread->start();
     QMetaObject::invokeMethod(myMidiPlayer, &MidiPlayer::init,
@@ -630,9 +900,33 @@ void PowerTabEditor::startStopPlayback(bool from_measure_start)
             moveCaretToNextBar();
         }
 
+        myPlaybackStartLocation.emplace(getLocation());
+
+        {
+            auto settings = mySettingsManager->getReadHandle();
+            myThrottlePlaybackCaret =
+                settings->get(Settings::ThrottlePlaybackCaret);
+        }
+
+        myPendingPlaybackLocation.reset();
+        myPlaybackCaretTime = {};
+        myPlaybackCaretUpdates = 0;
+        myPlaybackStartTime = std::chrono::steady_clock::now();
+
+        if (myThrottlePlaybackCaret)
+        {
+            QScreen *screen = windowHandle() ? windowHandle()->screen()
+                                             : QGuiApplication::primaryScreen();
+            const qreal refresh_rate = screen ? screen->refreshRate() : 60;
+            myPlaybackCaretTimer->start(
+                std::max(1, qRound(1000 / std::max(refresh_rate, 1.0))));
+        }
+
         getCaret().setIsInPlaybackMode(true);
         myPlaybackWidget->setPlaybackMode(true);
-        enableEditing(false);
+        // The score can still be edited during playback, since the MIDI player
+        // works from a snapshot of the score.
+        enableTabSwitching(false);
 
         connect(
             myPlaybackWidget, &PlaybackWidget::playbackSpeedChanged,
@@ -640,29 +934,84 @@ void PowerTabEditor::startStopPlayback(bool from_measure_start)
             Qt::ConnectionType(Qt::UniqueConnection | Qt::DirectConnection));
 
         // Notify the MIDI thread to start playing.
-        QMetaObject::invokeMethod(
-            myMidiPlayer,
-            [&]()
-            {
-                myMidiPlayer->playScore(getLocation(),
-                                        myPlaybackWidget->getPlaybackSpeed());
-            },
-            Qt::QueuedConnection);
+        if (myPlaybackLoopEnd)
+        {
+            myMidiPlayer->playLoop(getLocation(), *myPlaybackLoopEnd,
+                                   myPlaybackWidget->getPlaybackSpeed());
+        }
+        else
+        {
+            myMidiPlayer->playScore(getLocation(),
+                                    myPlaybackWidget->getPlaybackSpeed());
+        }
     }
     else
     {
         // Ensure playback has finished.
         myMidiPlayer->stopPlayback();
 
+        myPlaybackCaretTimer->stop();
+        myPendingPlaybackLocation.reset();
+        myPlaybackLoopEnd.reset();
+
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - myPlaybackStartTime;
+        if (elapsed.count() > 0)
+        {
+            const std::chrono::duration<double, std::milli> caret_time =
+                myPlaybackCaretTime;
+            qDebug() << "Playback caret:" << myPlaybackCaretUpdates
+                     << "updates," << caret_time.count() / elapsed.count()
+                     << "ms of GUI thread time per second of playback"
+                     << (myThrottlePlaybackCaret ? "(throttled)" : "");
+        }
+
         myPlayPauseCommand->setText(tr("Play"));
         getCaret().setIsInPlaybackMode(false);
         myPlaybackWidget->setPlaybackMode(false);
 
-        enableEditing(true);
+        enableTabSwitching(true);
         updateCommands();
     }
 }
 
+void PowerTabEditor::startLoopPlayback()
+{
+    if (myIsPlaying)
+    {
+        startStopPlayback();
+        return;
+    }
+
+    const ScoreLocation &location = getLocation();
+    int start = 0;
+    int end = 0;
+    if (location.hasSelection())
+    {
+        start = std::min(location.getSelectionStart(),
+                         location.getPositionIndex());
+        end = std::max(location.getSelectionStart(),
+                       location.getPositionIndex());
+    }
+    else
+    {
+        // Loop the current bar.
+        const System &system = location.getSystem();
+        const Barline *prev_bar =
+            system.getPreviousBarline(location.getPositionIndex() + 1);
+        const Barline *next_bar =
+            system.getNextBarline(location.getPositionIndex());
+
+        start = prev_bar ? prev_bar->getPosition() : 0;
+        end = next_bar ? next_bar->getPosition() - 1
+                       : std::numeric_limits<int>::max();
+    }
+
+    myPlaybackLoopEnd.emplace(location.getSystemIndex(), end);
+    getCaret().moveToPosition(start);
+    startStopPlayback();
+}
+
 void PowerTabEditor::redrawSystem(int index)
 {
     getCaret().moveToValidPosition();
@@ -713,11 +1062,6 @@ void PowerTabEditor::moveCaretToEnd()
     getCaret().moveToEndPosition();
 }
 
-void PowerTabEditor::moveCaretToPosition(int position)
-{
-    getCaret().moveToPosition(position);
-}
-
 void PowerTabEditor::moveCaretToFirstSection()
 {
     getCaret().moveToFirstSystem();
@@ -738,11 +1082,6 @@ void PowerTabEditor::moveCaretToLastSection()
     getCaret().moveToLastSystem();
 }
 
-void PowerTabEditor::moveCaretToSystem(int system)
-{
-    getCaret().moveToSystem(system, true);
-}
-
 void PowerTabEditor::moveCaretToNextStaff()
 {
     getCaret().moveStaff(1);
@@ -2017,10 +2356,6 @@ void PowerTabEditor::info(void)
 
 bool PowerTabEditor::eventFilter(QObject *object, QEvent *event)
 {
-    // Don't handle key presses during playback.
-    if (myIsPlaying)
-        return QMainWindow::eventFilter(object, event);
-
     ScoreArea *scorearea = getScoreArea();
     if (scorearea && event->type() == QEvent::KeyPress)
     {
@@ -2049,13 +2384,13 @@ bool PowerTabEditor::eventFilter(QObject *object, QEvent *event)
                                 location.getSystemIndex());
                 }
 
+                // The note will be heard anyways if the score is being
+                // played.
                 auto settings = mySettingsManager->getReadHandle();
-                if (settings->get(Settings::PlayNotesWhileEditing))
+                if (settings->get(Settings::PlayNotesWhileEditing) &&
+                    !myIsPlaying)
                 {
-                    QMetaObject::invokeMethod(
-                        myMidiPlayer,
-                        [&]() { myMidiPlayer->playSingleNote(getLocation()); },
-                        Qt::QueuedConnection);
+                    myMidiPlayer->playSingleNote(getLocation());
                 }
 
                 return true;
@@ -2078,6 +2413,9 @@ void PowerTabEditor::closeEvent(QCloseEvent *event)
         }
     }
 
+    // Don't bother opening any files that are still loading.
+    myDocumentLoader->cancelAll();
+
     // Clean up the midi thread.
     Q_ASSERT(myMidiThread);
     myMidiThread->quit();
@@ -2269,6 +2607,11 @@ void PowerTabEditor::createCommands()
         startStopPlayback(/* from_measure_start */ true);
     });
 
+    myLoopSelectionCommand = new Command(
+        tr("Loop Selection"), "Playback.LoopSelection", QKeySequence(), this);
+    connect(myLoopSelectionCommand, &QAction::triggered, this,
+            &PowerTabEditor::startLoopPlayback);
+
     myStopCommand =
         new Command(tr("Stop"), "Playback.Stop", Qt::ALT + Qt::Key_Space, this);
     connect(myStopCommand, &QAction::triggered, this,
@@ -3179,6 +3522,7 @@ void PowerTabEditor::createMenus()
     myPlaybackMenu = menuBar()->addMenu(tr("Play&back"));
     myPlaybackMenu->addAction(myPlayPauseCommand);
     myPlaybackMenu->addAction(myPlayFromStartOfMeasureCommand);
+    myPlaybackMenu->addAction(myLoopSelectionCommand);
     myPlaybackMenu->addAction(myStopCommand);
     myPlaybackMenu->addAction(myRewindCommand);
     myPlaybackMenu->addAction(myMetronomeCommand);
@@ -3498,8 +3842,10 @@ void PowerTabEditor::setPreviousDirectory(const QString &fileName)
                   myPreviousDirectory.toStdString());
 }
 
-void PowerTabEditor::setupNewTab()
+void PowerTabEditor::setupNewTab(const std::vector<SystemLayout> &layouts)
 {
+    PTE_TRACE_SCOPE("PowerTabEditor::setupNewTab");
+
     auto start = std::chrono::high_resolution_clock::now();
     qDebug() << "Tab creation started ...";
 
@@ -3507,7 +3853,12 @@ void PowerTabEditor::setupNewTab()
     Document &doc = myDocumentManager->getCurrentDocument();
 
     doc.getCaret().subscribeToChanges([=]() {
-        updateCommands();
+        // When following playback, the caret can be moved several times for
+        // one playback location, so the commands are updated afterwards by
+        // updatePlaybackCaret().
+        if (!myIsMovingPlaybackCaret)
+            updateCommands();
+
         updateLocationLabel();
 
         // When changing location to somewhere on the staff, clear any existing
@@ -3520,7 +3871,7 @@ void PowerTabEditor::setupNewTab()
     });
 
     auto scorearea = new ScoreArea(*mySettingsManager, this);
-    scorearea->renderDocument(doc);
+    scorearea->renderDocument(doc, layouts);
     scorearea->installEventFilter(this);
 
     // Connect the signals for mouse clicks on time signatures, barlines, etc.
@@ -3725,9 +4076,6 @@ canDeleteItem(ScoreItem item)
 
 void PowerTabEditor::updateCommands()
 {
-    if (myIsPlaying)
-        return;
-
     ScoreLocation location = getLocation();
     const Score &score = location.getScore();
     if (score.getSystems().empty())
@@ -4004,7 +4352,6 @@ void PowerTabEditor::enableEditing(bool enable)
             action->setEnabled(enable);
     }
 
-    myCloseTabCommand->setEnabled(enable);
     mySaveCommand->setEnabled(enable);
     mySaveAsCommand->setEnabled(enable);
     myPrintCommand->setEnabled(enable);
@@ -4014,20 +4361,28 @@ void PowerTabEditor::enableEditing(bool enable)
     myAddInstrumentCommand->setEnabled(enable);
     myPlayerChangeCommand->setEnabled(enable);
     myEditViewFiltersCommand->setEnabled(enable);
-    myNextTabCommand->setEnabled(enable);
-    myPrevTabCommand->setEnabled(enable);
 
     // MIDI commands are always enabled if documents are open.
     if (myDocumentManager->hasOpenDocuments())
     {
         myPlayPauseCommand->setEnabled(true);
+        myLoopSelectionCommand->setEnabled(true);
         myRewindCommand->setEnabled(true);
         myMetronomeCommand->setEnabled(true);
-        myStopCommand->setEnabled(myIsPlaying);
     }
 
-    // Prevent the user from changing tabs during playback.
+    enableTabSwitching(enable);
+}
+
+void PowerTabEditor::enableTabSwitching(bool enable)
+{
+    myCloseTabCommand->setEnabled(enable);
+    myNextTabCommand->setEnabled(enable);
+    myPrevTabCommand->setEnabled(enable);
     myTabWidget->tabBar()->setEnabled(enable);
+
+    if (myDocumentManager->hasOpenDocuments())
+        myStopCommand->setEnabled(myIsPlaying);
 }
 
 void PowerTabEditor::editRest(Position::DurationType duration)
@@ -4073,7 +4428,10 @@ void PowerTabEditor::stopPlayback()
 {
     assert(myIsPlaying);
     startStopPlayback();
-    getCaret().moveToLocation(myMidiPlayer->getStartLocation());
+
+    // The score may have been edited during playback, so the location is
+    // clamped to the current score.
+    getCaret().moveToLocation(*myPlaybackStartLocation);
 }
 
 void PowerTabEditor::toggleMetronome()
@@ -4106,6 +4464,43 @@ void PowerTabEditor::updateLocationLabel()
         Util::toString(getCaret().getLocation()));
 }
 
+void PowerTabEditor::queuePlaybackLocation(const SystemLocation &location)
+{
+    // Ignore any signals that were queued before playback stopped.
+    if (!myIsPlaying)
+        return;
+
+    myPendingPlaybackLocation = location;
+
+    if (!myThrottlePlaybackCaret)
+        updatePlaybackCaret();
+}
+
+void PowerTabEditor::updatePlaybackCaret()
+{
+    if (!myPendingPlaybackLocation)
+        return;
+
+    const SystemLocation location = *myPendingPlaybackLocation;
+    myPendingPlaybackLocation.reset();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    Caret &caret = getCaret();
+    myIsMovingPlaybackCaret = true;
+    if (location.getSystem() != caret.getLocation().getSystemIndex())
+        caret.moveToSystem(location.getSystem(), true);
+    caret.moveToPosition(location.getPosition());
+    myIsMovingPlaybackCaret = false;
+
+    // The commands that are enabled depend on the selected note, e.g. the
+    // note editing actions must be disabled when moving to a rest.
+    updateCommands();
+
+    myPlaybackCaretTime += std::chrono::steady_clock::now() - start;
+    ++myPlaybackCaretUpdates;
+}
+
 void PowerTabEditor::editKeySignature()
 {
     ScoreLocation &location = getLocation();
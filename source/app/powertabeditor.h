@@ -18,16 +18,23 @@
 #ifndef APP_POWERTABEDITOR_H
 #define APP_POWERTABEDITOR_H
 
+#include <chrono>
 #include <QMainWindow>
 
 #include <memory>
+#include <optional>
+#include <painters/layoutinfo.h>
 #include <score/dynamic.h>
 #include <score/position.h>
+#include <score/scorelocation.h>
+#include <score/systemlocation.h>
 #include <string>
 #include <vector>
 
+class Autosave;
 class Caret;
 class Command;
+class DocumentLoader;
 class DocumentManager;
 class FileFormatManager;
 class Instrument;
@@ -38,7 +45,9 @@ class Mixer;
 class PlaybackWidget;
 class Player;
 class QActionGroup;
+class QProgressDialog;
 class QThread;
+class QTimer;
 class RecentFiles;
 class ScoreArea;
 class ScoreLocation;
@@ -57,6 +66,10 @@ public:
     /// Opens the given list of files.
     void openFiles(const QStringList &files);
 
+    /// Offers to recover any documents that were autosaved by a previous
+    /// session which did not exit cleanly.
+    void recoverAutosavedFiles();
+
 private slots:
     /// Creates a new (blank) document.
     void createNewDocument();
@@ -68,6 +81,10 @@ private slots:
     /// Handle when the active tab is changed.
     void switchTab(int index);
 
+    /// Releases the rendered scores of the least recently used inactive tabs
+    /// until the open documents fit within the memory budget.
+    void releaseInactiveScenes();
+
     /// Closes the specified tab.
     /// @return True if the document was closed successfully.
     bool closeTab(int index);
@@ -116,6 +133,9 @@ private slots:
 
     /// Starts or stops playback of the score.
     void startStopPlayback(bool from_measure_start = false);
+    /// Repeatedly plays the selected positions, or the current bar if there
+    /// is no selection. Stops playback if it is already running.
+    void startLoopPlayback();
 
     /// Redraws only the given system.
     void redrawSystem(int);
@@ -134,8 +154,6 @@ private slots:
     void moveCaretUp();
     /// Moves the caret to the last position in the staff.
     void moveCaretToEnd();
-    /// Moves the caret to the specified position.
-    void moveCaretToPosition(int position);
     /// Moves the caret to the first system in the score.
     void moveCaretToFirstSection();
     /// Moves the caret to the next system in the score.
@@ -144,8 +162,6 @@ private slots:
     void moveCaretToPrevSection();
     /// Moves the caret to the last system in the score.
     void moveCaretToLastSection();
-    /// Moves the caret to the specified system.
-    void moveCaretToSystem(int system);
     /// Moves the caret to the next staff in the system.
     void moveCaretToNextStaff();
     /// Moves the caret to the previous staff in the system.
@@ -296,6 +312,17 @@ private:
     /// Set up the MIDI thread.
     void createMidiThread();
 
+    /// Set up the background loading of files.
+    void createDocumentLoader();
+    /// Updates the progress dialog for files that are being loaded.
+    void updateLoadingProgress(int finished, int total);
+
+    /// Set up periodic autosaving of modified documents.
+    void createAutosave();
+    /// Autosaves any documents that have been modified since the last
+    /// autosave.
+    void autosaveDocuments();
+
     /// Load any custom keyboard shortcuts.
     void loadKeyboardShortcuts();
     /// Save any custom keyboard shortcuts.
@@ -349,12 +376,17 @@ private:
     /// Updates the last directory that a file was opened from.
     void setPreviousDirectory(const QString &fileName);
     /// Sets up the UI for the current document after it has been opened.
-    void setupNewTab();
+    /// Layouts that were computed while loading the file can optionally be
+    /// provided to avoid recomputing them.
+    void setupNewTab(const std::vector<SystemLayout> &layouts = {});
     /// Updates whether menu items are enabled, checked, etc. depending on the
     /// current location.
     void updateCommands();
     /// Enables or disables all editing commands.
     void enableEditing(bool enable);
+    /// Enables or disables switching between or closing documents, which is
+    /// not allowed during playback.
+    void enableTabSwitching(bool enable);
 
     /// Moves the caret back to the start, and restarts playback if necessary.
     void rewindPlaybackToStart();
@@ -370,6 +402,11 @@ private:
     void updateZoom(double percent);
     /// Updates the playback widget with the caret's current location.
     void updateLocationLabel();
+    /// Records a new playback location from the MIDI player. Unless throttling
+    /// is disabled, the caret is moved on the next refresh.
+    void queuePlaybackLocation(const SystemLocation &location);
+    /// Moves the caret to the most recent playback location, if it changed.
+    void updatePlaybackCaret();
 
     /// Opens a file dialog and asks the user to select one or more files to
     /// open.
@@ -419,11 +456,35 @@ private:
     std::unique_ptr<DocumentManager> myDocumentManager;
     std::unique_ptr<FileFormatManager> myFileFormatManager;
     std::unique_ptr<UndoManager> myUndoManager;
+    /// Declared after the file format manager, so that any imports which are
+    /// still running finish before the file format manager is destroyed.
+    std::unique_ptr<DocumentLoader> myDocumentLoader;
+    QProgressDialog *myLoadingProgress = nullptr;
+    std::unique_ptr<Autosave> myAutosave;
+    QTimer *myAutosaveTimer = nullptr;
     std::unique_ptr<QThread> myMidiThread;
     MidiPlayer *myMidiPlayer = nullptr;
     std::unique_ptr<TuningDictionary> myTuningDictionary;
     /// Tracks whether we are currently in playback mode.
     bool myIsPlaying;
+    /// Location of the caret when playback was started.
+    std::optional<ConstScoreLocation> myPlaybackStartLocation;
+    /// The last location to play, if the current playback is looping.
+    std::optional<SystemLocation> myPlaybackLoopEnd;
+    /// Whether caret movement is coalesced during the current playback.
+    bool myThrottlePlaybackCaret = true;
+    /// Periodically moves the caret to the latest playback location.
+    QTimer *myPlaybackCaretTimer = nullptr;
+    /// The latest playback location, if the caret hasn't been moved there yet.
+    std::optional<SystemLocation> myPendingPlaybackLocation;
+    /// Set while the caret is being moved to the playback location, so that
+    /// the commands are only updated once per move.
+    bool myIsMovingPlaybackCaret = false;
+    /// Time spent on the GUI thread moving the caret during playback, and the
+    /// number of caret updates.
+    std::chrono::steady_clock::duration myPlaybackCaretTime{ 0 };
+    int myPlaybackCaretUpdates = 0;
+    std::chrono::steady_clock::time_point myPlaybackStartTime;
     /// Flag for whether a score click event is being handled.
     bool myIsHandlingClick = false;
     /// Tracks the last directory that a file was opened from.
@@ -468,6 +529,7 @@ private:
     QMenu *myPlaybackMenu;
     Command *myPlayPauseCommand;
     Command *myPlayFromStartOfMeasureCommand;
+    Command *myLoopSelectionCommand;
     Command *myStopCommand;
     Command *myRewindCommand;
     Command *myMetronomeCommand;
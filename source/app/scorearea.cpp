@@ -18,12 +18,14 @@
 #include "scorearea.h"
 
 #include <app/documentmanager.h>
+#include <app/memoryusage.h>
 #include <app/settings.h>
 #include <chrono>
 #include <future>
 #include <painters/caretpainter.h>
 #include <painters/scoreclickevent.h>
 #include <painters/scoreinforenderer.h>
+#include <painters/styles.h>
 #include <painters/systemrenderer.h>
 #include <QDebug>
 #include <QGraphicsItem>
@@ -31,6 +33,7 @@
 #include <QPrinter>
 #include <QScrollBar>
 #include <score/score.h>
+#include <util/tracing.h>
 
 static const double SYSTEM_SPACING = 50;
 
@@ -44,17 +47,12 @@ ScoreArea::ScoreArea(SettingsManager &settings_manager, QWidget *parent)
       myScoreInfoBlock(nullptr),
       myCaretPainter(nullptr),
       myDefaultPalette(&parent->palette()),
+      myLightPalette(Styles::getLightPalette()),
       myActivePalette(nullptr),
       myDisableRedraw(false)
 {
     setScene(&myScene);
 
-    // Configure the palette for the light theme and printing.
-    myLightPalette.setColor(QPalette::Base, Qt::white);
-    myLightPalette.setColor(QPalette::Text, Qt::black);
-    myLightPalette.setColor(QPalette::Light, Qt::white);
-    myLightPalette.setColor(QPalette::Dark, Qt::lightGray);
-
     // Configure the palette for the dark theme.
     myDarkPalette.setColor(QPalette::Base, QColor(30, 30, 30));
     myDarkPalette.setColor(QPalette::Text, QColor(255, 255, 255, 216));
@@ -73,18 +71,23 @@ ScoreArea::ScoreArea(SettingsManager &settings_manager, QWidget *parent)
             ScoreItemAction action) { itemClicked(item, location, action); });
 }
 
-void ScoreArea::renderDocument(const Document &document)
+void ScoreArea::renderDocument(const Document &document,
+                               const std::vector<SystemLayout> &layouts)
 {
+    PTE_TRACE_SCOPE("ScoreArea::renderDocument");
+
     myScene.clear();
     myRenderedSystems.clear();
+    myCachedSceneMemory.reset();
     myDocument = &document;
+    myRenderedPalette = *myActivePalette;
 
     const Score &score = document.getScore();
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    myCaretPainter =
-        new CaretPainter(document.getCaret(), document.getViewOptions());
+    myCaretPainter = new CaretPainter(document.getCaret(),
+                                      document.getViewOptions(), myLayoutStore);
     myCaretPainter->subscribeToMovement([=]() {
         adjustScroll();
     });
@@ -96,6 +99,14 @@ void ScoreArea::renderDocument(const Document &document)
     for (unsigned int i = 0; i < score.getSystems().size(); ++i)
         myRenderedSystems.append(nullptr);
 
+    // Start from any layouts that were computed in advance, or from the
+    // previous layouts of any unchanged staves. The renderer fills in the rest.
+    myLayoutStore.reset(score, layouts);
+
+    // Build the bar number index up front, since it is cached lazily and the
+    // systems may be rendered from multiple threads.
+    score.getBarIndex();
+
 #if 0
     const int num_threads = std::thread::hardware_concurrency();
 #else
@@ -115,8 +126,11 @@ void ScoreArea::renderDocument(const Document &document)
         {
             for (int i = left; i < right; ++i)
             {
-                SystemRenderer render(this, score, document.getViewOptions());
-                myRenderedSystems[i] = render(score.getSystems()[i], i);
+                SystemRenderer render(myClickEvent, *myActivePalette, score,
+                                      document.getViewOptions());
+                myRenderedSystems[i] =
+                    render(score.getSystems()[i], i,
+                           myLayoutStore.getSystemLayouts(i));
             }
         }, left, right));
     }
@@ -150,12 +164,17 @@ void ScoreArea::renderDocument(const Document &document)
 
 void ScoreArea::redrawSystem(int index)
 {
+    PTE_TRACE_SCOPE("ScoreArea::redrawSystem");
+
     // Delete and remove the system from the scene.
     delete myRenderedSystems.takeAt(index);
+    myCachedSceneMemory.reset();
 
     const Score &score = myDocument->getScore();
-    SystemRenderer render(this, score, myDocument->getViewOptions());
-    QGraphicsItem *newSystem = render(score.getSystems()[index], index);
+    SystemRenderer render(myClickEvent, *myActivePalette, score,
+                          myDocument->getViewOptions());
+    QGraphicsItem *newSystem = render(score.getSystems()[index], index,
+                                      myLayoutStore.invalidateSystem(score, index));
 
     double height = 0;
     if (index > 0)
@@ -185,6 +204,27 @@ void ScoreArea::redrawSystem(int index)
     myCaretPainter->updatePosition();
 }
 
+void ScoreArea::releaseScene()
+{
+    PTE_TRACE_SCOPE("ScoreArea::releaseScene");
+
+    // This also deletes the caret painter.
+    myScene.clear();
+    myRenderedSystems.clear();
+    myScoreInfoBlock = nullptr;
+    myCaretPainter = nullptr;
+    myLayoutStore.clear();
+    myCachedSceneMemory.reset();
+}
+
+size_t ScoreArea::estimateSceneMemory() const
+{
+    if (!myCachedSceneMemory)
+        myCachedSceneMemory = MemoryUsage::estimateScene(myScene);
+
+    return *myCachedSceneMemory;
+}
+
 void ScoreArea::print(QPrinter &printer)
 {
     QPainter painter;
@@ -197,8 +237,9 @@ void ScoreArea::print(QPrinter &printer)
     // Hide the caret when printing.
     myCaretPainter->hide();
 
-    //render the document after the palette has been set to print colors
-    this->renderDocument(*myDocument);
+    // Switch the score to the print colors. This only changes the colors of
+    // the existing items, and doesn't require rendering the score again.
+    applyActivePalette();
 
     // Scale the score based on the ratio between the device's width and our
     // normal staff width in the UI.
@@ -249,9 +290,17 @@ void ScoreArea::print(QPrinter &printer)
     myCaretPainter->show();
     painter.end();
 
-    // Revert to the original app palette and re-render the document
+    // Revert to the original app palette.
     myActivePalette = orig_palette;
-    renderDocument(*myDocument);
+    applyActivePalette();
+}
+
+void ScoreArea::applyActivePalette()
+{
+    PTE_TRACE_SCOPE("ScoreArea::applyActivePalette");
+
+    Styles::applyPalette(myScene, myRenderedPalette, *myActivePalette);
+    myRenderedPalette = *myActivePalette;
 }
 
 void ScoreArea::adjustScroll()
@@ -268,13 +317,15 @@ void ScoreArea::adjustScroll()
 
 void ScoreArea::focusInEvent(QFocusEvent *)
 {
-    myScene.update(myCaretPainter->sceneBoundingRect());
+    if (hasScene())
+        myScene.update(myCaretPainter->sceneBoundingRect());
 }
 
 void ScoreArea::focusOutEvent(QFocusEvent *)
 {
     // Redraw the caret to indicate that the score has lost focus.
-    myScene.update(myCaretPainter->sceneBoundingRect());
+    if (hasScene())
+        myScene.update(myCaretPainter->sceneBoundingRect());
 }
 
 void ScoreArea::refreshZoom()
@@ -295,12 +346,15 @@ bool ScoreArea::event(QEvent *event)
 {
     QGraphicsView::event(event);
 
-    // Redraw when the parent widget's (default) palette changes, or our
-    // palette is changed.
+    // Recolor the score when the parent widget's (default) palette changes,
+    // or our palette is changed.
     if (event->type() == QEvent::PaletteChange)
     {
-        if (!myDisableRedraw)
-            this->renderDocument(*myDocument);
+        // Only the colors need to be updated, rather than rendering the
+        // score again. A released scene is rendered with the new palette when
+        // the score area is next shown.
+        if (!myDisableRedraw && hasScene())
+            applyActivePalette();
 
         return true;
     }
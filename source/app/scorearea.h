@@ -20,9 +20,13 @@
 
 #include "settingsmanager.h"
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <QGraphicsScene>
 #include <QGraphicsView>
+#include <painters/layoutinfo.h>
+#include <painters/layoutstore.h>
 #include <score/staff.h>
 #include <painters/scoreclickevent.h>
 
@@ -48,7 +52,11 @@ class ScoreArea : public QGraphicsView
 public:
     explicit ScoreArea(SettingsManager &settings_manager, QWidget *parent);
 
-    void renderDocument(const Document &document);
+    /// Renders the document. Layouts that were computed in advance (e.g. while
+    /// loading the file in the background) can optionally be provided for each
+    /// system.
+    void renderDocument(const Document &document,
+                        const std::vector<SystemLayout> &layouts = {});
 
     void refreshZoom();
 
@@ -65,6 +73,32 @@ public:
     /// returns the palette used by scorearea
     const QPalette *getPalette() const;
 
+    /// Returns the layouts of the staves that have been rendered.
+    const LayoutStore &getLayoutStore() const { return myLayoutStore; }
+
+    /// Returns whether the document is currently rendered.
+    bool hasScene() const { return myCaretPainter != nullptr; }
+
+    /// Deletes all of the rendered items to save memory, e.g. for an inactive
+    /// tab. The document must be rendered again before the score area is
+    /// shown.
+    void releaseScene();
+
+    /// Estimates the memory used by the rendered items. This is cached until
+    /// the scene is modified.
+    size_t estimateSceneMemory() const;
+
+    /// Records that the score area has been shown, so that the scenes of the
+    /// least recently used tabs are released first.
+    void markActivated()
+    {
+        myLastActivated = std::chrono::steady_clock::now();
+    }
+    std::chrono::steady_clock::time_point getLastActivated() const
+    {
+        return myLastActivated;
+    }
+
 signals:
     void itemClicked(ScoreItem item, const ConstScoreLocation &location,
                      ScoreItemAction action);
@@ -81,10 +115,14 @@ private:
     /// Load the user's preferred color scheme for the score.
     void loadTheme(const SettingsManager &settings_manager, bool redraw = true);
 
+    /// Recolors the rendered score to match the active palette.
+    void applyActivePalette();
+
     Scene myScene;
     const Document *myDocument;
     QGraphicsItem *myScoreInfoBlock;
     QList<QGraphicsItem *> myRenderedSystems;
+    LayoutStore myLayoutStore;
     CaretPainter *myCaretPainter;
     /// The color palette from the parent widget.
     const QPalette *myDefaultPalette;
@@ -94,10 +132,14 @@ private:
     QPalette myDarkPalette;
     /// The palette (default / light / dark) currently used by the score area.
     const QPalette *myActivePalette;
+    /// The colors that the scene's items were drawn with.
+    QPalette myRenderedPalette;
 
     ScoreClickEvent myClickEvent;
     boost::signals2::scoped_connection mySettingsListener;
     bool myDisableRedraw;
+    std::chrono::steady_clock::time_point myLastActivated;
+    mutable std::optional<size_t> myCachedSceneMemory;
 };
 
 #endif
@@ -37,6 +37,11 @@ const Setting<std::vector<std::string>> RecentFiles("app/recent_files", {});
 const Setting<bool> OpenFilesInNewWindow("app/open_files_in_new_window",
                                          false);
 
+const Setting<int> AutosaveInterval("app/autosave_interval", 60);
+const Setting<bool> ThrottlePlaybackCaret("app/throttle_playback_caret", true);
+const Setting<std::string> TraceFile("app/trace_file", "");
+const Setting<int> SceneMemoryBudget("app/scene_memory_budget", 1024);
+
 const Setting<ScoreTheme> Theme("app/score_theme", ScoreTheme::SystemDefault);
 
 const Setting<std::string> DefaultInstrumentName("app/default_instrument_name",
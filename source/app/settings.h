@@ -40,6 +40,18 @@ namespace Settings
     extern const Setting<std::vector<std::string>> RecentFiles;
     extern const Setting<ScoreTheme> Theme;
     extern const Setting<bool> OpenFilesInNewWindow;
+    /// Interval (in seconds) between autosaves, or zero to disable autosave.
+    extern const Setting<int> AutosaveInterval;
+    /// Whether caret movement during playback is limited to the display's
+    /// refresh rate.
+    extern const Setting<bool> ThrottlePlaybackCaret;
+    /// If non-empty, a performance trace is recorded and written to this file
+    /// when the program exits (see also the --trace option).
+    extern const Setting<std::string> TraceFile;
+    /// Approximate memory (in megabytes) that open documents can use before
+    /// the rendered scores of the least recently used tabs are released, or
+    /// zero for no limit.
+    extern const Setting<int> SceneMemoryBudget;
 
     extern const Setting<std::string> DefaultInstrumentName;
     extern const Setting<int> DefaultInstrumentPreset;
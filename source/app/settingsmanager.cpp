@@ -24,6 +24,17 @@
 static const char *theSettingsFilename = "settings.json";
 #endif
 
+SettingsManager::SettingsManager()
+    : mySnapshot(std::make_shared<const SettingsTree>())
+{
+}
+
+void SettingsManager::publishSnapshot()
+{
+    std::atomic_store(&mySnapshot,
+                      std::make_shared<const SettingsTree>(mySettings));
+}
+
 void SettingsManager::load(const std::filesystem::path &dir)
 {
 #ifdef __APPLE__
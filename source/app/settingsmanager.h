@@ -20,6 +20,7 @@
 
 #include <boost/signals2/signal.hpp>
 #include <filesystem>
+#include <memory>
 #include <mutex>
 #include <util/settingstree.h>
 
@@ -67,30 +68,37 @@ public:
     public:
         WriteHandle(SettingsManager &manager)
             : Handle(manager.mySettings, manager.myMutex),
-              mySignal(manager.mySettingsChangedSignal)
+              myManager(manager)
         {
         }
 
         ~WriteHandle()
         {
+            if (!myLock.owns_lock())
+                return;
+
+            // Publish the new snapshot while the lock is held, so that
+            // snapshots from concurrent writers are published in order.
+            myManager.publishSnapshot();
+
             // Unlock before signalling to avoid deadlocks if callbacks read the
             // settings.
             myLock.unlock();
-            mySignal();
+            myManager.mySettingsChangedSignal();
         }
 
         // TODO - change to a defaulted move constructor when VS2013 is no
         // longer supported.
         WriteHandle(WriteHandle &&other)
-            : Handle<SettingsTree>(std::move(other)), mySignal(other.mySignal)
+            : Handle<SettingsTree>(std::move(other)), myManager(other.myManager)
         {
         }
 
     private:
-        SettingsChangedSignal &mySignal;
+        SettingsManager &myManager;
     };
 
-    SettingsManager() = default;
+    SettingsManager();
     SettingsManager(const SettingsManager &) = delete;
     SettingsManager &operator=(const SettingsManager &) = delete;
 
@@ -100,6 +108,14 @@ public:
         return ReadHandle(mySettings, myMutex);
     }
 
+    /// Returns an immutable copy of the settings as of the most recent
+    /// change. Unlike getReadHandle(), this never waits for a writer to finish,
+    /// so it is suitable for use from the MIDI thread during playback.
+    std::shared_ptr<const SettingsTree> getSnapshot() const
+    {
+        return std::atomic_load(&mySnapshot);
+    }
+
     /// Obtain write access to the settings.
     WriteHandle getWriteHandle()
     {
@@ -123,8 +139,15 @@ private:
     template <typename T>
     friend class Handle;
 
+    /// Replaces the snapshot with a copy of the current settings. The mutex
+    /// must be held by the caller.
+    void publishSnapshot();
+
     SettingsTree mySettings;
     mutable std::mutex myMutex;
+    /// Read-copy-update snapshot of the settings. This is only accessed with
+    /// std::atomic_load() and std::atomic_store().
+    std::shared_ptr<const SettingsTree> mySnapshot;
 
     SettingsChangedSignal mySettingsChangedSignal;
 };
@@ -17,6 +17,7 @@
 
 #include "midiplayer.h"
 
+#include <algorithm>
 #include <app/settingsmanager.h>
 #include <audio/midioutputdevice.h>
 #include <audio/settings.h>
@@ -24,10 +25,13 @@
 #include <cassert>
 #include <chrono>
 #include <midi/midifile.h>
+#include <midi/playbackloop.h>
 #include <score/generalmidi.h>
 #include <score/score.h>
+#include <set>
 #include <thread>
 #include <util/scopeexit.h>
+#include <util/tracing.h>
 
 #ifdef _WIN32
 #include <objbase.h>
@@ -81,6 +85,8 @@ MidiPlayer::init()
     CoInitializeEx(nullptr, COINIT_MULTITHREADED);
 #endif
 
+    Util::Tracing::setThreadName("MIDI");
+
     updateLiveSettings();
     updateDeviceSettings();
 }
@@ -89,28 +95,37 @@ void
 MidiPlayer::updateDeviceSettings()
 {
     // Load MIDI settings.
-    int api;
-    int port;
-    {
-        auto settings = mySettingsManager.getReadHandle();
-        api = settings->get(Settings::MidiApi);
-        port = settings->get(Settings::MidiPort);
-    }
+    auto settings = mySettingsManager.getSnapshot();
+    const int api = settings->get(Settings::MidiApi);
+    const int port = settings->get(Settings::MidiPort);
+
+    // Initializing the device is expensive (all of the RtMidi APIs are
+    // enumerated), so only do so if the device settings changed rather than
+    // for any settings change.
+    if (myDevice && api == myDeviceApi && port == myDevicePort)
+        return;
 
     // Initialize RtMidi and set the port.
     myDevice = std::make_unique<MidiOutputDevice>();
     if (!myDevice->initialize(api, port))
     {
+        // Forget the previous device settings so that initialization is
+        // retried on the next settings change.
         myDevice.reset();
+        myDeviceApi = -1;
+        myDevicePort = -1;
         emit error(tr("Error initializing MIDI output device."));
         return;
     }
+
+    myDeviceApi = api;
+    myDevicePort = port;
 }
 
 void
 MidiPlayer::updateLiveSettings()
 {
-    auto settings = mySettingsManager.getReadHandle();
+    auto settings = mySettingsManager.getSnapshot();
     myMetronomeEnabled = settings->get(Settings::MetronomeEnabled);
 }
 
@@ -124,7 +139,7 @@ static void
 loadMidiSettings(const SettingsManager &settings_manager,
                  MidiFile::LoadOptions &options)
 {
-    auto settings = settings_manager.getReadHandle();
+    auto settings = settings_manager.getSnapshot();
 
     options.myMetronomePreset = settings->get(Settings::MetronomePreset) +
                                 Midi::MIDI_PERCUSSION_PRESET_OFFSET;
@@ -154,56 +169,218 @@ mergeMidiEvents(MidiFile &file)
     return events;
 }
 
+/// Returns whether playback moves to a new position at this event, using the
+/// same rules as for moving the caret during playback.
+static bool
+isPositionTransition(const MidiEvent &event,
+                     const SystemLocation &current_location)
+{
+    const SystemLocation &location = event.getLocation();
+    return location != current_location &&
+           (location >= current_location || event.isPositionChange());
+}
+
+/// Finds the event in the regenerated event list that corresponds to where
+/// playback is about to move to in the old event list.
+/// The current position is matched by its location and the number of times it
+/// has been visited (e.g. due to repeats), and playback resumes from the next
+/// position after it.
+static MidiEventList::const_iterator
+findSplicePoint(const MidiEventList &old_events,
+                MidiEventList::const_iterator old_next,
+                const MidiEventList &new_events)
+{
+    // Find the current position.
+    SystemLocation current_location;
+    for (auto it = old_events.begin(); it != old_next; ++it)
+    {
+        if (isPositionTransition(*it, current_location))
+            current_location = it->getLocation();
+    }
+
+    // Count how many times it has been visited.
+    auto count_visits = [&](SystemLocation &location, const MidiEvent &event) {
+        if (!isPositionTransition(event, location))
+            return false;
+
+        location = event.getLocation();
+        return location == current_location;
+    };
+
+    const SystemLocation initial_location;
+    const int initial_visits = initial_location == current_location ? 1 : 0;
+
+    int visits = initial_visits;
+    SystemLocation location = initial_location;
+    for (auto it = old_events.begin(); it != old_next; ++it)
+    {
+        if (count_visits(location, *it))
+            ++visits;
+    }
+
+    // Walk through the new events in the same way, and stop at the first
+    // transition after the matching visit.
+    int new_visits = initial_visits;
+    location = initial_location;
+    for (auto it = new_events.begin(); it != new_events.end(); ++it)
+    {
+        if (new_visits == visits && location == current_location &&
+            isPositionTransition(*it, location))
+        {
+            return it;
+        }
+
+        if (count_visits(location, *it))
+            ++new_visits;
+    }
+
+    // The current position no longer exists (e.g. it was removed), so resume
+    // from the next position in the score.
+    return std::find_if(new_events.begin(), new_events.end(),
+                        [&](const MidiEvent &event) {
+                            return event.getLocation() > current_location;
+                        });
+}
+
+/// Notes that are currently playing, as (channel, pitch) pairs.
+typedef std::set<std::pair<int, int>> ActiveNotes;
+
+static bool
+isNoteOff(const MidiEvent &event)
+{
+    if (!event.isNoteOnOff())
+        return false;
+
+    const std::vector<uint8_t> &data = event.getData();
+    return (data[0] & 0xf0) == MidiEvent::NoteOff || data[2] == 0;
+}
+
+static void
+updateActiveNotes(const MidiEvent &event, ActiveNotes &active_notes)
+{
+    if (!event.isNoteOnOff())
+        return;
+
+    const ActiveNotes::value_type note(event.getChannel(),
+                                       event.getData()[1]);
+    if (isNoteOff(event))
+        active_notes.erase(note);
+    else
+        active_notes.insert(note);
+}
+
 bool
-MidiPlayer::playEvents(MidiFile &file, const Score &score,
+MidiPlayer::playEvents(MidiFile &file, std::shared_ptr<const Score> score,
                        const SystemLocation &start_location,
-                       bool allow_count_in)
+                       bool allow_count_in, bool allow_updates)
 {
+    PTE_TRACE_SCOPE("MidiPlayer::playEvents");
+
     myIsPlaying = true;
     Util::ScopeExit on_exit([&]() {
         myIsPlaying = false;
     });
 
     MidiEventList events = mergeMidiEvents(file);
-    const int ticks_per_beat = file.getTicksPerBeat();
+    int ticks_per_beat = file.getTicksPerBeat();
 
     bool started = false;
     Midi::Tempo beat_duration = Midi::BEAT_DURATION_120_BPM;
     SystemLocation current_location = start_location;
     DurationType clock_drift(0);
+    ActiveNotes active_notes;
+
+    // Sends events such as instrument changes, pitch wheels, etc that occur
+    // before the point where playback starts.
+    auto send_setup_event = [&](const MidiEvent &event) {
+        // Tempo changes are tracked separately and shouldn't be sent out since
+        // CoreMidi on OSX complains about them.
+        if (event.isTempoChange())
+            beat_duration = event.getTempo();
+        else if (event.isVolumeChange())
+        {
+            // Use MidiOutputDevice::setVolume() so that the volume is updated
+            // when the channel's max volume changes (see below).
+            myDevice->setVolume(event.getChannel(), event.getVolume());
+        }
+        else if (!event.isNoteOnOff())
+            myDevice->sendMessage(event.getData());
+    };
 
-    for (const MidiEvent &event : events)
+    for (auto event_it = events.begin(); event_it != events.end(); ++event_it)
     {
         if (!myIsPlaying)
             return false;
 
+        // If the score was edited, continue from the equivalent point in the
+        // regenerated event list. This is only done when moving to a new
+        // position so that the current notes are not cut off.
+        std::unique_ptr<UpdatedEvents> updated;
+        if (started && allow_updates && myHasUpdatedEvents &&
+            isPositionTransition(*event_it, current_location) &&
+            (updated = takeUpdatedEvents()))
+        {
+            PTE_TRACE_SCOPE("MidiPlayer::spliceEvents");
+
+            MidiEventList &updated_events = updated->myEvents;
+
+            auto splice_it =
+                findSplicePoint(events, event_it, updated_events);
+
+            for (auto it = updated_events.begin(); it != splice_it; ++it)
+                send_setup_event(*it);
+
+            // Stop any active notes that no longer have a matching note off
+            // event, e.g. if the note was removed.
+            ActiveNotes pending_notes;
+            for (auto it = splice_it; it != updated_events.end(); ++it)
+            {
+                if (isNoteOff(*it))
+                    pending_notes.emplace(it->getChannel(), it->getData()[1]);
+            }
+
+            for (auto it = active_notes.begin(); it != active_notes.end();)
+            {
+                if (pending_notes.count(*it))
+                    ++it;
+                else
+                {
+                    myDevice->stopNote(it->first,
+                                       static_cast<uint8_t>(it->second));
+                    it = active_notes.erase(it);
+                }
+            }
+
+            const auto offset = std::distance(
+                MidiEventList::const_iterator(updated_events.begin()),
+                splice_it);
+            events = std::move(updated_events);
+            event_it = events.begin() + offset;
+            ticks_per_beat = updated->myTicksPerBeat;
+            score = std::move(updated->myScore);
+
+            if (event_it == events.end())
+                break;
+        }
+
+        const MidiEvent &event = *event_it;
+
         if (event.isTempoChange())
             beat_duration = event.getTempo();
 
         // Skip note on / off events before the start location, but send events
         // such as instrument changes, pitch wheels, etc.
-        // Tempo changes are tracked above and shouldn't be sent out since
-        // CoreMidi on OSX complains about them.
         if (!started)
         {
             if (event.getLocation() < start_location)
             {
-                if (event.isVolumeChange())
-                {
-                    // Use MidiOutputDevice::setVolume() so that the volume is
-                    // updated when the channel's max volume changes (see
-                    // below).
-                    myDevice->setVolume(event.getChannel(), event.getVolume());
-                }
-                else if (!event.isNoteOnOff() && !event.isTempoChange())
-                    myDevice->sendMessage(event.getData());
-
+                send_setup_event(event);
                 continue;
             }
             else
             {
                 if (allow_count_in)
-                    performCountIn(score, event.getLocation(), beat_duration);
+                    performCountIn(*score, event.getLocation(), beat_duration);
 
                 started = true;
             }
@@ -214,7 +391,7 @@ MidiPlayer::playEvents(MidiFile &file, const Score &score,
         const int delta = event.getTicks();
         assert(delta >= 0);
 
-		// Compute the time in microseconds that we should sleep for, and then
+        // Compute the time in microseconds that we should sleep for, and then
         // adjust for accumulated timing errors (since sleep_for() is not
         // perfectly precise).
         auto sleep_duration = DurationType(static_cast<int64_t>(
@@ -230,56 +407,11 @@ MidiPlayer::playEvents(MidiFile &file, const Score &score,
         if (sleep_duration.count() != 0)
             std::this_thread::sleep_for(sleep_duration);
 
-        // Don't play metronome events if the metronome is disabled.
-        // Tempo change events also don't need to be sent since they are
-        // handled in this loop. CoreMidi on OSX also complains about them.
-        // Similarly, ALSA complains about the meta "track end" events.
-        if (!(event.isNoteOnOff() &&
-              event.getChannel() == METRONOME_CHANNEL &&
-              !myMetronomeEnabled) &&
-            !event.isTempoChange() &&
-            !event.isTrackEnd() &&
-            !event.isVolumeChange())
-        {
-            myDevice->sendMessage(event.getData());
-        }
-
-        if (!event.isMetaMessage())
-        {
-            const int channel = event.getChannel();
-            const int player_idx = getPlayerFromChannel(channel);
-            // If the channel corresponds to a valid player, set its maximum
-            // volume
-            if (player_idx >= 0)
-            {
-                const Player &player = score.getPlayers()[player_idx];
-                myDevice->setChannelMaxVolume(channel, player.getMaxVolume());
-                myDevice->setPan(channel, player.getPan());
-            }
-
-            // handle volume change events
-            // using device.setVolume() ensures that the maximum volume
-            // threshold is taken into consideration
-            if (event.isVolumeChange())
-                myDevice->setVolume(channel, event.getVolume());
-        }
+        if (sendEvent(event, *score))
+            updateActiveNotes(event, active_notes);
 
         // Notify listeners of the current playback position.
-        if (event.getLocation() != current_location)
-        {
-            const SystemLocation &new_location = event.getLocation();
-
-            // Don't move backwards unless a repeat occurred.
-            if (new_location >= current_location || event.isPositionChange())
-            {
-                if (new_location.getSystem() != current_location.getSystem())
-                    emit playbackSystemChanged(new_location.getSystem());
-
-                emit playbackPositionChanged(new_location.getPosition());
-
-                current_location = new_location;
-            }
-        }
+        updatePlaybackLocation(event, current_location);
 
         // Accumulate any difference between the desired delta time and what
         // actually happened.
@@ -292,32 +424,205 @@ MidiPlayer::playEvents(MidiFile &file, const Score &score,
     return true;
 }
 
+bool
+MidiPlayer::sendEvent(const MidiEvent &event, const Score &score)
+{
+    bool sent = false;
+
+    // Don't play metronome events if the metronome is disabled.
+    // Tempo change events also don't need to be sent since they are
+    // handled by the playback loop. CoreMidi on OSX also complains about them.
+    // Similarly, ALSA complains about the meta "track end" events.
+    if (!(event.isNoteOnOff() && event.getChannel() == METRONOME_CHANNEL &&
+          !myMetronomeEnabled) &&
+        !event.isTempoChange() && !event.isTrackEnd() &&
+        !event.isVolumeChange())
+    {
+        myDevice->sendMessage(event.getData());
+        sent = true;
+    }
+
+    if (!event.isMetaMessage())
+    {
+        const int channel = event.getChannel();
+        const int player_idx = getPlayerFromChannel(channel);
+        // If the channel corresponds to a valid player, set its maximum
+        // volume
+        if (player_idx >= 0 &&
+            player_idx < static_cast<int>(score.getPlayers().size()))
+        {
+            const Player &player = score.getPlayers()[player_idx];
+            myDevice->setChannelMaxVolume(channel, player.getMaxVolume());
+            myDevice->setPan(channel, player.getPan());
+        }
+
+        // handle volume change events
+        // using device.setVolume() ensures that the maximum volume
+        // threshold is taken into consideration
+        if (event.isVolumeChange())
+            myDevice->setVolume(channel, event.getVolume());
+    }
+
+    return sent;
+}
+
+void
+MidiPlayer::updatePlaybackLocation(const MidiEvent &event,
+                                   SystemLocation &current_location)
+{
+    if (event.getLocation() == current_location)
+        return;
+
+    const SystemLocation &new_location = event.getLocation();
+
+    // Don't move backwards unless a repeat occurred.
+    if (isPositionTransition(event, current_location))
+    {
+        if (new_location.getSystem() != current_location.getSystem())
+            emit playbackSystemChanged(new_location.getSystem());
+
+        emit playbackPositionChanged(new_location.getPosition());
+
+        current_location = new_location;
+    }
+}
+
+void
+MidiPlayer::playLoopEvents(const PlaybackLoop &loop, const Score &score)
+{
+    PTE_TRACE_SCOPE("MidiPlayer::playLoopEvents");
+
+    myIsPlaying = true;
+    Util::ScopeExit on_exit([&]() {
+        myIsPlaying = false;
+    });
+
+    int speed_increment = 0;
+    {
+        auto settings = mySettingsManager.getSnapshot();
+        speed_increment = settings->get(Settings::LoopSpeedIncrement);
+    }
+
+    // Events are scheduled relative to the start of each iteration rather
+    // than the previous event, so timing errors don't accumulate and the next
+    // iteration starts exactly when the previous one ends.
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point iteration_start = Clock::now();
+
+    for (int iteration = 0; myIsPlaying; ++iteration)
+    {
+        // Restore the state of each channel, e.g. if a bend was active at the
+        // end of the previous iteration.
+        for (const MidiEvent &event : loop.getSetupEvents())
+            sendEvent(event, score);
+
+        // Optionally speed up after each iteration, until reaching full speed.
+        int speed = myPlaybackSpeed;
+        if (speed_increment > 0 && speed < 100)
+            speed = std::min(100, speed + iteration * speed_increment);
+        const double time_scale = 100.0 / speed;
+
+        // Ensure the caret moves back to the start of the loop.
+        SystemLocation current_location(-1, -1);
+
+        for (const PlaybackLoop::Event &event : loop.getEvents())
+        {
+            std::this_thread::sleep_until(
+                iteration_start +
+                std::chrono::duration_cast<Clock::duration>(
+                    event.myTime * time_scale));
+
+            if (!myIsPlaying)
+                return;
+
+            sendEvent(event.myEvent, score);
+            updatePlaybackLocation(event.myEvent, current_location);
+        }
+
+        iteration_start += std::chrono::duration_cast<Clock::duration>(
+            loop.getDuration() * time_scale);
+    }
+}
+
 void
 MidiPlayer::playScore(const ConstScoreLocation &start_score_location, int speed)
 {
-    myPlaybackSpeed = speed;
-    myStartLocation.emplace(start_score_location);
-    const Score &score = start_score_location.getScore();
+    // Discard any updates from a previous playback session.
+    discardUpdatedEvents();
+
+    // Take a snapshot of the score on the GUI thread, so that the score can
+    // continue to be edited while it is being played.
+    std::shared_ptr<const Score> score =
+        start_score_location.getScore().clone();
+    const SystemLocation start_location(
+        start_score_location.getSystemIndex(),
+        start_score_location.getPositionIndex());
+
+    MidiFile::LoadOptions options;
+    options.myEnableMetronome = true;
+    options.myRecordPositionChanges = true;
+    loadMidiSettings(mySettingsManager, options);
+    myUpdateOptions = options;
+
+    QMetaObject::invokeMethod(
+        this,
+        [this, score, start_location, speed, options]() {
+            myPlaybackSpeed = speed;
+
+            MidiFile file;
+            file.load(*score, options);
+
+            if (playEvents(file, score, start_location,
+                           /* allow_count_in */ true,
+                           /* allow_updates */ true))
+            {
+                emit playbackFinished();
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+void
+MidiPlayer::playLoop(const ConstScoreLocation &start,
+                     const SystemLocation &end, int speed)
+{
+    // The loop's events are only generated once, so any edits during loop
+    // playback are not heard until playback is restarted.
+    discardUpdatedEvents();
+    myUpdateOptions.reset();
+
+    std::shared_ptr<const Score> score = start.getScore().clone();
+    const SystemLocation start_location(start.getSystemIndex(),
+                                        start.getPositionIndex());
 
     MidiFile::LoadOptions options;
     options.myEnableMetronome = true;
     options.myRecordPositionChanges = true;
     loadMidiSettings(mySettingsManager, options);
 
-    MidiFile file;
-    file.load(score, options);
+    QMetaObject::invokeMethod(
+        this,
+        [this, score, start_location, end, speed, options]() {
+            myPlaybackSpeed = speed;
+
+            MidiFile file;
+            file.load(*score, options);
 
-    const SystemLocation start_location(myStartLocation->getSystemIndex(),
-                                        myStartLocation->getPositionIndex());
+            const PlaybackLoop loop(file, start_location, end);
+            if (loop.isEmpty())
+            {
+                emit playbackFinished();
+                return;
+            }
 
-    if (playEvents(file, score, start_location))
-        emit playbackFinished();
+            playLoopEvents(loop, *score);
+        },
+        Qt::QueuedConnection);
 }
 
 void
 MidiPlayer::playSingleNote(const ConstScoreLocation &location)
 {
-    myPlaybackSpeed = 100;
     const Score &score = location.getScore();
 
     MidiFile::LoadOptions options;
@@ -325,14 +630,112 @@ MidiPlayer::playSingleNote(const ConstScoreLocation &location)
     options.myRecordPositionChanges = false;
     loadMidiSettings(mySettingsManager, options);
 
-    MidiFile file;
-    file.loadSingleNote(score, location, options);
+    // Generate the events on the GUI thread, since this is cheap for a single
+    // note. Only the players are then needed during playback for the mixer
+    // settings, rather than a snapshot of the entire score.
+    auto file = std::make_shared<MidiFile>();
+    file->loadSingleNote(score, location, options);
+
+    auto players = std::make_shared<Score>();
+    for (const Player &player : score.getPlayers())
+        players->insertPlayer(player);
 
     const SystemLocation start_location(location.getSystemIndex(),
                                         location.getPositionIndex());
 
-    playEvents(file, score, start_location, /* allow_count_in */ false);
-    myDevice->stopAllNotes();
+    QMetaObject::invokeMethod(
+        this,
+        [this, file, players, start_location]() {
+            myPlaybackSpeed = 100;
+            playEvents(*file, players, start_location,
+                       /* allow_count_in */ false, /* allow_updates */ false);
+            myDevice->stopAllNotes();
+        },
+        Qt::QueuedConnection);
+}
+
+void
+MidiPlayer::updateScore(const Score &score)
+{
+    PTE_TRACE_SCOPE("MidiPlayer::updateScore");
+
+    if (!myUpdateOptions)
+        return;
+
+    // The snapshot must be taken on the GUI thread, but the events are
+    // regenerated in the background so that neither the GUI nor the MIDI
+    // thread is blocked. If the worker is still busy with an earlier edit,
+    // this snapshot replaces any other pending one.
+    std::shared_ptr<const Score> snapshot = score.clone();
+
+    std::lock_guard<std::mutex> lock(myUpdatedEventsMutex);
+    myPendingScore = std::move(snapshot);
+    myPendingOptions = *myUpdateOptions;
+
+    if (!myIsRegenerating)
+    {
+        myIsRegenerating = true;
+        myUpdatePool.submit([this]() { regenerateEvents(); });
+    }
+}
+
+void
+MidiPlayer::regenerateEvents()
+{
+    while (true)
+    {
+        std::shared_ptr<const Score> snapshot;
+        MidiFile::LoadOptions options;
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(myUpdatedEventsMutex);
+            if (!myPendingScore)
+            {
+                myIsRegenerating = false;
+                return;
+            }
+
+            snapshot = std::move(myPendingScore);
+            options = myPendingOptions;
+            generation = myUpdateGeneration;
+        }
+
+        PTE_TRACE_SCOPE("MidiPlayer::regenerateEvents");
+
+        auto updated = std::make_unique<UpdatedEvents>();
+        MidiFile file;
+        file.load(*snapshot, options);
+        updated->myEvents = mergeMidiEvents(file);
+        updated->myTicksPerBeat = file.getTicksPerBeat();
+        updated->myScore = snapshot;
+
+        std::lock_guard<std::mutex> lock(myUpdatedEventsMutex);
+        if (generation == myUpdateGeneration)
+        {
+            myUpdatedEvents = std::move(updated);
+            myHasUpdatedEvents = true;
+        }
+    }
+}
+
+std::unique_ptr<MidiPlayer::UpdatedEvents>
+MidiPlayer::takeUpdatedEvents()
+{
+    std::lock_guard<std::mutex> lock(myUpdatedEventsMutex);
+    myHasUpdatedEvents = false;
+    return std::move(myUpdatedEvents);
+}
+
+void
+MidiPlayer::discardUpdatedEvents()
+{
+    // Any events that are still being generated for the previous playback
+    // session are dropped by the worker once it sees the new generation.
+    std::lock_guard<std::mutex> lock(myUpdatedEventsMutex);
+    ++myUpdateGeneration;
+    myPendingScore.reset();
+    myUpdatedEvents.reset();
+    myHasUpdatedEvents = false;
 }
 
 void
@@ -343,7 +746,7 @@ MidiPlayer::performCountIn(const Score &score, const SystemLocation &location,
     uint8_t velocity;
     uint8_t preset;
     {
-        auto settings = mySettingsManager.getReadHandle();
+        auto settings = mySettingsManager.getSnapshot();
 
         if (!settings->get(Settings::CountInEnabled))
             return;
@@ -20,13 +20,18 @@
 
 #include <atomic>
 #include <boost/signals2/connection.hpp>
+#include <cstdint>
+#include <memory>
 #include <midi/midievent.h>
+#include <midi/midifile.h>
+#include <mutex>
 #include <optional>
 #include <QObject>
 #include <score/scorelocation.h>
+#include <util/threadpool.h>
 
-class MidiFile;
 class MidiOutputDevice;
+class PlaybackLoop;
 class Score;
 class SettingsManager;
 class SystemLocation;
@@ -39,19 +44,33 @@ public:
     MidiPlayer(SettingsManager &settings_manager);
     ~MidiPlayer();
 
-    /// Location where playback began. Only valid after calling playScore().
-    const ConstScoreLocation &getStartLocation() const
-    {
-        return *myStartLocation;
-    }
-
     void stopPlayback();
 
-public slots:
-    void init();
+    /// Starts playing the score from the given location.
+    /// This must be called from the GUI thread. A snapshot of the score is
+    /// taken, and playback then runs on the MIDI thread without accessing the
+    /// live score.
     void playScore(const ConstScoreLocation &start_score_location, int speed);
+    /// Repeatedly plays the locations between start and end (inclusive),
+    /// until playback is stopped. The events for the range are only generated
+    /// once, and each iteration begins immediately after the previous one.
+    /// This must be called from the GUI thread.
+    void playLoop(const ConstScoreLocation &start, const SystemLocation &end,
+                  int speed);
+    /// Plays the note at the given location.
+    /// This must be called from the GUI thread.
     void playSingleNote(const ConstScoreLocation &location);
 
+    /// Replaces the score that is being played, e.g. after it was edited
+    /// during playback. The MIDI events are regenerated from a snapshot of the
+    /// score on a worker thread, and playback switches to them when it moves
+    /// to the next position.
+    /// This must be called from the GUI thread.
+    void updateScore(const Score &score);
+
+public slots:
+    void init();
+
     /// Thread-safe, Qt::DirectConnection may be used to invoke from another
     /// thread immediately while playback is running.
     void liveChangePlaybackSpeed(int speed);
@@ -75,22 +94,80 @@ private:
     void performCountIn(const Score &score,
                         const SystemLocation &location,
                         Midi::Tempo beat_duration);
-    bool playEvents(MidiFile &file, const Score &score,
+
+    /// Plays the events starting from the given location. If updates are
+    /// allowed, playback switches to any events that are regenerated after
+    /// the score is edited.
+    bool playEvents(MidiFile &file, std::shared_ptr<const Score> score,
                     const SystemLocation &start_location,
-                    bool allow_count_in = true);
+                    bool allow_count_in, bool allow_updates);
+
+    /// Plays the loop's events until playback is stopped.
+    void playLoopEvents(const PlaybackLoop &loop, const Score &score);
+
+    /// Sends an event to the device, unless it is filtered out (e.g.
+    /// metronome events when the metronome is disabled). Returns whether the
+    /// message was sent.
+    bool sendEvent(const MidiEvent &event, const Score &score);
+
+    /// Notifies listeners if the event moves playback to a new position.
+    void updatePlaybackLocation(const MidiEvent &event,
+                                SystemLocation &current_location);
+
+    /// The events for a score that was edited during playback.
+    struct UpdatedEvents
+    {
+        std::shared_ptr<const Score> myScore;
+        MidiEventList myEvents;
+        int myTicksPerBeat = 0;
+    };
+
+    /// Returns the most recent events from updateScore(), if any.
+    std::unique_ptr<UpdatedEvents> takeUpdatedEvents();
+    /// Discards any events from updateScore(), including those that are
+    /// still being generated. This does not block, and must be called from
+    /// the GUI thread.
+    void discardUpdatedEvents();
+    /// Regenerates the events for the most recent snapshot from updateScore()
+    /// until there are no more pending snapshots. Runs on myUpdatePool.
+    void regenerateEvents();
 
     const SettingsManager &mySettingsManager;
     boost::signals2::scoped_connection mySettingsListener;
 
     std::unique_ptr<MidiOutputDevice> myDevice;
+    /// The API and port that the device was successfully initialized with.
+    int myDeviceApi = -1;
+    int myDevicePort = -1;
     std::atomic<bool> myMetronomeEnabled = false;
 
     /// Flag used to terminate playback.
     std::atomic<bool> myIsPlaying = false;
     /// The current playback speed (percent).
     std::atomic<int> myPlaybackSpeed = 100;
-    /// Location where playback began.
-    std::optional<ConstScoreLocation> myStartLocation;
+
+    /// The options for regenerating the events when the score is edited, if
+    /// the current playback supports this. Only used from the GUI thread.
+    std::optional<MidiFile::LoadOptions> myUpdateOptions;
+    /// Events that were regenerated after the score was edited.
+    std::unique_ptr<UpdatedEvents> myUpdatedEvents;
+    /// The most recent snapshot that has not been regenerated yet. Older
+    /// snapshots are replaced rather than queued, since only the latest edit
+    /// matters.
+    std::shared_ptr<const Score> myPendingScore;
+    MidiFile::LoadOptions myPendingOptions;
+    /// Whether a regenerateEvents() task has been submitted and not finished.
+    bool myIsRegenerating = false;
+    /// Incremented by discardUpdatedEvents(), so that a task which is still
+    /// running for a previous playback session drops its events.
+    uint64_t myUpdateGeneration = 0;
+    /// Protects the updated events, pending snapshot, and generation.
+    std::mutex myUpdatedEventsMutex;
+    /// Allows the MIDI thread to cheaply check for updated events.
+    std::atomic<bool> myHasUpdatedEvents = false;
+    /// Regenerates the events in the background. This is declared last so
+    /// that any running task finishes before the other members are destroyed.
+    Util::ThreadPool myUpdatePool{ 1 };
 };
 
 #endif
@@ -29,6 +29,8 @@ const Setting<int> MidiVibratoLevel("midi/vibrato_level", 85);
 
 const Setting<int> MidiWideVibratoLevel("midi/wide_vibrato_level", 127);
 
+const Setting<std::string> SoundFontPath("midi/soundfont_path", "");
+
 const Setting<bool> PlayNotesWhileEditing("midi/play_notes_while_editing",
                                           false);
 
@@ -47,4 +49,6 @@ const Setting<int> CountInPreset("midi/count_in_preset",
                                  Midi::MIDI_PERCUSSION_PRESET_RIDE_CYMBAL2);
 
 const Setting<int> CountInVolume("midi/count_in_volume", 127);
+
+const Setting<int> LoopSpeedIncrement("midi/loop_speed_increment", 0);
 }
@@ -29,6 +29,8 @@ namespace Settings
     extern const Setting<int> MidiVibratoLevel;
     extern const Setting<int> MidiWideVibratoLevel;
 
+    extern const Setting<std::string> SoundFontPath;
+
     extern const Setting<bool> PlayNotesWhileEditing;
 
     extern const Setting<bool> MetronomeEnabled;
@@ -39,6 +41,8 @@ namespace Settings
     extern const Setting<bool> CountInEnabled;
     extern const Setting<int> CountInPreset;
     extern const Setting<int> CountInVolume;
+
+    extern const Setting<int> LoopSpeedIncrement;
 }
 
 #endif
@@ -23,15 +23,25 @@
 #include <csignal>
 #include <dialogs/crashdialog.h>
 #include <exception>
+#include <formats/fileformatmanager.h>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
+#include <painters/pageexporter.h>
 #include <QApplication>
 #include <QCommandLineParser>
 #include <QFileOpenEvent>
+#include <QFontDatabase>
 #include <QLibraryInfo>
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QTranslator>
+#include <score/score.h>
 #include <string>
+#include <util/threadpool.h>
+#include <util/tracing.h>
+#include <vector>
 
 #ifdef __APPLE__
 #define BOOST_STACKTRACE_GNU_SOURCE_NOT_REQUIRED
@@ -171,13 +181,155 @@ loadTranslations(QApplication &app, QTranslator &qt_translator,
     }
 }
 
+static void writeTrace(const QString &trace_file)
+{
+    if (!Util::Tracing::isEnabled())
+        return;
+
+    Util::Tracing::stop();
+
+    std::ofstream trace_stream(Paths::fromQString(trace_file));
+    Util::Tracing::writeJson(trace_stream);
+    if (!trace_stream)
+        std::cerr << "Failed to write trace file" << std::endl;
+}
+
+static void loadFonts()
+{
+    // Load the music notation font.
+    QFontDatabase::addApplicationFont(":fonts/emmentaler-13.otf");
+    // Load the tab note font.
+    QFontDatabase::addApplicationFont(":fonts/LiberationSans-Regular.ttf");
+    QFontDatabase::addApplicationFont(":fonts/LiberationSerif-Regular.ttf");
+}
+
+/// Returns whether the files are only being exported, in which case no window
+/// is shown.
+static bool isExportOnly(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--export" || arg.rfind("--export=", 0) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+/// Converts each of the files to the given format, writing the output to the
+/// directory (or alongside the original file if the directory is empty).
+/// The files are converted in parallel.
+static int exportFiles(const SettingsManager &settings_manager,
+                       const QStringList &files, const QString &extension,
+                       const QString &output_dir)
+{
+    FileFormatManager format_manager(settings_manager);
+    PageExporter::registerFormats(format_manager);
+
+    const std::optional<FileFormat> output_format =
+        format_manager.findFormat(extension.toStdString());
+    if (!output_format)
+    {
+        std::cerr << "Unsupported export format: " << extension.toStdString()
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Choose the output paths up front. Inputs with the same name (e.g. from
+    // different directories, or with different extensions) would otherwise
+    // overwrite each other's output, so only the first one is exported.
+    const int num_files = files.size();
+    std::vector<std::filesystem::path> outputs;
+    std::vector<int> conflicts(num_files, -1);
+    std::map<std::filesystem::path, int> output_owners;
+    for (int i = 0; i < num_files; ++i)
+    {
+        const std::filesystem::path src = Paths::fromQString(files[i]);
+        std::filesystem::path dst = output_dir.isEmpty()
+                                        ? src.parent_path()
+                                        : Paths::fromQString(output_dir);
+        dst /= src.stem();
+        dst += "." + extension.toStdString();
+
+        auto [it, inserted] = output_owners.emplace(
+            std::filesystem::absolute(dst).lexically_normal(), i);
+        if (!inserted)
+            conflicts[i] = it->second;
+
+        outputs.push_back(std::move(dst));
+    }
+
+    Util::ThreadPool pool;
+    std::vector<std::future<void>> tasks(num_files);
+    for (int i = 0; i < num_files; ++i)
+    {
+        if (conflicts[i] >= 0)
+            continue;
+
+        tasks[i] = pool.submit([&, i]() {
+            const std::filesystem::path src = Paths::fromQString(files[i]);
+
+            std::string src_extension = src.extension().u8string();
+            if (!src_extension.empty())
+                src_extension.erase(0, 1);
+
+            const std::optional<FileFormat> input_format =
+                format_manager.findFormat(src_extension);
+            if (!input_format)
+                throw FileFormatException("Unsupported file format.");
+
+            Score score;
+            format_manager.importFile(score, src, *input_format);
+            format_manager.exportFile(score, outputs[i], *output_format);
+        });
+    }
+
+    int result = EXIT_SUCCESS;
+    for (int i = 0; i < num_files; ++i)
+    {
+        if (conflicts[i] >= 0)
+        {
+            std::cerr << "Failed to export " << files[i].toStdString()
+                      << ": " << outputs[i].u8string()
+                      << " is already the output for "
+                      << files[conflicts[i]].toStdString() << std::endl;
+            result = EXIT_FAILURE;
+            continue;
+        }
+
+        try
+        {
+            tasks[i].get();
+            std::cout << "Exported " << files[i].toStdString() << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Failed to export " << files[i].toStdString() << ": "
+                      << e.what() << std::endl;
+            result = EXIT_FAILURE;
+        }
+    }
+
+    return result;
+}
+
 int main(int argc, char *argv[])
 {
     // Register handlers for unhandled exceptions and segmentation faults.
     std::set_terminate(terminateHandler);
     std::signal(SIGSEGV, signalHandler);
 
+    // Exporting doesn't require a display, so use the offscreen platform
+    // unless a different one was requested.
+    if (isExportOnly(argc, argv) &&
+        !qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     Application a(argc, argv);
+    loadFonts();
 
     // Set the app information (used by e.g. QSettings).
     QCoreApplication::setOrganizationName(AppInfo::ORGANIZATION_NAME);
@@ -196,6 +348,9 @@ int main(int argc, char *argv[])
 
     // Parse command line arguments.
     QStringList files_to_open;
+    QString trace_file;
+    QString export_format;
+    QString output_dir;
     {
         QCommandLineParser parser;
         parser.setApplicationDescription(QCoreApplication::translate(
@@ -207,22 +362,60 @@ int main(int argc, char *argv[])
             QCoreApplication::translate("PowerTabEditor",
                                         "The files to be opened"),
             QStringLiteral("[files...]"));
+
+        QCommandLineOption trace_option(
+            QStringLiteral("trace"),
+            QCoreApplication::translate(
+                "PowerTabEditor",
+                "Record a performance trace (Chrome trace event format) to "
+                "<file> when the program exits."),
+            QStringLiteral("file"));
+        parser.addOption(trace_option);
+
+        QCommandLineOption export_option(
+            QStringLiteral("export"),
+            QCoreApplication::translate(
+                "PowerTabEditor",
+                "Convert the files to the given format (e.g. pdf, svg, png, "
+                "mid or pt2) and exit, without opening a window."),
+            QStringLiteral("format"));
+        parser.addOption(export_option);
+
+        QCommandLineOption output_dir_option(
+            QStringLiteral("output-dir"),
+            QCoreApplication::translate(
+                "PowerTabEditor",
+                "The directory for files written by --export. By default, "
+                "each file is written alongside the original file."),
+            QStringLiteral("directory"));
+        parser.addOption(output_dir_option);
+
         parser.process(a);
 
         files_to_open = parser.positionalArguments();
+        trace_file = parser.value(trace_option);
+        export_format = parser.value(export_option);
+        output_dir = parser.value(output_dir_option);
     }
 
-    {
-        SettingsManager settings_manager;
-        settings_manager.load(Paths::getConfigDir());
+    SettingsManager settings_manager;
+    settings_manager.load(Paths::getConfigDir());
 
+    {
         auto settings = settings_manager.getReadHandle();
         bool single_window_mode = !settings->get(Settings::OpenFilesInNewWindow);
 
+        if (trace_file.isEmpty())
+        {
+            trace_file =
+                QString::fromStdString(settings->get(Settings::TraceFile));
+        }
+
         // If an instance of the program is already running and we're in
         // single-window mode, tell the running instance to open the files in
         // new tabs.
-        if (!files_to_open.empty() && single_window_mode)
+        if (!files_to_open.empty() && single_window_mode &&
+            export_format.isEmpty())
         {
             QLocalSocket socket;
             socket.connectToServer(AppInfo::APPLICATION_ID,
@@ -241,6 +434,20 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (!trace_file.isEmpty())
+    {
+        Util::Tracing::setThreadName("Main");
+        Util::Tracing::start();
+    }
+
+    if (!export_format.isEmpty())
+    {
+        const int result = exportFiles(settings_manager, files_to_open,
+                                       export_format, output_dir);
+        writeTrace(trace_file);
+        return result;
+    }
+
     // Otherwise, launch a new window.
     PowerTabEditor program;
 
@@ -269,7 +476,11 @@ int main(int argc, char *argv[])
 
     // Launch the application.
     program.show();
+    program.recoverAutosavedFiles();
     program.openFiles(files_to_open);
 
-    return a.exec();
+    const int result = a.exec();
+    writeTrace(trace_file);
+
+    return result;
 }
@@ -22,30 +22,17 @@
 
 GoToBarlineDialog::GoToBarlineDialog(QWidget *parent, const Score &score)
     : QDialog(parent),
-      ui(new Ui::GoToBarlineDialog)
+      ui(new Ui::GoToBarlineDialog),
+      myScore(score)
 {
     ui->setupUi(this);
 
     connect(ui->buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
     connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
 
-    for (int system_index = 0;
-         system_index < static_cast<int>(score.getSystems().size());
-         ++system_index)
-    {
-        const System &system = score.getSystems()[system_index];
-        // Index all barlines except for the end bar.
-        for (int i = 0; i < static_cast<int>(system.getBarlines().size()) - 1;
-             ++i)
-        {
-            myLocations.push_back(ConstScoreLocation(
-                score, system_index, 0, system.getBarlines()[i].getPosition()));
-        }
-    }
-
     ui->barlineSpinBox->setValue(1);
     ui->barlineSpinBox->setMinimum(1);
-    ui->barlineSpinBox->setMaximum(static_cast<int>(myLocations.size()));
+    ui->barlineSpinBox->setMaximum(score.getBarIndex().getBarCount());
 
     ui->barlineSpinBox->selectAll();
 }
@@ -58,6 +45,11 @@ GoToBarlineDialog::~GoToBarlineDialog()
 /// Returns the location of the selected barline.
 ConstScoreLocation GoToBarlineDialog::getLocation() const
 {
-    const int index = ui->barlineSpinBox->value();
-    return myLocations.at(index - 1);
+    const auto [system_index, barline_index] =
+        myScore.getBarIndex().findBar(ui->barlineSpinBox->value());
+    const System &system = myScore.getSystems()[system_index];
+
+    return ConstScoreLocation(
+        myScore, system_index, 0,
+        system.getBarlines()[barline_index].getPosition());
 }
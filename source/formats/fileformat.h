@@ -56,6 +56,9 @@ public:
     virtual ~FileFormatImporter();
 
     /// Imports the file into the given score.
+    /// Importers record the "Import::decode" (e.g. decompressing the file),
+    /// "Import::parse" and "Import::convert" (to a Score) phases as trace
+    /// spans, which are summarized by the import benchmark.
     /// @throw FileFormatException
     virtual void load(const std::filesystem::path &filename,
                       Score &score) = 0;
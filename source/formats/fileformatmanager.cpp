@@ -24,6 +24,8 @@
 #include <formats/powertab/powertabexporter.h>
 #include <formats/powertab/powertabimporter.h>
 #include <formats/powertab_old/powertaboldimporter.h>
+#include <formats/wav/wavexporter.h>
+#include <util/tracing.h>
 
 FileFormatManager::FileFormatManager(const SettingsManager &settings_manager)
 {
@@ -35,6 +37,7 @@ FileFormatManager::FileFormatManager(const SettingsManager &settings_manager)
 
     myExporters.emplace_back(new PowerTabExporter());
     myExporters.emplace_back(new MidiExporter(settings_manager));
+    myExporters.emplace_back(new WavExporter(settings_manager));
 }
 
 std::optional<FileFormat> FileFormatManager::findFormat(
@@ -83,6 +86,8 @@ void FileFormatManager::importFile(Score &score,
     {
         if (importer->fileFormat() == format)
         {
+            PTE_TRACE_SCOPE_DETAIL("FileFormatManager::importFile",
+                                   filename.u8string());
             importer->load(filename, score);
             return;
         }
@@ -114,6 +119,8 @@ void FileFormatManager::exportFile(const Score &score,
     {
         if (exporter->fileFormat() == format)
         {
+            PTE_TRACE_SCOPE_DETAIL("FileFormatManager::exportFile",
+                                   filename.u8string());
             exporter->save(filename, score);
             return;
         }
@@ -122,6 +129,12 @@ void FileFormatManager::exportFile(const Score &score,
     throw std::runtime_error("Unknown file format");
 }
 
+void FileFormatManager::addExporter(
+    std::unique_ptr<FileFormatExporter> exporter)
+{
+    myExporters.push_back(std::move(exporter));
+}
+
 bool FileFormatManager::extensionImportSupported(const std::string& extension) const {
     for (auto const& importer : myImporters)
         if (importer->fileFormat().contains(extension)) return true;
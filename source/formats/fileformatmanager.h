@@ -57,6 +57,11 @@ public:
 
     // Checks to see if there is an importer for the designated extension
     bool extensionImportSupported(const std::string& extension) const;
+
+    /// Registers an additional exporter, e.g. for formats which depend on
+    /// other parts of the application such as the score painters.
+    void addExporter(std::unique_ptr<FileFormatExporter> exporter);
+
 private:
     template <typename Importer>
     void registerImporter();
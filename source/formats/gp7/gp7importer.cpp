@@ -30,6 +30,7 @@
 #include <formats/fileformat.h>
 #include <score/score.h>
 #include <util/scopeexit.h>
+#include <util/tracing.h>
 
 Gp7Importer::Gp7Importer()
     : FileFormatImporter(FileFormat("Guitar Pro 7", { "gp" }))
@@ -123,22 +124,33 @@ std::vector<std::byte> loadFileFromZip(unzFile zip_file, const char *name)
 
 void Gp7Importer::load(const std::filesystem::path &filename, Score &score)
 {
-    // The .gp file format is just a zip file with a different extension.
-    UnzFileHandle zip_file = openZipFile(filename);
-
-    // There are a few files, but Content/score.gpif has the main contents in
-    // XML format. This is very similar to the .gpx file format, but with a
-    // different container.
-    std::vector<std::byte> buffer =
-        loadFileFromZip(zip_file.get(), "Content/score.gpif");
-
-    // Parse as an XML file.
-    pugi::xml_document xml_doc;
-    pugi::xml_parse_result result =
-        xml_doc.load_buffer_inplace(buffer.data(), buffer.size());
-    if (!result)
-        throw FileFormatException(result.description());
-
-    Gp7::Document doc = Gp7::parse(xml_doc, Gp7::Version::V7);
+    std::vector<std::byte> buffer;
+    {
+        PTE_TRACE_SCOPE("Import::decode");
+
+        // The .gp file format is just a zip file with a different extension.
+        UnzFileHandle zip_file = openZipFile(filename);
+
+        // There are a few files, but Content/score.gpif has the main contents
+        // in XML format. This is very similar to the .gpx file format, but
+        // with a different container.
+        buffer = loadFileFromZip(zip_file.get(), "Content/score.gpif");
+    }
+
+    Gp7::Document doc;
+    {
+        PTE_TRACE_SCOPE("Import::parse");
+
+        // Parse as an XML file.
+        pugi::xml_document xml_doc;
+        pugi::xml_parse_result result =
+            xml_doc.load_buffer_inplace(buffer.data(), buffer.size());
+        if (!result)
+            throw FileFormatException(result.description());
+
+        doc = Gp7::parse(xml_doc, Gp7::Version::V7);
+    }
+
+    PTE_TRACE_SCOPE("Import::convert");
     Gp7::convert(doc, score);
 }
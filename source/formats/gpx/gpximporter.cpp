@@ -22,6 +22,7 @@
 #include <formats/gp7/parser.h>
 #include <formats/gp7/converter.h>
 #include <score/score.h>
+#include <util/tracing.h>
 
 #include <fstream>
 #include <iostream>
@@ -36,23 +37,34 @@ void
 GpxImporter::load(const std::filesystem::path &filename, Score &score)
 {
     // Load the data, decompress, and open as XML document.
-    std::ifstream file(filename, std::ios::binary | std::ios::in);
-    Gpx::FileSystem fs(file);
+    std::vector<std::byte> buffer;
+    {
+        PTE_TRACE_SCOPE("Import::decode");
 
-    std::vector<std::byte> buffer = fs.getFileContents("score.gpif");
+        std::ifstream file(filename, std::ios::binary | std::ios::in);
+        Gpx::FileSystem fs(file);
+        buffer = fs.getFileContents("score.gpif");
+    }
 
-    // Parse as an XML file.
-    pugi::xml_document xml_doc;
-    pugi::xml_parse_result result =
-        xml_doc.load_buffer_inplace(buffer.data(), buffer.size());
-    if (!result)
-        throw FileFormatException(result.description());
+    Gp7::Document doc;
+    {
+        PTE_TRACE_SCOPE("Import::parse");
 
-    // Enable this to print out the contents for debugging.
+        // Parse as an XML file.
+        pugi::xml_document xml_doc;
+        pugi::xml_parse_result result =
+            xml_doc.load_buffer_inplace(buffer.data(), buffer.size());
+        if (!result)
+            throw FileFormatException(result.description());
+
+        // Enable this to print out the contents for debugging.
 #if 0
-    xml_doc.print(std::cerr);
+        xml_doc.print(std::cerr);
 #endif
 
-    Gp7::Document doc = Gp7::parse(xml_doc, Gp7::Version::V6);
+        doc = Gp7::parse(xml_doc, Gp7::Version::V6);
+    }
+
+    PTE_TRACE_SCOPE("Import::convert");
     Gp7::convert(doc, score);
 }
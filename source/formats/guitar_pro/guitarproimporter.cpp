@@ -23,6 +23,7 @@
 #include <formats/guitar_pro/document.h>
 #include <formats/guitar_pro/inputstream.h>
 #include <fstream>
+#include <util/tracing.h>
 
 GuitarProImporter::GuitarProImporter()
     : FileFormatImporter(
@@ -33,11 +34,18 @@ GuitarProImporter::GuitarProImporter()
 void
 GuitarProImporter::load(const std::filesystem::path &filename, Score &score)
 {
-    std::ifstream in(filename, std::ios::binary | std::ios::in);
-    Gp::InputStream stream(in);
-
+    // The file is read directly from disk, so there is no separate decoding
+    // step.
     Gp::Document document;
-    document.load(stream);
+    {
+        PTE_TRACE_SCOPE("Import::parse");
+
+        std::ifstream in(filename, std::ios::binary | std::ios::in);
+        Gp::InputStream stream(in);
+        document.load(stream);
+    }
+
+    PTE_TRACE_SCOPE("Import::convert");
 
     // Convert to the GP7 intermediate format, which then can be converted to
     // our score format.
@@ -19,11 +19,16 @@
 
 #include "common.h"
 
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/stream.hpp>
 #include <fstream>
 #include <score/score.h>
 #include <score/serialization.h>
+#include <util/tracing.h>
 
 PowerTabImporter::PowerTabImporter()
     : FileFormatImporter(getPowerTabFileFormat())
@@ -35,11 +40,23 @@ void PowerTabImporter::load(const std::filesystem::path &filename,
 {
     // The files are compressed by gzip, so we need to uncompress them before
     // loading the data.
-    std::ifstream file(filename, std::ios::in | std::ios::binary);
-    boost::iostreams::filtering_istreambuf in;
-    in.push(boost::iostreams::gzip_decompressor());
-    in.push(file);
+    std::string contents;
+    {
+        PTE_TRACE_SCOPE("Import::decode");
 
-    std::istream compressed_input(&in);
-    ScoreUtils::load(compressed_input, "score", score);
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        boost::iostreams::filtering_istreambuf in;
+        in.push(boost::iostreams::gzip_decompressor());
+        in.push(file);
+
+        boost::iostreams::copy(in, boost::iostreams::back_inserter(contents));
+    }
+
+    // The JSON document is parsed and converted to the score in a single step.
+    // The decompressed data is read in place rather than being copied into a
+    // string stream.
+    PTE_TRACE_SCOPE("Import::parse");
+    boost::iostreams::stream<boost::iostreams::array_source> input(
+        contents.data(), contents.size());
+    ScoreUtils::load(input, "score", score);
 }
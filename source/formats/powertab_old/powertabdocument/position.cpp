@@ -52,15 +52,6 @@ Position::Position() :
     ComplexSymbols::clearComplexSymbols(m_complexSymbolArray);
 }
 
-/// Destructor
-Position::~Position()
-{
-    for (auto &note : m_noteArray)
-    {
-        delete note;
-    }
-}
-
 // Serialization Functions
 /// Performs serialization for the class
 /// @param stream Power Tab output stream to serialize to
@@ -16,6 +16,7 @@
 #include "macros.h"
 
 #include <array>
+#include <memory>
 #include <vector>
 
 namespace PowerTabDocument {
@@ -153,11 +154,12 @@ private:
     std::array<uint32_t, MAX_POSITION_COMPLEX_SYMBOLS> m_complexSymbolArray; ///< Array of complex symbols
 
 public:
-    std::vector<Note*> m_noteArray;      ///< Array of notes
+    typedef std::shared_ptr<Note> NotePtr;
+
+    std::vector<NotePtr> m_noteArray;      ///< Array of notes
 
 public:
     Position();
-    ~Position();
 
     // Serialization Functions
     bool Serialize(PowerTabOutputStream &stream) const override;
@@ -358,7 +360,7 @@ public:
     Note* GetNote(size_t index) const
     {
         PTB_CHECK_THAT(IsValidNoteIndex(index), nullptr);
-        return (m_noteArray[index]);
+        return (m_noteArray[index].get());
     }
 };
 
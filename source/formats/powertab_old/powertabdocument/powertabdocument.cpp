@@ -220,7 +220,7 @@ void Document::Load(const std::filesystem::path& fileName)
 {
     std::ifstream fileStream(fileName,
                              std::ifstream::in | std::ifstream::binary);
-    PowerTabInputStream stream(fileStream);
+    PowerTabInputStream stream(fileStream, &m_objectArena);
 
     DeleteContents();
 
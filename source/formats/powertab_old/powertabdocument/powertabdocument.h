@@ -17,6 +17,7 @@
 
 #include <array>
 #include <filesystem>
+#include <util/arena.h>
 #include <vector>
 
 namespace PowerTabDocument {
@@ -52,6 +53,10 @@ public:
 
     // Member Variables
 private:
+    /// The objects read from a file are allocated from this arena, since they
+    /// are typically only used while importing the file. This must be declared
+    /// first, so that it is destroyed after the objects.
+    Util::Arena         m_objectArena;
     PowerTabFileHeader  m_header;                                   ///< The one and only header (contains file information)
     std::vector<Score*> m_scoreArray;                               ///< List of scores (zeroth element = guitar score, first element = bass score)
 
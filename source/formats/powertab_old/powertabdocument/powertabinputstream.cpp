@@ -18,8 +18,9 @@ namespace PowerTabDocument {
 
 using std::string;
 
-PowerTabInputStream::PowerTabInputStream(std::istream& stream) :
-    m_stream(stream)
+PowerTabInputStream::PowerTabInputStream(std::istream& stream,
+                                         Util::Arena* arena) :
+    m_stream(stream), m_arena(arena)
 {
     // ensure that the stream will throw std::ifstream::failure if any errors occur
     stream.exceptions(std::istream::failbit | std::istream::badbit | std::istream::eofbit);
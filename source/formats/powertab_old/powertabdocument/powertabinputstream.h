@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <istream>
 #include <memory>
+#include <util/arena.h>
 #include <vector>
 
 namespace PowerTabDocument {
@@ -29,9 +30,12 @@ class PowerTabInputStream
     // Member Variables
 private:
     std::istream& m_stream;
+    Util::Arena* m_arena;   ///< Optional arena for the deserialized objects
 
 public:
-    PowerTabInputStream(std::istream& stream);
+    /// If an arena is provided, the objects that are read from the stream are
+    /// allocated from it, and must not outlive it.
+    PowerTabInputStream(std::istream& stream, Util::Arena* arena = nullptr);
 
     // Read Functions
     uint32_t ReadCount();
@@ -91,21 +95,15 @@ public:
     }
 
 private:
-    template <class T>
-    inline void ReadObject(std::vector<T*>& vect, uint16_t version)
-    {
-        std::unique_ptr<T> object(new T());
-        object->Deserialize(*this, version);
-        vect.push_back(object.release());
-    }
-
     template <class T>
     inline void ReadObject(std::vector<std::shared_ptr<T> >& vect,
                            uint16_t version)
     {
-        std::shared_ptr<T> object(std::make_shared<T>());
+        std::shared_ptr<T> object =
+            m_arena ? std::allocate_shared<T>(Util::ArenaAllocator<T>(*m_arena))
+                    : std::make_shared<T>();
         object->Deserialize(*this, version);
-        vect.push_back(object);
+        vect.push_back(std::move(object));
     }
 };
 
@@ -66,18 +66,6 @@ Staff::Staff(uint8_t tablatureStaffType, uint8_t clef) :
     SetTablatureStaffType(tablatureStaffType);
 }
 
-Staff::~Staff()
-{
-    for (size_t i = 0; i < positionArrays.size(); i++)
-    {
-        std::vector<Position*>& positionArray = positionArrays[i];
-        for (size_t j = 0; j < positionArray.size(); j++)
-        {
-            delete positionArray[j];
-        }
-    }
-}
-
 // Serialize Functions
 /// Performs serialization for the class
 /// @param stream Power Tab output stream to serialize to
@@ -177,10 +165,10 @@ bool Staff::IsValidTablatureStaffType(uint8_t type) const
 
     for (size_t i = 0; i < positionArrays.size(); ++i)
     {
-        const std::vector<Position*>& voice = positionArrays[i];
+        const std::vector<PositionPtr>& voice = positionArrays[i];
         for (size_t j = 0; j < voice.size(); ++j)
         {
-            const Position* pos = voice.at(j);
+            const Position* pos = voice.at(j).get();
             for (size_t m = 0; m < pos->GetNoteCount(); ++m)
             {
                 const Note* note = pos->GetNote(m);
@@ -240,7 +228,7 @@ Position* Staff::GetPosition(size_t voice, size_t index) const
     if (!IsValidVoice(voice))
         throw std::out_of_range("Invalid voice");
 
-    return positionArrays[voice].at(index);
+    return positionArrays[voice].at(index).get();
 }
 
 /// Returns whether or not the staff is visible
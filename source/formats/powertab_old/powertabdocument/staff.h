@@ -14,6 +14,7 @@
 
 #include <array>
 #include "powertabobject.h"
+#include <memory>
 #include <vector>
 
 namespace PowerTabDocument {
@@ -64,13 +65,14 @@ private:
     bool m_isShown;
 
 public:
-    std::array<std::vector<Position*>, NUM_STAFF_VOICES> positionArrays; ///< collection of position arrays, one per voice
+    typedef std::shared_ptr<Position> PositionPtr;
+
+    std::array<std::vector<PositionPtr>, NUM_STAFF_VOICES> positionArrays; ///< collection of position arrays, one per voice
 
     // Constructor/Destructor
 public:
     Staff();
     Staff(uint8_t tablatureStaffType, uint8_t clef);
-    ~Staff();
 
     // Serialize Functions
     bool Serialize(PowerTabOutputStream &stream) const override;
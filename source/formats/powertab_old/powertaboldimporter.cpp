@@ -37,6 +37,7 @@
 #include <score/systemlocation.h>
 #include <score/utils/scoremerger.h>
 #include <score/utils/scorepolisher.h>
+#include <util/tracing.h>
 
 #include <cmath>
 
@@ -48,8 +49,15 @@ PowerTabOldImporter::PowerTabOldImporter()
 void PowerTabOldImporter::load(const std::filesystem::path &filename,
                                Score &score)
 {
+    // The document's objects are only needed during the conversion, and are
+    // released all at once when the document goes out of scope.
     PowerTabDocument::Document document;
-    document.Load(filename);
+    {
+        PTE_TRACE_SCOPE("Import::parse");
+        document.Load(filename);
+    }
+
+    PTE_TRACE_SCOPE("Import::convert");
 
     // TODO - handle font settings, etc.
     ScoreInfo info;
@@ -0,0 +1,154 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "wavexporter.h"
+
+#include <app/settingsmanager.h>
+#include <audio/settings.h>
+#include <midi/midifile.h>
+#include <midi/offlinerenderer.h>
+#include <midi/soundfont.h>
+#include <score/generalmidi.h>
+#include <score/score.h>
+#include <util/threadpool.h>
+
+#include <algorithm>
+#include <boost/endian/conversion.hpp>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+static const int theSampleRate = 44100;
+static const int theNumChannels = 2;
+static const int theBitsPerSample = 16;
+/// The RIFF chunk size is a 32-bit value which also includes the 36 bytes of
+/// the header after it, which limits the size of the audio data.
+static const int64_t theMaxDataLength =
+    std::numeric_limits<uint32_t>::max() - 36;
+
+/// Returns the pool used for rendering the channels. This is shared between
+/// exports, so that a pool of threads isn't started for each file.
+static Util::ThreadPool &getRenderPool()
+{
+    static Util::ThreadPool pool;
+    return pool;
+}
+
+template <typename T>
+static void write(std::ostream &os, T val)
+{
+    val = boost::endian::native_to_little(val);
+    os.write(reinterpret_cast<const char *>(&val), sizeof(T));
+}
+
+WavExporter::WavExporter(const SettingsManager &settings_manager)
+    : FileFormatExporter(FileFormat("WAV Audio", { "wav" })),
+      mySettingsManager(settings_manager)
+{
+}
+
+void WavExporter::save(const std::filesystem::path &filename, const Score &score)
+{
+    MidiFile::LoadOptions options;
+    options.myEnableMetronome = false;
+    options.myRecordPositionChanges = false;
+    std::string soundfont_path;
+    {
+        auto settings = mySettingsManager.getReadHandle();
+        options.myMetronomePreset = settings->get(Settings::MetronomePreset) +
+                                    Midi::MIDI_PERCUSSION_PRESET_OFFSET;
+        options.myStrongAccentVel =
+            settings->get(Settings::MetronomeStrongAccent);
+        options.myWeakAccentVel = settings->get(Settings::MetronomeWeakAccent);
+        options.myVibratoStrength = settings->get(Settings::MidiVibratoLevel);
+        options.myWideVibratoStrength =
+            settings->get(Settings::MidiWideVibratoLevel);
+        soundfont_path = settings->get(Settings::SoundFontPath);
+    }
+
+    std::unique_ptr<SoundFont> soundfont;
+    if (!soundfont_path.empty())
+        soundfont = std::make_unique<SoundFont>(soundfont_path);
+
+    MidiFile file;
+    file.load(score, options);
+
+    std::ofstream os(filename, std::ios::out | std::ios::binary);
+    os.exceptions(std::ios::failbit | std::ios::badbit | std::ios::eofbit);
+
+    // The chunk sizes are filled in after rendering.
+    os << "RIFF";
+    write(os, static_cast<uint32_t>(0));
+    os << "WAVE";
+
+    os << "fmt ";
+    write(os, static_cast<uint32_t>(16));
+    // PCM format.
+    write(os, static_cast<uint16_t>(1));
+    write(os, static_cast<uint16_t>(theNumChannels));
+    write(os, static_cast<uint32_t>(theSampleRate));
+    const int block_align = theNumChannels * theBitsPerSample / 8;
+    write(os, static_cast<uint32_t>(theSampleRate * block_align));
+    write(os, static_cast<uint16_t>(block_align));
+    write(os, static_cast<uint16_t>(theBitsPerSample));
+
+    os << "data";
+    const std::iostream::pos_type data_len_pos = os.tellp();
+    write(os, static_cast<uint32_t>(0));
+
+    std::vector<int16_t> pcm;
+    OfflineRenderer renderer(theSampleRate, soundfont.get());
+
+    // Apply each player's volume and pan from the mixer, as during playback.
+    for (int i = 0, n = static_cast<int>(score.getPlayers().size()); i < n; ++i)
+    {
+        const Player &player = score.getPlayers()[i];
+        renderer.setPlayerMix(i, player.getMaxVolume(), player.getPan());
+    }
+
+    int64_t data_len = 0;
+    renderer.render(file, [&](const float *samples, int frames) {
+        // Stop before the data length overflows, rather than writing a
+        // corrupt header.
+        data_len += static_cast<int64_t>(frames) * block_align;
+        if (data_len > theMaxDataLength)
+        {
+            throw FileFormatException(
+                "The score is too long to be exported as a WAV file.");
+        }
+
+        pcm.resize(theNumChannels * frames);
+        for (size_t i = 0; i < pcm.size(); ++i)
+        {
+            const float value = std::clamp(samples[i], -1.0f, 1.0f);
+            pcm[i] = boost::endian::native_to_little(
+                static_cast<int16_t>(std::lround(value * 32767)));
+        }
+
+        os.write(reinterpret_cast<const char *>(pcm.data()),
+                 pcm.size() * sizeof(int16_t));
+    }, getRenderPool());
+
+    os.seekp(data_len_pos);
+    write(os, static_cast<uint32_t>(data_len));
+    os.seekp(4);
+    // The size of the RIFF chunk excludes the "RIFF" id and the size itself.
+    write(os, static_cast<uint32_t>(data_len + 36));
+}
@@ -28,6 +28,7 @@
 #include <score/systemlocation.h>
 #include <score/utils.h>
 #include <score/voiceutils.h>
+#include <util/tracing.h>
 
 static const int PERCUSSION_CHANNEL = 9;
 static const int METRONOME_CHANNEL = PERCUSSION_CHANNEL;
@@ -150,7 +151,10 @@ MidiFile::MidiFile() : myTicksPerBeat(0)
 
 void MidiFile::load(const Score &score, const LoadOptions &options)
 {
+    PTE_TRACE_SCOPE("MidiFile::load");
+
     myTicksPerBeat = DEFAULT_PPQ;
+    myTimeline = PlaybackTimeline(myTicksPerBeat);
 
     RepeatController repeat_controller(score);
 
@@ -190,6 +194,10 @@ void MidiFile::load(const Score &score, const LoadOptions &options)
         }
 
         const int start_tick = current_tick;
+        myTimeline.beginBar(
+            SystemLocation(location.getSystem(), current_bar.getPosition()),
+            next_bar.getPosition(), start_tick);
+
         current_tempo =
             addTempoEvent(master_track, start_tick, current_tempo, score,
                           location, repeat_controller,
@@ -226,11 +234,20 @@ void MidiFile::load(const Score &score, const LoadOptions &options)
                                   current_bar, next_bar, location, options));
         }
 
+        myTimeline.endBar(current_tick);
+
         location = moveToNextBar(
             metronome_track, current_tick, options.myRecordPositionChanges,
             system, location, next_bar.getPosition(), repeat_controller);
     }
 
+    for (const MidiEvent &event : master_track)
+    {
+        if (event.isTempoChange())
+            myTimeline.addTempoChange(event.getTicks(), event.getTempo());
+    }
+    myTimeline.finish();
+
     myTracks.push_back(master_track);
     myTracks.insert(myTracks.end(), regular_tracks.begin(), regular_tracks.end());
     if (options.myEnableMetronome)
@@ -917,6 +934,7 @@ MidiFile::addEventsForBar(std::vector<MidiEventList> &tracks,
             continue;
 
         const SystemLocation system_location(system_index, position);
+        myTimeline.addPosition(system_location, current_tick);
         int duration = getDurationTicks(voice, *pos, myTicksPerBeat);
 
         if (pos->isRest())
@@ -19,6 +19,7 @@
 #define MIDI_MIDIFILE_H
 
 #include <midi/midieventlist.h>
+#include <midi/playbacktimeline.h>
 
 #include <cstdint>
 #include <vector>
@@ -66,6 +67,9 @@ public:
     int getTicksPerBeat() const { return myTicksPerBeat; }
     std::vector<MidiEventList> &getTracks() { return myTracks; }
     const std::vector<MidiEventList> &getTracks() const { return myTracks; }
+    /// Returns the playback order and timing of the score that was loaded
+    /// with load().
+    const PlaybackTimeline &getTimeline() const { return myTimeline; }
 
 private:
     int generateMetronome(MidiEventList &event_list, int current_tick,
@@ -90,6 +94,7 @@ private:
 
     int myTicksPerBeat;
     std::vector<MidiEventList> myTracks;
+    PlaybackTimeline myTimeline;
 };
 
 #endif
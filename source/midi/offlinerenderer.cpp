@@ -0,0 +1,726 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "offlinerenderer.h"
+
+#include <midi/midifile.h>
+#include <midi/soundfont.h>
+#include <util/threadpool.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <exception>
+#include <future>
+#include <vector>
+
+namespace
+{
+constexpr int NUM_CHANNELS = 16;
+constexpr int PERCUSSION_CHANNEL = 9;
+constexpr int PERCUSSION_BANK = 128;
+
+/// Number of frames in each block that is passed to the output callback.
+constexpr int BLOCK_SIZE = 8192;
+/// Pitch, volume and pan changes are applied at this interval (in frames).
+constexpr int CONTROL_INTERVAL = 64;
+/// Limit on how long notes can ring after the last event.
+constexpr double MAX_TAIL_SECONDS = 5.0;
+/// Limit on the number of simultaneous voices per channel.
+constexpr size_t MAX_VOICES = 64;
+/// Level (about -80dB) at which a voice is considered to be inaudible.
+constexpr float SILENT_LEVEL = 1e-4f;
+
+/// Maximum depth of the vibrato from the modulation wheel, in semitones.
+constexpr float MAX_VIBRATO_DEPTH = 0.5f;
+constexpr float VIBRATO_RATE = 5.5f;
+
+constexpr double PI = 3.14159265358979323846;
+
+enum Controller : uint8_t
+{
+    ModWheel = 0x01,
+    DataEntryCoarse = 0x06,
+    ChannelVolume = 0x07,
+    Pan = 0x0a,
+    Expression = 0x0b,
+    HoldPedal = 0x40,
+    RpnLsb = 0x64,
+    RpnMsb = 0x65,
+    AllNotesOff = 0x7b
+};
+
+struct ChannelEvent
+{
+    int64_t myFrame;
+    uint8_t myStatus;
+    uint8_t myData1;
+    uint8_t myData2;
+};
+
+/// Instruments that are used when a SoundFont is not available: a plucked
+/// tone that decays over a few seconds, and a short noise burst for
+/// percussion.
+struct BuiltinInstruments
+{
+    BuiltinInstruments();
+
+    std::vector<int16_t> mySamples;
+    SoundFont::Region myTone;
+    SoundFont::Region myDrum;
+};
+
+BuiltinInstruments::BuiltinInstruments()
+{
+    // A single cycle of a waveform with a few harmonics, which is looped.
+    const int cycle_length = 2048;
+    for (int i = 0; i < cycle_length; ++i)
+    {
+        const double phase = 2 * PI * i / cycle_length;
+        double value = 0;
+        for (int harmonic = 1; harmonic <= 8; ++harmonic)
+            value += std::sin(harmonic * phase) / (harmonic * harmonic);
+
+        mySamples.push_back(static_cast<int16_t>(value * 8000));
+    }
+
+    myTone.myStart = 0;
+    myTone.myEnd = cycle_length;
+    myTone.myLoopStart = 0;
+    myTone.myLoopEnd = cycle_length;
+    myTone.myLoop = true;
+    // Play the cycle at 440Hz for A4.
+    myTone.mySampleRate = cycle_length * 440;
+    myTone.myRootKey = 69;
+    myTone.myAttack = 0.002f;
+    myTone.myDecay = 3.0f;
+    myTone.mySustain = 1000;
+    myTone.myRelease = 0.15f;
+
+    // Half a second of white noise, using a fixed seed so that the output is
+    // deterministic.
+    const int noise_length = 22050;
+    uint32_t seed = 12345;
+    for (int i = 0; i < noise_length; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        mySamples.push_back(static_cast<int16_t>((seed >> 16) % 16000 - 8000));
+    }
+
+    myDrum.myStart = cycle_length;
+    myDrum.myEnd = cycle_length + noise_length;
+    myDrum.mySampleRate = 44100;
+    myDrum.myRootKey = 60;
+    myDrum.myDecay = 0.25f;
+    myDrum.mySustain = 1000;
+    myDrum.myRelease = 0.05f;
+}
+
+/// The delay, attack, hold, decay, sustain, release volume envelope.
+/// The decay and release stages are linear in decibels, as in the SoundFont
+/// specification.
+class Envelope
+{
+public:
+    Envelope(const SoundFont::Region &region, int sample_rate)
+        : myRemaining(toFrames(region.myDelay, sample_rate)),
+          myAttackFrames(toFrames(region.myAttack, sample_rate)),
+          myHoldFrames(toFrames(region.myHold, sample_rate)),
+          myDecayFactor(getDecayFactor(region.myDecay, sample_rate)),
+          mySustainLevel(std::pow(10.0f, -region.mySustain / 200.0f)),
+          myReleaseFactor(getDecayFactor(region.myRelease, sample_rate))
+    {
+    }
+
+    float next()
+    {
+        if (myStage == Stage::Delay)
+        {
+            if (myRemaining > 0)
+            {
+                --myRemaining;
+                return 0;
+            }
+
+            myStage = Stage::Attack;
+            myRemaining = myAttackFrames;
+        }
+
+        if (myStage == Stage::Attack)
+        {
+            if (myRemaining > 0)
+            {
+                --myRemaining;
+                myLevel += 1.0f / myAttackFrames;
+                return myLevel;
+            }
+
+            myStage = Stage::Hold;
+            myLevel = 1;
+            myRemaining = myHoldFrames;
+        }
+
+        if (myStage == Stage::Hold)
+        {
+            if (myRemaining > 0)
+            {
+                --myRemaining;
+                return myLevel;
+            }
+
+            myStage = Stage::Decay;
+        }
+
+        if (myStage == Stage::Decay)
+        {
+            myLevel *= myDecayFactor;
+            if (myLevel <= mySustainLevel)
+            {
+                myLevel = mySustainLevel;
+                myStage = (myLevel < SILENT_LEVEL) ? Stage::Finished
+                                                   : Stage::Sustain;
+            }
+        }
+        else if (myStage == Stage::Release)
+        {
+            myLevel *= myReleaseFactor;
+            if (myLevel < SILENT_LEVEL)
+                myStage = Stage::Finished;
+        }
+        else if (myStage == Stage::Finished)
+            return 0;
+
+        return myLevel;
+    }
+
+    void release()
+    {
+        if (myStage == Stage::Delay || myLevel < SILENT_LEVEL)
+            myStage = Stage::Finished;
+        else if (myStage != Stage::Finished)
+            myStage = Stage::Release;
+    }
+
+    void stop() { myStage = Stage::Finished; }
+
+    bool isReleased() const
+    {
+        return myStage == Stage::Release || myStage == Stage::Finished;
+    }
+
+    bool isFinished() const { return myStage == Stage::Finished; }
+
+private:
+    enum class Stage
+    {
+        Delay,
+        Attack,
+        Hold,
+        Decay,
+        Sustain,
+        Release,
+        Finished
+    };
+
+    static int toFrames(float seconds, int sample_rate)
+    {
+        return static_cast<int>(seconds * sample_rate);
+    }
+
+    /// Returns the per-frame multiplier that drops the level by 100dB over the
+    /// given duration.
+    static float getDecayFactor(float seconds, int sample_rate)
+    {
+        const float frames = std::max(1.0f, seconds * sample_rate);
+        return std::pow(1e-5f, 1.0f / frames);
+    }
+
+    Stage myStage = Stage::Delay;
+    int myRemaining;
+    int myAttackFrames;
+    int myHoldFrames;
+    float myLevel = 0;
+    float myDecayFactor;
+    float mySustainLevel;
+    float myReleaseFactor;
+};
+
+struct Voice
+{
+    Voice(const SoundFont::Region &region, const int16_t *samples, int key,
+          int velocity, int sample_rate)
+        : myRegion(&region),
+          mySamples(samples),
+          myKey(key),
+          myPosition(region.myStart),
+          myEnvelope(region, sample_rate)
+    {
+        const int cents = (key - region.myRootKey) * 100 + region.myTune;
+        myBaseRate = static_cast<double>(region.mySampleRate) / sample_rate *
+                     std::pow(2.0, cents / 1200.0);
+
+        const float velocity_gain = velocity / 127.0f;
+        myGain = velocity_gain * velocity_gain *
+                 std::pow(10.0f, -region.myAttenuation / 200.0f);
+        myPan = region.myPan / 1000.0f;
+    }
+
+    const SoundFont::Region *myRegion;
+    const int16_t *mySamples;
+    int myKey;
+    double myPosition;
+    double myBaseRate;
+    float myGain;
+    /// Offset from the channel's pan, from -0.5 to 0.5.
+    float myPan;
+    Envelope myEnvelope;
+    /// Whether a note off was received while the hold pedal was down.
+    bool myIsHeld = false;
+};
+
+/// Plays the voices for a single MIDI channel. Each channel is only accessed
+/// by one thread at a time.
+class Channel
+{
+public:
+    Channel(int index, int sample_rate, const SoundFont *soundfont,
+            const BuiltinInstruments &builtin, uint8_t max_volume,
+            uint8_t pan)
+        : myIndex(index),
+          mySampleRate(sample_rate),
+          mySoundFont(soundfont),
+          myBuiltinInstruments(builtin),
+          myMaxVolume(max_volume),
+          myChannelPan(pan)
+    {
+    }
+
+    void addEvent(const ChannelEvent &event) { myEvents.push_back(event); }
+
+    /// Returns whether the channel has any sound to produce before the given
+    /// frame.
+    bool isActive(int64_t end_frame) const
+    {
+        return !myVoices.empty() || (myNextEvent < myEvents.size() &&
+                                     myEvents[myNextEvent].myFrame < end_frame);
+    }
+
+    bool hasVoices() const { return !myVoices.empty(); }
+
+    /// Renders the frames starting at the given frame into the (interleaved
+    /// stereo) output buffer, overwriting its contents.
+    void render(int64_t start_frame, int num_frames, float *output)
+    {
+        std::fill(output, output + 2 * num_frames, 0.0f);
+
+        int offset = 0;
+        while (offset < num_frames)
+        {
+            const int64_t frame = start_frame + offset;
+            while (myNextEvent < myEvents.size() &&
+                   myEvents[myNextEvent].myFrame <= frame)
+            {
+                handleEvent(myEvents[myNextEvent++]);
+            }
+
+            // Render up to the next event, so that it's applied at the
+            // correct time.
+            int64_t length = std::min(CONTROL_INTERVAL, num_frames - offset);
+            if (myNextEvent < myEvents.size())
+                length = std::min(length, myEvents[myNextEvent].myFrame - frame);
+
+            renderVoices(output + 2 * offset, static_cast<int>(length));
+            offset += static_cast<int>(length);
+        }
+    }
+
+private:
+    void handleEvent(const ChannelEvent &event)
+    {
+        switch (event.myStatus & 0xf0)
+        {
+            case MidiEvent::NoteOn:
+                if (event.myData2 > 0)
+                    noteOn(event.myData1, event.myData2);
+                else
+                    noteOff(event.myData1);
+                break;
+
+            case MidiEvent::NoteOff:
+                noteOff(event.myData1);
+                break;
+
+            case MidiEvent::ProgramChange:
+                myProgram = event.myData1;
+                break;
+
+            case MidiEvent::PitchWheel:
+                myPitchBend = ((event.myData2 << 7) | event.myData1) - 8192;
+                break;
+
+            case MidiEvent::ControlChange:
+                handleController(event.myData1, event.myData2);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void handleController(uint8_t controller, uint8_t value)
+    {
+        switch (controller)
+        {
+            case ModWheel:
+                myModulation = value;
+                break;
+            case ChannelVolume:
+                myVolume = value;
+                break;
+            case Pan:
+                myChannelPan = value;
+                break;
+            case Expression:
+                myExpression = value;
+                break;
+            case RpnMsb:
+                myRpn = (value << 7) | (myRpn & 0x7f);
+                break;
+            case RpnLsb:
+                myRpn = (myRpn & ~0x7f) | value;
+                break;
+            case DataEntryCoarse:
+                // RPN 0 is the pitch bend range.
+                if (myRpn == 0)
+                    myPitchBendRange = value;
+                break;
+            case HoldPedal:
+                myIsHoldPedalDown = value >= 64;
+                if (!myIsHoldPedalDown)
+                {
+                    for (Voice &voice : myVoices)
+                    {
+                        if (voice.myIsHeld)
+                            voice.myEnvelope.release();
+                    }
+                }
+                break;
+            case AllNotesOff:
+                for (Voice &voice : myVoices)
+                    voice.myEnvelope.release();
+                break;
+            default:
+                break;
+        }
+    }
+
+    void noteOn(int key, int velocity)
+    {
+        // Restart the note if it is already playing.
+        for (Voice &voice : myVoices)
+        {
+            if (voice.myKey == key)
+                voice.myEnvelope.release();
+        }
+
+        const bool percussion = (myIndex == PERCUSSION_CHANNEL);
+
+        std::vector<const SoundFont::Region *> regions;
+        const int16_t *samples;
+        if (mySoundFont)
+        {
+            regions = mySoundFont->findRegions(percussion ? PERCUSSION_BANK : 0,
+                                               myProgram, key, velocity);
+            samples = mySoundFont->getSamples().data();
+        }
+        else
+        {
+            regions.push_back(percussion ? &myBuiltinInstruments.myDrum
+                                         : &myBuiltinInstruments.myTone);
+            samples = myBuiltinInstruments.mySamples.data();
+        }
+
+        for (const SoundFont::Region *region : regions)
+        {
+            if (myVoices.size() >= MAX_VOICES)
+                myVoices.erase(myVoices.begin());
+
+            myVoices.emplace_back(*region, samples, key, velocity,
+                                  mySampleRate);
+        }
+    }
+
+    void noteOff(int key)
+    {
+        for (Voice &voice : myVoices)
+        {
+            if (voice.myKey != key || voice.myEnvelope.isReleased())
+                continue;
+
+            if (myIsHoldPedalDown)
+                voice.myIsHeld = true;
+            else
+                voice.myEnvelope.release();
+        }
+    }
+
+    void renderVoices(float *output, int num_frames)
+    {
+        if (myVoices.empty())
+            return;
+
+        float semitones = myPitchBend / 8192.0f * myPitchBendRange;
+        if (myModulation > 0)
+        {
+            semitones += MAX_VIBRATO_DEPTH * (myModulation / 127.0f) *
+                         static_cast<float>(std::sin(myVibratoPhase));
+            myVibratoPhase = std::fmod(
+                myVibratoPhase + 2 * PI * VIBRATO_RATE * num_frames /
+                                     mySampleRate,
+                2 * PI);
+        }
+        const double pitch = std::pow(2.0, semitones / 12.0);
+
+        const float volume = (myVolume / 127.0f) * (myMaxVolume / 127.0f) *
+                             (myExpression / 127.0f);
+        const float channel_gain = volume * volume;
+        const float channel_pan = (myChannelPan - 64) / 127.0f + 0.5f;
+
+        for (Voice &voice : myVoices)
+        {
+            const float pan = std::clamp(channel_pan + voice.myPan, 0.0f, 1.0f);
+            const float gain = channel_gain * voice.myGain;
+            renderVoice(voice, output, num_frames, voice.myBaseRate * pitch,
+                        gain * static_cast<float>(std::cos(pan * PI / 2)),
+                        gain * static_cast<float>(std::sin(pan * PI / 2)));
+        }
+
+        myVoices.erase(std::remove_if(myVoices.begin(), myVoices.end(),
+                                      [](const Voice &voice) {
+                                          return voice.myEnvelope.isFinished();
+                                      }),
+                       myVoices.end());
+    }
+
+    static void renderVoice(Voice &voice, float *output, int num_frames,
+                            double rate, float left_gain, float right_gain)
+    {
+        const SoundFont::Region &region = *voice.myRegion;
+        const int16_t *samples = voice.mySamples;
+        const double loop_length = region.myLoopEnd - region.myLoopStart;
+
+        for (int i = 0; i < num_frames; ++i)
+        {
+            // Linear interpolation between the neighbouring samples.
+            const auto index = static_cast<uint32_t>(voice.myPosition);
+            uint32_t next = index + 1;
+            if (region.myLoop && next >= region.myLoopEnd)
+                next = region.myLoopStart;
+
+            const float s0 = samples[index];
+            const float s1 = (next < region.myEnd) ? samples[next] : 0.0f;
+            const float frac = static_cast<float>(voice.myPosition - index);
+            const float value = (s0 + frac * (s1 - s0)) * (1.0f / 32768.0f) *
+                                voice.myEnvelope.next();
+
+            output[2 * i] += value * left_gain;
+            output[2 * i + 1] += value * right_gain;
+
+            voice.myPosition += rate;
+            if (region.myLoop)
+            {
+                while (voice.myPosition >= region.myLoopEnd)
+                    voice.myPosition -= loop_length;
+            }
+            else if (voice.myPosition >= region.myEnd)
+                voice.myEnvelope.stop();
+
+            if (voice.myEnvelope.isFinished())
+                break;
+        }
+    }
+
+    const int myIndex;
+    const int mySampleRate;
+    const SoundFont *mySoundFont;
+    const BuiltinInstruments &myBuiltinInstruments;
+    /// The player's maximum volume, which scales the channel volume.
+    const int myMaxVolume;
+
+    std::vector<ChannelEvent> myEvents;
+    size_t myNextEvent = 0;
+    std::vector<Voice> myVoices;
+
+    int myProgram = 0;
+    int myVolume = 100;
+    int myChannelPan;
+    int myExpression = 127;
+    int myModulation = 0;
+    int myPitchBend = 0;
+    int myPitchBendRange = 2;
+    int myRpn = 0x3fff;
+    bool myIsHoldPedalDown = false;
+    double myVibratoPhase = 0;
+};
+
+/// Adds the source buffer into the destination buffer. This is written as a
+/// simple loop so that the compiler can vectorize it.
+void mix(float *dest, const float *src, int n)
+{
+    for (int i = 0; i < n; ++i)
+        dest[i] += src[i];
+}
+} // namespace
+
+OfflineRenderer::OfflineRenderer(int sample_rate, const SoundFont *soundfont)
+    : mySampleRate(sample_rate), mySoundFont(soundfont)
+{
+}
+
+void OfflineRenderer::setPlayerMix(int player, uint8_t max_volume,
+                                   uint8_t pan)
+{
+    // Players are assigned to channels in the same way as in MidiFile, skipping
+    // over the percussion channel.
+    const int channel = player >= PERCUSSION_CHANNEL ? player + 1 : player;
+    if (channel < 0 || channel >= NUM_CHANNELS)
+        return;
+
+    myChannelMixes[channel].myMaxVolume = std::min<uint8_t>(max_volume, 127);
+    myChannelMixes[channel].myPan = std::min<uint8_t>(pan, 127);
+}
+
+int64_t OfflineRenderer::render(const MidiFile &file,
+                                const OutputCallback &output,
+                                Util::ThreadPool &pool) const
+{
+    if (file.getTicksPerBeat() <= 0)
+        return 0;
+
+    // Merge the tracks into a single list of events with absolute ticks.
+    std::vector<MidiEvent> events;
+    for (const MidiEventList &track : file.getTracks())
+    {
+        MidiEventList absolute_track(track);
+        absolute_track.convertToAbsoluteTicks();
+        events.insert(events.end(), absolute_track.begin(),
+                      absolute_track.end());
+    }
+    std::stable_sort(events.begin(), events.end());
+
+    BuiltinInstruments builtin;
+    std::vector<Channel> channels;
+    channels.reserve(NUM_CHANNELS);
+    for (int i = 0; i < NUM_CHANNELS; ++i)
+    {
+        channels.emplace_back(i, mySampleRate, mySoundFont, builtin,
+                              myChannelMixes[i].myMaxVolume,
+                              myChannelMixes[i].myPan);
+    }
+
+    // Convert the events' ticks to frames, following the tempo changes.
+    Midi::Tempo beat_duration = Midi::BEAT_DURATION_120_BPM;
+    const double frames_per_tick_unit =
+        mySampleRate / 1.0e6 / file.getTicksPerBeat();
+    double frame = 0;
+    int prev_tick = 0;
+    for (const MidiEvent &event : events)
+    {
+        frame += (event.getTicks() - prev_tick) * frames_per_tick_unit *
+                 beat_duration.count();
+        prev_tick = event.getTicks();
+
+        if (event.isTempoChange())
+        {
+            beat_duration = event.getTempo();
+            continue;
+        }
+
+        const std::vector<uint8_t> &data = event.getData();
+        if (event.getStatusByte() >= MidiEvent::SysEx || data.size() < 2)
+            continue;
+
+        channels[event.getChannel()].addEvent(
+            { std::llround(frame), data[0], data[1],
+              static_cast<uint8_t>(data.size() > 2 ? data[2] : 0) });
+    }
+
+    const int64_t last_event_frame = std::llround(frame);
+    const auto max_frame = static_cast<int64_t>(
+        last_event_frame + MAX_TAIL_SECONDS * mySampleRate);
+
+    std::vector<std::vector<float>> buffers(
+        NUM_CHANNELS, std::vector<float>(2 * BLOCK_SIZE));
+    std::vector<float> mixed(2 * BLOCK_SIZE);
+    std::vector<std::future<void>> tasks;
+    std::vector<int> rendered_channels;
+
+    int64_t start_frame = 0;
+    while (start_frame < max_frame)
+    {
+        const bool has_voices =
+            std::any_of(channels.begin(), channels.end(),
+                        [](const Channel &c) { return c.hasVoices(); });
+        if (start_frame > last_event_frame && !has_voices)
+            break;
+
+        const int64_t end_frame = start_frame + BLOCK_SIZE;
+
+        tasks.clear();
+        rendered_channels.clear();
+        for (int i = 0; i < NUM_CHANNELS; ++i)
+        {
+            if (!channels[i].isActive(end_frame))
+                continue;
+
+            Channel &channel = channels[i];
+            float *buffer = buffers[i].data();
+            tasks.push_back(pool.submit([&channel, buffer, start_frame]() {
+                channel.render(start_frame, BLOCK_SIZE, buffer);
+            }));
+            rendered_channels.push_back(i);
+        }
+
+        // Wait for every task before rethrowing an error, since the tasks
+        // write to the buffers.
+        std::exception_ptr error;
+        for (std::future<void> &task : tasks)
+        {
+            try
+            {
+                task.get();
+            }
+            catch (...)
+            {
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+        std::fill(mixed.begin(), mixed.end(), 0.0f);
+        for (int i : rendered_channels)
+            mix(mixed.data(), buffers[i].data(), 2 * BLOCK_SIZE);
+
+        output(mixed.data(), BLOCK_SIZE);
+        start_frame = end_frame;
+    }
+
+    return start_frame;
+}
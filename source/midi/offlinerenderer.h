@@ -0,0 +1,76 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MIDI_OFFLINERENDERER_H
+#define MIDI_OFFLINERENDERER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+
+class MidiFile;
+class SoundFont;
+
+namespace Util
+{
+class ThreadPool;
+}
+
+/// Renders a MidiFile to audio without requiring a MIDI output device.
+/// Notes are played from the samples in a SoundFont, or from a simple
+/// built-in instrument if no SoundFont is provided.
+/// Each MIDI channel is rendered independently, so the channels are processed
+/// in parallel and then mixed together.
+class OfflineRenderer
+{
+public:
+    /// Receives a block of interleaved stereo samples, in the range [-1, 1].
+    using OutputCallback =
+        std::function<void(const float *samples, int num_frames)>;
+
+    explicit OfflineRenderer(int sample_rate = 44100,
+                             const SoundFont *soundfont = nullptr);
+
+    int getSampleRate() const { return mySampleRate; }
+
+    /// Sets the mixer settings for a player's channel, as is done during
+    /// playback. Volume changes are scaled by the player's maximum volume,
+    /// and the player's pan is used for the channel.
+    void setPlayerMix(int player, uint8_t max_volume, uint8_t pan);
+
+    /// Renders the file, passing each block of audio to the callback.
+    /// Rendering continues after the last event until all notes have been
+    /// released.
+    /// @param pool The thread pool used to render the channels in parallel.
+    /// @return The total number of frames that were rendered.
+    int64_t render(const MidiFile &file, const OutputCallback &output,
+                   Util::ThreadPool &pool) const;
+
+private:
+    struct ChannelMix
+    {
+        uint8_t myMaxVolume = 127;
+        uint8_t myPan = 64;
+    };
+
+    int mySampleRate;
+    const SoundFont *mySoundFont;
+    /// The mixer settings for each MIDI channel.
+    std::array<ChannelMix, 16> myChannelMixes;
+};
+
+#endif
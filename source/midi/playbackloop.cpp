@@ -0,0 +1,142 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "playbackloop.h"
+
+#include <algorithm>
+#include <map>
+#include <midi/midifile.h>
+#include <set>
+
+/// Returns whether the event stops a note.
+static bool isNoteOff(const MidiEvent &event)
+{
+    const std::vector<uint8_t> &data = event.getData();
+    return (data[0] & 0xf0) == MidiEvent::NoteOff || data[2] == 0;
+}
+
+PlaybackLoop::PlaybackLoop(const MidiFile &file, const SystemLocation &start,
+                           const SystemLocation &end)
+    : myDuration(0)
+{
+    const PlaybackTimeline &timeline = file.getTimeline();
+    const std::vector<PlaybackTimeline::Entry> &entries =
+        timeline.getEntries();
+
+    auto in_range = [&](const PlaybackTimeline::Entry &entry) {
+        return entry.myLocation >= start && entry.myLocation <= end;
+    };
+
+    // Find the first visit to the range, and where playback leaves it.
+    auto first = std::find_if(entries.begin(), entries.end(), in_range);
+    if (first == entries.end())
+        return;
+
+    auto last = std::find_if_not(first, entries.end(), in_range);
+    const int start_tick = first->myTick;
+    const int end_tick = (last != entries.end())
+                             ? last->myTick
+                             : timeline.getBars().back().myEndTick;
+    const Time start_time = timeline.getTime(start_tick);
+    myDuration = timeline.getTime(end_tick) - start_time;
+    if (myDuration.count() <= 0)
+        return;
+
+    // Merge the tracks into a single list of events with absolute ticks.
+    std::vector<MidiEvent> events;
+    for (const MidiEventList &track : file.getTracks())
+    {
+        MidiEventList absolute_track(track);
+        absolute_track.convertToAbsoluteTicks();
+        events.insert(events.end(), absolute_track.begin(),
+                      absolute_track.end());
+    }
+    std::stable_sort(events.begin(), events.end());
+
+    // The latest event of each kind before the loop starts, keyed by the
+    // status byte and controller number. The value records the order in which
+    // the events occurred.
+    std::map<std::pair<uint8_t, uint8_t>, std::pair<size_t, const MidiEvent *>>
+        state;
+    // Notes which were started within the loop, as (channel, pitch) pairs.
+    std::set<std::pair<int, int>> active_notes;
+    SystemLocation last_location = first->myLocation;
+
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        const MidiEvent &event = events[i];
+        if (event.getTicks() >= end_tick)
+            break;
+
+        if (event.getStatusByte() >= MidiEvent::SysEx &&
+            !event.isPositionChange())
+        {
+            continue;
+        }
+
+        if (event.getTicks() < start_tick)
+        {
+            if (event.isNoteOnOff() || event.isPositionChange())
+                continue;
+
+            const std::vector<uint8_t> &data = event.getData();
+            const bool is_controller =
+                (data[0] & 0xf0) == MidiEvent::ControlChange;
+            state[{ data[0], is_controller ? data[1] : uint8_t(0) }] = {
+                i, &event
+            };
+            continue;
+        }
+
+        if (event.isNoteOnOff())
+        {
+            const std::pair<int, int> note(event.getChannel(),
+                                           event.getData()[1]);
+            if (isNoteOff(event))
+            {
+                // Skip the end of notes that started before the loop.
+                if (!active_notes.erase(note))
+                    continue;
+            }
+            else
+                active_notes.insert(note);
+        }
+
+        myEvents.push_back({ timeline.getTime(event.getTicks()) - start_time,
+                             event });
+        if (event.getLocation() > last_location)
+            last_location = event.getLocation();
+    }
+
+    // Stop any notes that ring past the end of the range.
+    for (const std::pair<int, int> &note : active_notes)
+    {
+        myEvents.push_back(
+            { myDuration,
+              MidiEvent::noteOff(end_tick, static_cast<uint8_t>(note.first),
+                                 static_cast<uint8_t>(note.second),
+                                 last_location) });
+    }
+
+    std::vector<std::pair<size_t, const MidiEvent *>> setup_events;
+    for (auto &&entry : state)
+        setup_events.push_back(entry.second);
+    std::sort(setup_events.begin(), setup_events.end());
+
+    for (auto &&entry : setup_events)
+        mySetupEvents.push_back(*entry.second);
+}
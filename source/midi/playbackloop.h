@@ -0,0 +1,75 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MIDI_PLAYBACKLOOP_H
+#define MIDI_PLAYBACKLOOP_H
+
+#include <chrono>
+#include <midi/midievent.h>
+#include <score/systemlocation.h>
+#include <vector>
+
+class MidiFile;
+
+/// The MIDI events for repeatedly playing a range of the score, e.g. to
+/// practice a passage. The events are extracted from the MidiFile once, and
+/// can then be scheduled for any number of iterations without regenerating
+/// them.
+class PlaybackLoop
+{
+public:
+    using Time = std::chrono::microseconds;
+
+    struct Event
+    {
+        /// Offset from the start of the loop, at 100% speed.
+        Time myTime;
+        MidiEvent myEvent;
+    };
+
+    /// Extracts the events for the first time that the locations between
+    /// start and end (inclusive) are played. Notes which are still ringing at
+    /// the end of the range are stopped at the end of the loop.
+    PlaybackLoop(const MidiFile &file, const SystemLocation &start,
+                 const SystemLocation &end);
+
+    /// Returns whether there is nothing to play in the range.
+    bool isEmpty() const { return myDuration.count() <= 0; }
+
+    /// Returns the length of one iteration, at 100% speed.
+    Time getDuration() const { return myDuration; }
+
+    /// Events such as program changes, volume changes and pitch wheels that
+    /// restore each channel's state at the start of the loop. This is the
+    /// most recent event of each kind, and should be sent before each
+    /// iteration.
+    const std::vector<MidiEvent> &getSetupEvents() const
+    {
+        return mySetupEvents;
+    }
+
+    /// The events in the loop, sorted by time. Tempo changes have already
+    /// been applied to the event times.
+    const std::vector<Event> &getEvents() const { return myEvents; }
+
+private:
+    Time myDuration;
+    std::vector<MidiEvent> mySetupEvents;
+    std::vector<Event> myEvents;
+};
+
+#endif
@@ -0,0 +1,233 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "playbacktimeline.h"
+
+#include <algorithm>
+#include <cassert>
+#include <tuple>
+
+PlaybackTimeline::PlaybackTimeline(int ticks_per_beat)
+    : myTicksPerBeat(ticks_per_beat)
+{
+}
+
+void PlaybackTimeline::beginBar(const SystemLocation &location,
+                                int end_position, int start_tick)
+{
+    myBars.push_back(
+        { location, end_position, start_tick, start_tick, Time(0), Time(0) });
+    myBarFirstEntry = myEntries.size();
+}
+
+void PlaybackTimeline::addPosition(const SystemLocation &location, int tick)
+{
+    assert(!myBars.empty());
+    myEntries.push_back(
+        { location, tick, Time(0), static_cast<int>(myBars.size()) - 1 });
+}
+
+void PlaybackTimeline::endBar(int end_tick)
+{
+    assert(!myBars.empty());
+    myBars.back().myEndTick = end_tick;
+
+    // Each staff and voice in the bar adds its own positions, so sort them and
+    // only keep the earliest tick for each location.
+    auto begin = myEntries.begin() + myBarFirstEntry;
+    std::sort(begin, myEntries.end(), [](const Entry &e1, const Entry &e2) {
+        return std::tie(e1.myLocation, e1.myTick) <
+               std::tie(e2.myLocation, e2.myTick);
+    });
+    myEntries.erase(std::unique(begin, myEntries.end(),
+                                [](const Entry &e1, const Entry &e2) {
+                                    return e1.myLocation == e2.myLocation;
+                                }),
+                    myEntries.end());
+
+    begin = myEntries.begin() + myBarFirstEntry;
+    std::stable_sort(begin, myEntries.end(),
+                     [](const Entry &e1, const Entry &e2) {
+                         return e1.myTick < e2.myTick;
+                     });
+}
+
+void PlaybackTimeline::addTempoChange(int tick, Midi::Tempo tempo)
+{
+    myTempoChanges.push_back({ tick, tempo, Time(0) });
+}
+
+void PlaybackTimeline::finish()
+{
+    // The tempo defaults to 120 bpm until there is a tempo marker.
+    std::stable_sort(myTempoChanges.begin(), myTempoChanges.end(),
+                     [](const TempoChange &t1, const TempoChange &t2) {
+                         return t1.myTick < t2.myTick;
+                     });
+    if (myTempoChanges.empty() || myTempoChanges.front().myTick > 0)
+    {
+        myTempoChanges.insert(myTempoChanges.begin(),
+                              { 0, Midi::BEAT_DURATION_120_BPM, Time(0) });
+    }
+
+    for (size_t i = 1; i < myTempoChanges.size(); ++i)
+    {
+        const TempoChange &prev = myTempoChanges[i - 1];
+        TempoChange &change = myTempoChanges[i];
+        change.myTime =
+            prev.myTime +
+            Time(static_cast<int64_t>(change.myTick - prev.myTick) *
+                 prev.myTempo.count() / myTicksPerBeat);
+    }
+
+    for (Bar &bar : myBars)
+    {
+        bar.myStartTime = getTime(bar.myStartTick);
+        bar.myEndTime = getTime(bar.myEndTick);
+    }
+
+    for (Entry &entry : myEntries)
+        entry.myTime = getTime(entry.myTick);
+
+    // Build indices for finding the first visit to a location. Since the
+    // sort is stable, the first visit is kept by std::unique().
+    auto build_index = [](auto &&items, std::vector<LocationIndex> &index) {
+        index.clear();
+        index.reserve(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+            index.push_back({ items[i].myLocation, static_cast<int>(i) });
+
+        auto compare = [](const LocationIndex &l1, const LocationIndex &l2) {
+            return l1.myLocation < l2.myLocation;
+        };
+        std::stable_sort(index.begin(), index.end(), compare);
+        index.erase(std::unique(index.begin(), index.end(),
+                                [](const LocationIndex &l1,
+                                   const LocationIndex &l2) {
+                                    return l1.myLocation == l2.myLocation;
+                                }),
+                    index.end());
+    };
+
+    build_index(myEntries, myEntryIndex);
+    build_index(myBars, myBarIndex);
+}
+
+PlaybackTimeline::Time
+PlaybackTimeline::getDuration() const
+{
+    return myBars.empty() ? Time(0) : myBars.back().myEndTime;
+}
+
+PlaybackTimeline::Time
+PlaybackTimeline::getTime(int tick) const
+{
+    assert(!myTempoChanges.empty());
+
+    // Find the last tempo change at or before the tick.
+    auto it = std::upper_bound(
+        myTempoChanges.begin(), myTempoChanges.end(), tick,
+        [](int tick, const TempoChange &change) {
+            return tick < change.myTick;
+        });
+    if (it != myTempoChanges.begin())
+        --it;
+
+    return it->myTime + Time(static_cast<int64_t>(tick - it->myTick) *
+                             it->myTempo.count() / myTicksPerBeat);
+}
+
+int
+PlaybackTimeline::getTick(Time time) const
+{
+    assert(!myTempoChanges.empty());
+
+    auto it = std::upper_bound(
+        myTempoChanges.begin(), myTempoChanges.end(), time,
+        [](Time time, const TempoChange &change) {
+            return time < change.myTime;
+        });
+    if (it != myTempoChanges.begin())
+        --it;
+
+    return it->myTick + static_cast<int>((time - it->myTime).count() *
+                                         myTicksPerBeat /
+                                         it->myTempo.count());
+}
+
+std::optional<PlaybackTimeline::Time>
+PlaybackTimeline::getTime(const SystemLocation &location) const
+{
+    auto compare = [](const LocationIndex &index,
+                      const SystemLocation &location) {
+        return index.myLocation < location;
+    };
+
+    auto entry_it = std::lower_bound(myEntryIndex.begin(), myEntryIndex.end(),
+                                     location, compare);
+    if (entry_it != myEntryIndex.end() && entry_it->myLocation == location)
+        return myEntries[entry_it->myIndex].myTime;
+
+    // Otherwise, find the bar containing the location.
+    auto bar_it = std::upper_bound(
+        myBarIndex.begin(), myBarIndex.end(), location,
+        [](const SystemLocation &location, const LocationIndex &index) {
+            return location < index.myLocation;
+        });
+    if (bar_it == myBarIndex.begin())
+        return std::nullopt;
+
+    const Bar &bar = myBars[std::prev(bar_it)->myIndex];
+    if (bar.myLocation.getSystem() != location.getSystem() ||
+        location.getPosition() >= bar.myEndPosition)
+    {
+        return std::nullopt;
+    }
+
+    return bar.myStartTime;
+}
+
+std::optional<SystemLocation>
+PlaybackTimeline::getLocation(Time time) const
+{
+    if (time < Time(0) || time > getDuration())
+        return std::nullopt;
+
+    // Find the last bar and position that start at or before this time.
+    auto bar_it = std::upper_bound(
+        myBars.begin(), myBars.end(), time,
+        [](Time time, const Bar &bar) { return time < bar.myStartTime; });
+    if (bar_it == myBars.begin())
+        return std::nullopt;
+
+    const int bar_index =
+        static_cast<int>(std::distance(myBars.begin(), bar_it)) - 1;
+
+    auto entry_it = std::upper_bound(
+        myEntries.begin(), myEntries.end(), time,
+        [](Time time, const Entry &entry) { return time < entry.myTime; });
+
+    // If the bar doesn't have any positions that have started yet (e.g. an
+    // empty bar), use the bar's location.
+    if (entry_it == myEntries.begin() ||
+        std::prev(entry_it)->myBar != bar_index)
+    {
+        return myBars[bar_index].myLocation;
+    }
+
+    return std::prev(entry_it)->myLocation;
+}
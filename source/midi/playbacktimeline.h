@@ -0,0 +1,117 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MIDI_PLAYBACKTIMELINE_H
+#define MIDI_PLAYBACKTIMELINE_H
+
+#include <chrono>
+#include <midi/midievent.h>
+#include <optional>
+#include <score/systemlocation.h>
+#include <vector>
+
+/// The order in which the score is played back, after following any repeats,
+/// alternate endings and directions. This records the tick and time at which
+/// each bar and position is reached, and supports mapping between times and
+/// locations in the score.
+/// The timeline is built by MidiFile::load().
+class PlaybackTimeline
+{
+public:
+    using Time = std::chrono::microseconds;
+
+    /// A visit to a bar. A bar can be visited several times due to repeats.
+    struct Bar
+    {
+        /// The location of the bar's starting barline.
+        SystemLocation myLocation;
+        /// The position of the bar's ending barline.
+        int myEndPosition;
+        int myStartTick;
+        int myEndTick;
+        Time myStartTime;
+        Time myEndTime;
+    };
+
+    /// The point at which a position in the score is played.
+    struct Entry
+    {
+        SystemLocation myLocation;
+        int myTick;
+        Time myTime;
+        /// Index of the bar visit that this entry belongs to.
+        int myBar;
+    };
+
+    explicit PlaybackTimeline(int ticks_per_beat = 0);
+
+    /// Starts a new bar visit.
+    void beginBar(const SystemLocation &location, int end_position,
+                  int start_tick);
+    /// Records the tick at which a position in the current bar is played.
+    void addPosition(const SystemLocation &location, int tick);
+    /// Finishes the current bar visit.
+    void endBar(int end_tick);
+    /// Records a change in tempo. This may be called in any order.
+    void addTempoChange(int tick, Midi::Tempo tempo);
+    /// Computes the times of each bar and position, once all of the bars have
+    /// been added.
+    void finish();
+
+    const std::vector<Bar> &getBars() const { return myBars; }
+    const std::vector<Entry> &getEntries() const { return myEntries; }
+
+    /// Returns the total playback time, at 100% speed.
+    Time getDuration() const;
+
+    /// Returns the time at which the given tick occurs.
+    Time getTime(int tick) const;
+    /// Returns the tick that is played at the given time.
+    int getTick(Time time) const;
+
+    /// Returns the time at which the given location is first played. If the
+    /// location does not have any notes or rests, the start of the bar is
+    /// used. Returns an empty value if the location is never played.
+    std::optional<Time> getTime(const SystemLocation &location) const;
+    /// Returns the location which is being played at the given time.
+    std::optional<SystemLocation> getLocation(Time time) const;
+
+private:
+    struct TempoChange
+    {
+        int myTick;
+        Midi::Tempo myTempo;
+        Time myTime;
+    };
+
+    /// Index of the first visit to each location, sorted by location.
+    struct LocationIndex
+    {
+        SystemLocation myLocation;
+        int myIndex;
+    };
+
+    int myTicksPerBeat;
+    std::vector<Bar> myBars;
+    std::vector<Entry> myEntries;
+    size_t myBarFirstEntry = 0;
+    std::vector<TempoChange> myTempoChanges;
+    std::vector<LocationIndex> myEntryIndex;
+    std::vector<LocationIndex> myBarIndex;
+};
+
+#endif
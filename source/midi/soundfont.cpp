@@ -0,0 +1,476 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "soundfont.h"
+
+#include <algorithm>
+#include <array>
+#include <boost/endian/conversion.hpp>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+namespace
+{
+/// Generator types from the SoundFont 2.04 specification.
+enum Generator : uint16_t
+{
+    StartAddrsOffset = 0,
+    EndAddrsOffset = 1,
+    StartloopAddrsOffset = 2,
+    EndloopAddrsOffset = 3,
+    StartAddrsCoarseOffset = 4,
+    EndAddrsCoarseOffset = 12,
+    Pan = 17,
+    DelayVolEnv = 33,
+    AttackVolEnv = 34,
+    HoldVolEnv = 35,
+    DecayVolEnv = 36,
+    SustainVolEnv = 37,
+    ReleaseVolEnv = 38,
+    Instrument = 41,
+    KeyRange = 43,
+    VelRange = 44,
+    StartloopAddrsCoarseOffset = 45,
+    InitialAttenuation = 48,
+    EndloopAddrsCoarseOffset = 50,
+    CoarseTune = 51,
+    FineTune = 52,
+    SampleID = 53,
+    SampleModes = 54,
+    OverridingRootKey = 58,
+    NumGenerators = 61
+};
+
+struct Generators
+{
+    std::array<int, NumGenerators> myValues = {};
+    int myMinKey = 0;
+    int myMaxKey = 127;
+    int myMinVelocity = 0;
+    int myMaxVelocity = 127;
+};
+
+struct Zone
+{
+    Generators myGenerators;
+    /// The instrument or sample that the zone refers to, if it is not the
+    /// global zone.
+    int myIndex = -1;
+};
+
+struct SampleHeader
+{
+    uint32_t myStart;
+    uint32_t myEnd;
+    uint32_t myLoopStart;
+    uint32_t myLoopEnd;
+    uint32_t mySampleRate;
+    uint8_t myOriginalPitch;
+    int8_t myPitchCorrection;
+    uint16_t mySampleType;
+};
+
+/// Reads little-endian values from a chunk of the file.
+class Reader
+{
+public:
+    Reader(const char *data, size_t size) : myData(data), mySize(size)
+    {
+    }
+
+    template <typename T>
+    T read()
+    {
+        check(sizeof(T));
+        T val;
+        std::memcpy(&val, myData + myPos, sizeof(T));
+        myPos += sizeof(T);
+        return boost::endian::little_to_native(val);
+    }
+
+    std::string readTag()
+    {
+        check(4);
+        std::string tag(myData + myPos, 4);
+        myPos += 4;
+        return tag;
+    }
+
+    /// Returns a reader for the next chunk, and advances past it.
+    Reader readChunk(std::string &tag)
+    {
+        tag = readTag();
+        const uint32_t size = read<uint32_t>();
+        check(size);
+
+        Reader chunk(myData + myPos, size);
+        // Chunks are padded to an even size.
+        myPos += std::min<size_t>(size + (size % 2), mySize - myPos);
+        return chunk;
+    }
+
+    void skip(size_t n)
+    {
+        check(n);
+        myPos += n;
+    }
+
+    bool atEnd() const { return myPos >= mySize; }
+    size_t size() const { return mySize; }
+    const char *data() const { return myData; }
+
+private:
+    void check(size_t n) const
+    {
+        if (mySize - myPos < n)
+            throw SoundFont::FormatError("Unexpected end of file.");
+    }
+
+    const char *myData;
+    size_t mySize;
+    size_t myPos = 0;
+};
+
+Generators getDefaultGenerators()
+{
+    Generators gens;
+    gens.myValues[DelayVolEnv] = -12000;
+    gens.myValues[AttackVolEnv] = -12000;
+    gens.myValues[HoldVolEnv] = -12000;
+    gens.myValues[DecayVolEnv] = -12000;
+    gens.myValues[ReleaseVolEnv] = -12000;
+    gens.myValues[OverridingRootKey] = -1;
+    return gens;
+}
+
+/// Reads the zones for each preset or instrument, given the chunks containing
+/// the headers, bags and generators. The global zone, if any, is merged into
+/// the other zones.
+std::vector<std::vector<Zone>>
+readZones(const std::vector<uint16_t> &header_bags, Reader bags, Reader gens,
+          Generator index_generator, const Generators &defaults)
+{
+    std::vector<std::pair<uint16_t, uint16_t>> bag_list;
+    while (!bags.atEnd())
+    {
+        const uint16_t gen_idx = bags.read<uint16_t>();
+        const uint16_t mod_idx = bags.read<uint16_t>();
+        bag_list.emplace_back(gen_idx, mod_idx);
+    }
+
+    struct GeneratorValue
+    {
+        uint16_t myType;
+        uint16_t myAmount;
+    };
+    std::vector<GeneratorValue> gen_list;
+    while (!gens.atEnd())
+    {
+        const uint16_t type = gens.read<uint16_t>();
+        const uint16_t amount = gens.read<uint16_t>();
+        gen_list.push_back({ type, amount });
+    }
+
+    std::vector<std::vector<Zone>> result;
+    // The last header is a terminal record.
+    for (size_t i = 0; i + 1 < header_bags.size(); ++i)
+    {
+        std::vector<Zone> zones;
+        Generators global = defaults;
+
+        const size_t bag_end =
+            std::min<size_t>(header_bags[i + 1], bag_list.size());
+        for (size_t bag = header_bags[i]; bag + 1 < bag_list.size() &&
+                                          bag < bag_end;
+             ++bag)
+        {
+            Zone zone;
+            zone.myGenerators = global;
+
+            const size_t gen_end =
+                std::min<size_t>(bag_list[bag + 1].first, gen_list.size());
+            for (size_t g = bag_list[bag].first; g < gen_end; ++g)
+            {
+                const GeneratorValue &gen = gen_list[g];
+                if (gen.myType == KeyRange)
+                {
+                    zone.myGenerators.myMinKey = gen.myAmount & 0xff;
+                    zone.myGenerators.myMaxKey = gen.myAmount >> 8;
+                }
+                else if (gen.myType == VelRange)
+                {
+                    zone.myGenerators.myMinVelocity = gen.myAmount & 0xff;
+                    zone.myGenerators.myMaxVelocity = gen.myAmount >> 8;
+                }
+                else if (gen.myType == index_generator)
+                    zone.myIndex = gen.myAmount;
+                else if (gen.myType < NumGenerators)
+                {
+                    zone.myGenerators.myValues[gen.myType] =
+                        static_cast<int16_t>(gen.myAmount);
+                }
+            }
+
+            // The first zone is the global zone if it doesn't refer to an
+            // instrument or sample.
+            if (zone.myIndex < 0)
+            {
+                if (bag == header_bags[i])
+                    global = zone.myGenerators;
+            }
+            else
+                zones.push_back(zone);
+        }
+
+        result.push_back(std::move(zones));
+    }
+
+    return result;
+}
+
+float timecentsToSeconds(int timecents)
+{
+    return std::pow(2.0f, timecents / 1200.0f);
+}
+} // namespace
+
+SoundFont::FormatError::FormatError(const std::string &error)
+    : std::runtime_error(error)
+{
+}
+
+SoundFont::SoundFont(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file)
+        throw FormatError("Could not open the SoundFont file.");
+
+    const std::vector<char> contents((std::istreambuf_iterator<char>(file)),
+                                     std::istreambuf_iterator<char>());
+
+    if (contents.size() < 12 || std::memcmp(contents.data(), "RIFF", 4) != 0 ||
+        std::memcmp(contents.data() + 8, "sfbk", 4) != 0)
+    {
+        throw FormatError("The file is not a SoundFont.");
+    }
+
+    Reader reader(contents.data(), contents.size());
+    std::string tag;
+    Reader riff = reader.readChunk(tag);
+    riff.skip(4);
+
+    std::map<std::string, Reader> pdta_chunks;
+    while (!riff.atEnd())
+    {
+        Reader list = riff.readChunk(tag);
+        if (tag != "LIST")
+            continue;
+
+        const std::string list_type = list.readTag();
+        while (!list.atEnd())
+        {
+            Reader chunk = list.readChunk(tag);
+            if (list_type == "sdta" && tag == "smpl")
+            {
+                mySamples.resize(chunk.size() / 2);
+                for (int16_t &sample : mySamples)
+                    sample = chunk.read<int16_t>();
+            }
+            else if (list_type == "pdta")
+                pdta_chunks.emplace(tag, chunk);
+        }
+    }
+
+    for (const char *name :
+         { "phdr", "pbag", "pgen", "inst", "ibag", "igen", "shdr" })
+    {
+        if (!pdta_chunks.count(name))
+            throw FormatError("The SoundFont is missing preset data.");
+    }
+
+    // Sample headers.
+    std::vector<SampleHeader> samples;
+    {
+        Reader shdr = pdta_chunks.at("shdr");
+        while (!shdr.atEnd())
+        {
+            SampleHeader header;
+            shdr.skip(20); // Name.
+            header.myStart = shdr.read<uint32_t>();
+            header.myEnd = shdr.read<uint32_t>();
+            header.myLoopStart = shdr.read<uint32_t>();
+            header.myLoopEnd = shdr.read<uint32_t>();
+            header.mySampleRate = shdr.read<uint32_t>();
+            header.myOriginalPitch = shdr.read<uint8_t>();
+            header.myPitchCorrection = shdr.read<int8_t>();
+            shdr.skip(2); // Sample link.
+            header.mySampleType = shdr.read<uint16_t>();
+            samples.push_back(header);
+        }
+    }
+
+    // Instruments.
+    std::vector<uint16_t> inst_bags;
+    {
+        Reader inst = pdta_chunks.at("inst");
+        while (!inst.atEnd())
+        {
+            inst.skip(20); // Name.
+            inst_bags.push_back(inst.read<uint16_t>());
+        }
+    }
+    const std::vector<std::vector<Zone>> instruments =
+        readZones(inst_bags, pdta_chunks.at("ibag"), pdta_chunks.at("igen"),
+                  SampleID, getDefaultGenerators());
+
+    // Presets.
+    std::vector<uint16_t> preset_bags;
+    std::vector<std::pair<int, int>> preset_ids;
+    {
+        Reader phdr = pdta_chunks.at("phdr");
+        while (!phdr.atEnd())
+        {
+            phdr.skip(20); // Name.
+            const uint16_t preset = phdr.read<uint16_t>();
+            const uint16_t bank = phdr.read<uint16_t>();
+            preset_bags.push_back(phdr.read<uint16_t>());
+            phdr.skip(12); // Library, genre, morphology.
+            preset_ids.emplace_back(bank, preset);
+        }
+    }
+    // Generators at the preset level are offsets to the instrument's values.
+    const std::vector<std::vector<Zone>> presets =
+        readZones(preset_bags, pdta_chunks.at("pbag"), pdta_chunks.at("pgen"),
+                  Instrument, Generators());
+
+    const auto num_samples = static_cast<uint32_t>(mySamples.size());
+    for (size_t i = 0; i < presets.size(); ++i)
+    {
+        std::vector<Region> &regions = myPresets[preset_ids[i]];
+
+        for (const Zone &preset_zone : presets[i])
+        {
+            if (preset_zone.myIndex >= static_cast<int>(instruments.size()))
+                continue;
+
+            const Generators &pgen = preset_zone.myGenerators;
+            for (const Zone &inst_zone : instruments[preset_zone.myIndex])
+            {
+                if (inst_zone.myIndex >= static_cast<int>(samples.size()))
+                    continue;
+
+                const SampleHeader &sample = samples[inst_zone.myIndex];
+                // Skip ROM samples.
+                if (sample.mySampleType & 0x8000)
+                    continue;
+
+                const Generators &igen = inst_zone.myGenerators;
+                auto gen = [&](Generator type) {
+                    return igen.myValues[type] + pgen.myValues[type];
+                };
+                auto offset = [&](uint32_t base, Generator fine,
+                                  Generator coarse) {
+                    const int64_t value = static_cast<int64_t>(base) +
+                                          igen.myValues[fine] +
+                                          32768 * igen.myValues[coarse];
+                    return static_cast<uint32_t>(
+                        std::clamp<int64_t>(value, 0, num_samples));
+                };
+
+                Region region;
+                region.myMinKey = std::max(igen.myMinKey, pgen.myMinKey);
+                region.myMaxKey = std::min(igen.myMaxKey, pgen.myMaxKey);
+                region.myMinVelocity =
+                    std::max(igen.myMinVelocity, pgen.myMinVelocity);
+                region.myMaxVelocity =
+                    std::min(igen.myMaxVelocity, pgen.myMaxVelocity);
+
+                region.myStart = offset(sample.myStart, StartAddrsOffset,
+                                        StartAddrsCoarseOffset);
+                region.myEnd = offset(sample.myEnd, EndAddrsOffset,
+                                      EndAddrsCoarseOffset);
+                region.myLoopStart =
+                    offset(sample.myLoopStart, StartloopAddrsOffset,
+                           StartloopAddrsCoarseOffset);
+                region.myLoopEnd = offset(sample.myLoopEnd, EndloopAddrsOffset,
+                                          EndloopAddrsCoarseOffset);
+                if (region.myEnd <= region.myStart)
+                    continue;
+                region.myLoop = (igen.myValues[SampleModes] & 1) &&
+                                region.myLoopStart >= region.myStart &&
+                                region.myLoopEnd <= region.myEnd &&
+                                region.myLoopEnd > region.myLoopStart;
+
+                region.mySampleRate =
+                    std::max<int>(1, static_cast<int>(sample.mySampleRate));
+                region.myRootKey = igen.myValues[OverridingRootKey] >= 0
+                                       ? igen.myValues[OverridingRootKey]
+                                       : sample.myOriginalPitch;
+                region.myTune = gen(CoarseTune) * 100 + gen(FineTune) +
+                                sample.myPitchCorrection;
+                region.myAttenuation = std::max(0, gen(InitialAttenuation));
+                region.myPan = std::clamp(gen(Pan), -500, 500);
+
+                region.myDelay = timecentsToSeconds(gen(DelayVolEnv));
+                region.myAttack = timecentsToSeconds(gen(AttackVolEnv));
+                region.myHold = timecentsToSeconds(gen(HoldVolEnv));
+                region.myDecay = timecentsToSeconds(gen(DecayVolEnv));
+                region.myRelease = timecentsToSeconds(gen(ReleaseVolEnv));
+                region.mySustain = std::clamp(gen(SustainVolEnv), 0, 1440);
+
+                regions.push_back(region);
+            }
+        }
+    }
+
+    if (myPresets.empty())
+        throw FormatError("The SoundFont does not contain any presets.");
+}
+
+const std::vector<SoundFont::Region> *
+SoundFont::findPreset(int bank, int preset) const
+{
+    auto it = myPresets.find({ bank, preset });
+    if (it != myPresets.end())
+        return &it->second;
+
+    // Fall back to the first preset in the bank, or in the file.
+    it = myPresets.lower_bound({ bank, 0 });
+    if (it != myPresets.end() && it->first.first == bank)
+        return &it->second;
+
+    return &myPresets.begin()->second;
+}
+
+std::vector<const SoundFont::Region *>
+SoundFont::findRegions(int bank, int preset, int key, int velocity) const
+{
+    std::vector<const Region *> result;
+    for (const Region &region : *findPreset(bank, preset))
+    {
+        if (key >= region.myMinKey && key <= region.myMaxKey &&
+            velocity >= region.myMinVelocity &&
+            velocity <= region.myMaxVelocity)
+        {
+            result.push_back(&region);
+        }
+    }
+
+    return result;
+}
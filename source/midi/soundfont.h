@@ -0,0 +1,94 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MIDI_SOUNDFONT_H
+#define MIDI_SOUNDFONT_H
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// A SoundFont 2 (.sf2) file. Only the generators that are needed for basic
+/// sample playback are supported (key / velocity ranges, tuning, looping,
+/// attenuation, pan and the volume envelope). Modulators are ignored.
+class SoundFont
+{
+public:
+    /// A sample to play for a range of keys and velocities.
+    struct Region
+    {
+        int myMinKey = 0;
+        int myMaxKey = 127;
+        int myMinVelocity = 0;
+        int myMaxVelocity = 127;
+
+        uint32_t myStart = 0;
+        uint32_t myEnd = 0;
+        uint32_t myLoopStart = 0;
+        uint32_t myLoopEnd = 0;
+        bool myLoop = false;
+
+        int mySampleRate = 44100;
+        int myRootKey = 60;
+        /// Tuning adjustment, in cents.
+        int myTune = 0;
+        /// Attenuation, in centibels.
+        int myAttenuation = 0;
+        /// Pan, from -500 (left) to 500 (right).
+        int myPan = 0;
+
+        /// Volume envelope times, in seconds.
+        float myDelay = 0;
+        float myAttack = 0;
+        float myHold = 0;
+        float myDecay = 0;
+        float myRelease = 0;
+        /// Sustain level, as an attenuation in centibels.
+        int mySustain = 0;
+    };
+
+    class FormatError : public std::runtime_error
+    {
+    public:
+        FormatError(const std::string &error);
+    };
+
+    /// Loads a SoundFont file.
+    /// @throws FormatError if the file is not a valid SoundFont.
+    explicit SoundFont(const std::filesystem::path &path);
+
+    /// Returns the regions that should be played for a note. If the preset
+    /// does not exist, the first preset in the bank (or the whole file) is
+    /// used instead.
+    std::vector<const Region *> findRegions(int bank, int preset, int key,
+                                            int velocity) const;
+
+    /// Returns the 16-bit sample data for all of the regions.
+    const std::vector<int16_t> &getSamples() const { return mySamples; }
+
+private:
+    const std::vector<Region> *findPreset(int bank, int preset) const;
+
+    std::vector<int16_t> mySamples;
+    /// Regions for each (bank, preset).
+    std::map<std::pair<int, int>, std::vector<Region>> myPresets;
+};
+
+#endif
@@ -83,6 +83,12 @@ BarlinePainter::filterMousePosition(const QPointF &pos) const
            (y >= myLayout->getTopStdNotationLine());
 }
 
+void BarlinePainter::setBarlineColor(const QColor &color)
+{
+    myBarlineColor = color;
+    update();
+}
+
 void
 BarlinePainter::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
                       QWidget *widget)
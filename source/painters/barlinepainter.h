@@ -45,6 +45,9 @@ public:
         return myBounds;
     }
 
+    const QColor &getBarlineColor() const { return myBarlineColor; }
+    void setBarlineColor(const QColor &color);
+
 protected:
     bool filterMousePosition(const QPointF &pos) const override;
 
@@ -56,7 +59,7 @@ private:
     QRectF myBounds;
     double myX;
     double myWidth;
-    const QColor &myBarlineColor;
+    QColor myBarlineColor;
 
     static const double DOUBLE_BAR_WIDTH;
 };
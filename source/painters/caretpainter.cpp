@@ -22,6 +22,7 @@
 #include <app/caret.h>
 #include <app/viewoptions.h>
 #include <painters/layoutinfo.h>
+#include <painters/layoutstore.h>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QPainter>
@@ -33,9 +34,11 @@
 const double CaretPainter::PEN_WIDTH = 0.75;
 const double CaretPainter::CARET_NOTE_SPACING = 6;
 
-CaretPainter::CaretPainter(const Caret &caret, const ViewOptions &view_options)
+CaretPainter::CaretPainter(const Caret &caret, const ViewOptions &view_options,
+                           const LayoutStore &layout_store)
     : myCaret(caret),
       myViewOptions(view_options),
+      myLayoutStore(layout_store),
       myCaretConnection(caret.subscribeToChanges([=]() {
           onLocationChanged();
       }))
@@ -168,7 +171,7 @@ void CaretPainter::onLocationChanged()
     if (system.getStaves().empty())
         return;
 
-    myLayout = std::make_unique<LayoutInfo>(location);
+    myLayout = myLayoutStore.getLayout(location);
 
     const ViewFilter *filter =
         myViewOptions.getFilter()
@@ -182,9 +185,9 @@ void CaretPainter::onLocationChanged()
         if (!filter ||
             filter->accept(location.getScore(), location.getSystemIndex(), i))
         {
-            ScoreLocation staff_location(location);
+            ConstScoreLocation staff_location(location);
             staff_location.setStaffIndex(i);
-            offset += LayoutInfo(staff_location).getStaffHeight();
+            offset += myLayoutStore.getLayout(staff_location)->getStaffHeight();
         }
     }
 
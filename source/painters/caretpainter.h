@@ -24,12 +24,14 @@
 
 class Caret;
 struct LayoutInfo;
+class LayoutStore;
 class ViewOptions;
 
 class CaretPainter : public QGraphicsItem
 {
 public:
-    CaretPainter(const Caret &caret, const ViewOptions &view_options);
+    CaretPainter(const Caret &caret, const ViewOptions &view_options,
+                 const LayoutStore &layout_store);
 
     virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                        QWidget *) override;
@@ -53,7 +55,9 @@ private:
 
     const Caret &myCaret;
     const ViewOptions &myViewOptions;
-    std::unique_ptr<LayoutInfo> myLayout;
+    /// Provides the layouts computed when rendering the score.
+    const LayoutStore &myLayoutStore;
+    std::shared_ptr<const LayoutInfo> myLayout;
     std::vector<QRectF> mySystemRects;
     boost::signals2::scoped_connection myCaretConnection;
     LocationChangedSlot onMyLocationChanged;
@@ -17,7 +17,6 @@
   
 #include "systemrenderer.h"
 
-#include <app/scorearea.h>
 #include <QCoreApplication>
 #include <painters/clickableitem.h>
 #include <painters/musicfont.h>
@@ -53,7 +52,7 @@ SystemRenderer::drawDirections(const ConstScoreLocation &location,
         auto group = new ClickableGroup(
             QCoreApplication::translate(
                 "ScoreArea", "Double-click to edit musical direction."),
-            myScoreArea->getClickEvent(), dir_location, ScoreItem::Direction);
+            myClickEvent, dir_location, ScoreItem::Direction);
         group->setParentItem(myParentSystem);
 
         for (const DirectionSymbol &symbol : direction.getSymbols())
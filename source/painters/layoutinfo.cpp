@@ -26,6 +26,7 @@
 #include <score/timesignature.h>
 #include <score/voiceutils.h>
 #include <set>
+#include <util/tracing.h>
 
 const double LayoutInfo::STAFF_WIDTH = 750;
 const int LayoutInfo::NUM_STD_NOTATION_LINES = 5;
@@ -52,6 +53,8 @@ LayoutInfo::LayoutInfo(const ConstScoreLocation &location)
       myStdNotationStaffAboveSpacing(0),
       myStdNotationStaffBelowSpacing(0)
 {
+    PTE_TRACE_SCOPE("LayoutInfo");
+
     computePositionSpacing();
     calculateTabStaffBelowLayout();
     calculateTabStaffAboveLayout();
@@ -321,31 +324,36 @@ static void updateMaxPosition(int &max, const Range &range)
         max = std::max(max, obj.getPosition());
 }
 
-void LayoutInfo::computePositionSpacing()
+int LayoutInfo::computeNumPositions(const System &system)
 {
-    const System &system = myLocation.getSystem();
-    const double width = getFirstPositionX() + getCumulativeBarlineWidths();
-
-    // Find the number of positions needed for the system.
+    int numPositions = 0;
     for (const Staff &staff : system.getStaves())
     {
         for (const Voice &voice : staff.getVoices())
         {
             for (const Position &position : voice.getPositions())
-            {
-                myNumPositions = std::max(myNumPositions,
-                                          position.getPosition());
-            }
+                numPositions = std::max(numPositions, position.getPosition());
         }
     }
 
-    updateMaxPosition(myNumPositions, system.getBarlines());
-    updateMaxPosition(myNumPositions, system.getTempoMarkers());
-    updateMaxPosition(myNumPositions, system.getAlternateEndings());
-    updateMaxPosition(myNumPositions, system.getChords());
-    updateMaxPosition(myNumPositions, system.getTextItems());
-    updateMaxPosition(myNumPositions, system.getDirections());
-    updateMaxPosition(myNumPositions, system.getPlayerChanges());
+    updateMaxPosition(numPositions, system.getBarlines());
+    updateMaxPosition(numPositions, system.getTempoMarkers());
+    updateMaxPosition(numPositions, system.getAlternateEndings());
+    updateMaxPosition(numPositions, system.getChords());
+    updateMaxPosition(numPositions, system.getTextItems());
+    updateMaxPosition(numPositions, system.getDirections());
+    updateMaxPosition(numPositions, system.getPlayerChanges());
+
+    return numPositions;
+}
+
+void LayoutInfo::computePositionSpacing()
+{
+    const System &system = myLocation.getSystem();
+    const double width = getFirstPositionX() + getCumulativeBarlineWidths();
+
+    // Find the number of positions needed for the system.
+    myNumPositions = computeNumPositions(system);
 
     const double availableSpace = STAFF_WIDTH - width;
     myPositionSpacing = availableSpace / (myNumPositions + 2);
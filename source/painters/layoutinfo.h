@@ -158,6 +158,10 @@ struct LayoutInfo
     static double getWidth(const TimeSignature &time);
     static double getWidth(const Barline &bar);
 
+    /// Returns the last position used by any item in the system, which
+    /// determines the spacing of the positions in each of its staves.
+    static int computeNumPositions(const System &system);
+
     double getTabStaffBelowSpacing() const;
     const std::vector<SymbolGroup> &getTabStaffBelowSymbols() const;
     const std::vector<SymbolGroup> &getTabStaffAboveSymbols() const;
@@ -237,5 +241,7 @@ private:
 
 typedef std::shared_ptr<LayoutInfo> LayoutPtr;
 typedef std::shared_ptr<const LayoutInfo> LayoutConstPtr;
+/// The layouts for each staff in a system.
+typedef std::vector<LayoutConstPtr> SystemLayout;
 
 #endif
@@ -0,0 +1,199 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "layoutstore.h"
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <score/hash.h>
+#include <score/score.h>
+#include <score/system.h>
+
+/// Fills in any missing layouts from the previous layouts of the system, for
+/// the staves whose key has not changed.
+static void reuseLayouts(SystemLayout &layouts,
+                         const std::vector<size_t> &keys,
+                         const SystemLayout &old_layouts,
+                         const std::vector<size_t> &old_keys)
+{
+    layouts.resize(keys.size());
+
+    const size_t n = std::min({ keys.size(), old_keys.size(),
+                                old_layouts.size() });
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (!layouts[i] && keys[i] == old_keys[i])
+            layouts[i] = old_layouts[i];
+    }
+}
+
+void LayoutStore::reset(const Score &score, std::vector<SystemLayout> layouts)
+{
+    const int num_systems = static_cast<int>(score.getSystems().size());
+
+    std::vector<SystemLayout> old_layouts = std::move(myLayouts);
+    std::vector<std::vector<size_t>> old_keys = std::move(myKeys);
+
+    myLayouts = std::move(layouts);
+    myLayouts.resize(num_systems);
+    myKeys.resize(num_systems);
+
+    for (int i = 0; i < num_systems; ++i)
+    {
+        myKeys[i] = computeKeys(score, i);
+
+        if (i < static_cast<int>(old_layouts.size()) &&
+            i < static_cast<int>(old_keys.size()))
+        {
+            reuseLayouts(myLayouts[i], myKeys[i], old_layouts[i],
+                         old_keys[i]);
+        }
+    }
+}
+
+void LayoutStore::clear()
+{
+    myLayouts.clear();
+    myKeys.clear();
+}
+
+SystemLayout &LayoutStore::getSystemLayouts(int system)
+{
+    return myLayouts.at(system);
+}
+
+SystemLayout &LayoutStore::invalidateSystem(const Score &score, int system)
+{
+    SystemLayout &layouts = myLayouts.at(system);
+    std::vector<size_t> &keys = myKeys.at(system);
+
+    const SystemLayout old_layouts = std::move(layouts);
+    const std::vector<size_t> old_keys = std::move(keys);
+
+    layouts.clear();
+    keys = computeKeys(score, system);
+    reuseLayouts(layouts, keys, old_layouts, old_keys);
+
+    return layouts;
+}
+
+LayoutConstPtr LayoutStore::getLayout(const ConstScoreLocation &location) const
+{
+    const int system = location.getSystemIndex();
+    const int staff = location.getStaffIndex();
+
+    if (system < static_cast<int>(myLayouts.size()))
+    {
+        // If the number of staves doesn't match, the system was modified and
+        // hasn't been redrawn yet.
+        const SystemLayout &layouts = myLayouts[system];
+        if (layouts.size() == location.getSystem().getStaves().size() &&
+            staff < static_cast<int>(layouts.size()) && layouts[staff])
+        {
+            return layouts[staff];
+        }
+    }
+
+    return std::make_shared<LayoutInfo>(location);
+}
+
+std::vector<size_t> LayoutStore::computeKeys(const Score &score,
+                                             int systemIndex)
+{
+    const System &system = score.getSystems()[systemIndex];
+
+    // Start with the inputs that are shared by all of the staves. The layout
+    // holds a location in the score, so the indices are needed as well.
+    size_t system_key = 0;
+    boost::hash_combine(system_key, &score);
+    boost::hash_combine(system_key, systemIndex);
+    boost::hash_combine(system_key, score.getLineSpacing());
+    boost::hash_combine(system_key, LayoutInfo::computeNumPositions(system));
+
+    // The standard notation refers to the key signatures from the barlines.
+    for (const Barline &barline : system.getBarlines())
+    {
+        boost::hash_combine(system_key, &barline);
+        boost::hash_combine(system_key, ScoreUtils::computeHash(barline));
+    }
+
+    // The tunings come from the active players, which may have been set by a
+    // player change in a previous system.
+    for (const Player &player : score.getPlayers())
+    {
+        boost::hash_combine(system_key, &player);
+        boost::hash_combine(system_key, ScoreUtils::computeHash(player));
+    }
+
+    if (const PlayerChange *players =
+            ScoreUtils::getCurrentPlayers(score, systemIndex, 0))
+    {
+        boost::hash_combine(system_key, ScoreUtils::computeHash(*players));
+    }
+
+    for (const PlayerChange &change : system.getPlayerChanges())
+        boost::hash_combine(system_key, ScoreUtils::computeHash(change));
+
+    const System *next_system = nullptr;
+    if (systemIndex + 1 < static_cast<int>(score.getSystems().size()))
+        next_system = &score.getSystems()[systemIndex + 1];
+
+    std::vector<size_t> keys;
+    keys.reserve(system.getStaves().size());
+
+    int staff_index = 0;
+    for (const Staff &staff : system.getStaves())
+    {
+        size_t key = system_key;
+        boost::hash_combine(key, staff_index);
+        boost::hash_combine(key, staff.getHash());
+
+        // The player changes are looked up using the first identical staff
+        // (see LayoutInfo::calculateTabStaffAboveLayout()).
+        auto first = std::find_if(
+            system.getStaves().begin(), system.getStaves().end(),
+            [&](const Staff &other) {
+                return other.getHash() == staff.getHash() && other == staff;
+            });
+        boost::hash_combine(key, first - system.getStaves().begin());
+
+        // Hammerons etc can continue into the same staff of the next system.
+        if (next_system &&
+            staff_index < static_cast<int>(next_system->getStaves().size()))
+        {
+            boost::hash_combine(
+                key, next_system->getStaves()[staff_index].getHash());
+        }
+
+        // The layout refers directly to the voices, positions and notes.
+        boost::hash_combine(key, &staff);
+        for (const Voice &voice : staff.getVoices())
+        {
+            for (const Position &pos : voice.getPositions())
+            {
+                boost::hash_combine(key, &pos);
+                for (const Note &note : pos.getNotes())
+                    boost::hash_combine(key, &note);
+            }
+        }
+
+        keys.push_back(key);
+        ++staff_index;
+    }
+
+    return keys;
+}
@@ -0,0 +1,72 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_LAYOUTSTORE_H
+#define PAINTERS_LAYOUTSTORE_H
+
+#include <painters/layoutinfo.h>
+#include <vector>
+
+class ConstScoreLocation;
+class Score;
+
+/// Retains the layout of each staff that was computed while rendering the
+/// score, so that e.g. the caret can be positioned without recomputing the
+/// layout of the current staff and the staves above it.
+///
+/// Each layout is also recorded with a key for the inputs that it was computed
+/// from. When a system is redrawn, the layouts of any staves whose key is
+/// unchanged (e.g. if only a chord name or a neighbouring staff was edited)
+/// are reused rather than being computed again.
+class LayoutStore
+{
+public:
+    /// Replaces all of the layouts, e.g. when the entire score is redrawn.
+    /// Any staves which are not in the provided layouts reuse the previous
+    /// layout if their inputs have not changed.
+    void reset(const Score &score, std::vector<SystemLayout> layouts);
+
+    /// Discards all of the layouts.
+    void clear();
+
+    /// Returns the layouts for the system, which SystemRenderer uses and fills
+    /// in with any layouts that it needs to compute.
+    SystemLayout &getSystemLayouts(int system);
+
+    /// Discards the layouts for any staves in the system that were modified,
+    /// and returns the layout list to be filled in when the system is
+    /// rendered.
+    SystemLayout &invalidateSystem(const Score &score, int system);
+
+    /// Returns the layout for the staff at the given location. If the layout
+    /// is not available or may be out of date (e.g. the system has been
+    /// modified but not yet redrawn), a new layout is computed.
+    LayoutConstPtr getLayout(const ConstScoreLocation &location) const;
+
+    /// Computes a key for each staff in the system, which identifies
+    /// everything that the staff's layout depends on. Along with the contents
+    /// of the staff, this includes the system's barlines (key and time
+    /// signatures), the players and their tunings, the line spacing, and the
+    /// addresses of the objects that the layout refers to.
+    static std::vector<size_t> computeKeys(const Score &score, int system);
+
+private:
+    std::vector<SystemLayout> myLayouts;
+    std::vector<std::vector<size_t>> myKeys;
+};
+
+#endif
@@ -0,0 +1,219 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pageexporter.h"
+
+#include <app/paths.h>
+#include <app/viewoptions.h>
+#include <formats/fileformatmanager.h>
+#include <painters/pagerenderer.h>
+#include <painters/styles.h>
+#include <QImage>
+#include <QLocale>
+#include <QPageLayout>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QPicture>
+#include <QSvgGenerator>
+#include <util/threadpool.h>
+#include <util/tracing.h>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+/// Resolution (in dpi) of the exported pages.
+static const int theResolution = 300;
+
+static FileFormat getFileFormat(PageExporter::Output output)
+{
+    switch (output)
+    {
+        case PageExporter::Output::Pdf:
+            return FileFormat("PDF Document", { "pdf" });
+        case PageExporter::Output::Svg:
+            return FileFormat("SVG Image", { "svg" });
+        case PageExporter::Output::Png:
+            return FileFormat("PNG Image", { "png" });
+    }
+
+    throw std::logic_error("Unknown output format");
+}
+
+/// Uses the paper size for the user's locale, with the same margins on each
+/// side.
+static QPageLayout getPageLayout()
+{
+    const QPageSize size(QLocale::system().measurementSystem() ==
+                                 QLocale::ImperialUSSystem
+                             ? QPageSize::Letter
+                             : QPageSize::A4);
+
+    return QPageLayout(size, QPageLayout::Portrait,
+                       QMarginsF(15, 15, 15, 15), QPageLayout::Millimeter);
+}
+
+/// Returns the filename for a page when each page is a separate file.
+static std::filesystem::path getPagePath(const std::filesystem::path &filename,
+                                         int page, int num_pages)
+{
+    if (num_pages == 1)
+        return filename;
+
+    std::filesystem::path path = filename;
+    path.replace_filename(filename.stem().u8string() + "-" +
+                          std::to_string(page + 1) +
+                          filename.extension().u8string());
+    return path;
+}
+
+/// Returns the pool used for rendering pages. This is shared between exports,
+/// so that exporting several scores concurrently (e.g. from the command line)
+/// doesn't start a pool of threads for each score.
+static Util::ThreadPool &getPagePool()
+{
+    static Util::ThreadPool pool;
+    return pool;
+}
+
+/// Runs the task for each page in parallel, and rethrows the first error.
+template <typename Fn>
+static void forEachPage(Util::ThreadPool &pool, int num_pages, Fn &&fn)
+{
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(num_pages);
+    for (int i = 0; i < num_pages; ++i)
+        tasks.push_back(pool.submit([&fn, i]() { fn(i); }));
+
+    for (auto &&task : tasks)
+        task.get();
+}
+
+PageExporter::PageExporter(Output output)
+    : FileFormatExporter(getFileFormat(output)), myOutput(output)
+{
+}
+
+void PageExporter::registerFormats(FileFormatManager &manager)
+{
+    for (Output output : { Output::Pdf, Output::Svg, Output::Png })
+        manager.addExporter(std::make_unique<PageExporter>(output));
+}
+
+void PageExporter::save(const std::filesystem::path &filename,
+                        const Score &score)
+{
+    PTE_TRACE_SCOPE("PageExporter::save");
+
+    const QPageLayout page_layout = getPageLayout();
+    const QRect full_rect = page_layout.fullRectPixels(theResolution);
+    const QRect paint_rect = page_layout.paintRectPixels(theResolution);
+
+    Util::ThreadPool &pool = getPagePool();
+    const ViewOptions view_options;
+    // Use the same colors as when printing from the score view.
+    const PageRenderer renderer(score, view_options, Styles::getLightPalette(),
+                                paint_rect.size(), pool);
+    const int num_pages = renderer.getPageCount();
+
+    switch (myOutput)
+    {
+        case Output::Pdf:
+        {
+            // A PDF file can only be written from one thread, so record the
+            // pages in parallel and then write them in order.
+            std::vector<QPicture> pictures(num_pages);
+            forEachPage(pool, num_pages, [&](int page) {
+                QPainter painter(&pictures[page]);
+                renderer.renderPage(page, painter);
+            });
+
+            QPdfWriter writer(Paths::toQString(filename));
+            writer.setCreator(QStringLiteral("Power Tab Editor"));
+            writer.setResolution(theResolution);
+            writer.setPageLayout(page_layout);
+
+            QPainter painter;
+            if (!painter.begin(&writer))
+                throw FileFormatException("Could not open file for writing.");
+
+            for (int page = 0; page < num_pages; ++page)
+            {
+                if (page > 0)
+                    writer.newPage();
+
+                painter.drawPicture(0, 0, pictures[page]);
+            }
+
+            if (!painter.end())
+                throw FileFormatException("Could not write the PDF file.");
+            break;
+        }
+        case Output::Svg:
+        {
+            forEachPage(pool, num_pages, [&](int page) {
+                const QString path = Paths::toQString(
+                    getPagePath(filename, page, num_pages));
+
+                QSvgGenerator generator;
+                generator.setFileName(path);
+                generator.setResolution(theResolution);
+                generator.setSize(full_rect.size());
+                generator.setViewBox(QRect(QPoint(0, 0), full_rect.size()));
+
+                QPainter painter;
+                if (!painter.begin(&generator))
+                {
+                    throw FileFormatException(
+                        "Could not open file for writing.");
+                }
+
+                painter.translate(paint_rect.topLeft());
+                renderer.renderPage(page, painter);
+
+                if (!painter.end())
+                    throw FileFormatException("Could not write the SVG file.");
+            });
+            break;
+        }
+        case Output::Png:
+        {
+            forEachPage(pool, num_pages, [&](int page) {
+                const QString path = Paths::toQString(
+                    getPagePath(filename, page, num_pages));
+
+                QImage image(full_rect.size(), QImage::Format_RGB32);
+                image.setDotsPerMeterX(qRound(theResolution / 0.0254));
+                image.setDotsPerMeterY(qRound(theResolution / 0.0254));
+                image.fill(Qt::white);
+
+                {
+                    QPainter painter(&image);
+                    painter.setRenderHints(QPainter::Antialiasing |
+                                           QPainter::TextAntialiasing |
+                                           QPainter::SmoothPixmapTransform);
+                    painter.translate(paint_rect.topLeft());
+                    renderer.renderPage(page, painter);
+                }
+
+                if (!image.save(path, "PNG"))
+                    throw FileFormatException("Could not write the image.");
+            });
+            break;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_PAGEEXPORTER_H
+#define PAINTERS_PAGEEXPORTER_H
+
+#include <formats/fileformat.h>
+
+class FileFormatManager;
+
+/// Exports the printed pages of the score, without requiring the score to be
+/// open in the editor. The pages are rendered in parallel.
+/// For the SVG and PNG formats, each page is written to a separate file (e.g.
+/// "song-2.png") unless the score fits onto a single page.
+class PageExporter : public FileFormatExporter
+{
+public:
+    enum class Output
+    {
+        Pdf,
+        Svg,
+        Png
+    };
+
+    explicit PageExporter(Output output);
+
+    /// Adds an exporter for each of the output formats.
+    static void registerFormats(FileFormatManager &manager);
+
+    virtual void save(const std::filesystem::path &filename,
+                      const Score &score) override;
+
+private:
+    const Output myOutput;
+};
+
+#endif
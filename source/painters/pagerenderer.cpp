@@ -0,0 +1,234 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pagerenderer.h"
+
+#include <app/viewoptions.h>
+#include <painters/scoreclickevent.h>
+#include <painters/scoreinforenderer.h>
+#include <painters/systemrenderer.h>
+#include <QGraphicsItem>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <score/score.h>
+#include <score/scorelocation.h>
+#include <score/system.h>
+#include <score/viewfilter.h>
+#include <util/threadpool.h>
+#include <util/tracing.h>
+
+#include <future>
+#include <memory>
+
+/// Vertical spacing between systems, which matches the score view.
+static const double theSystemSpacing = 50;
+
+/// Returns the height of the system, using the same stacking of the visible
+/// staves as SystemRenderer.
+static double getSystemHeight(const Score &score, int system_index,
+                              const ViewFilter *filter,
+                              const SystemLayout &layouts)
+{
+    double height = 0;
+    for (int i = 0, n = static_cast<int>(layouts.size()); i < n; ++i)
+    {
+        if (filter && !filter->accept(score, system_index, i))
+            continue;
+
+        if (height == 0)
+            height += layouts[i]->getSystemSymbolSpacing();
+
+        height += layouts[i]->getStaffHeight();
+    }
+
+    return height;
+}
+
+PageRenderer::PageRenderer(const Score &score, const ViewOptions &view_options,
+                           const QPalette &palette, const QSizeF &page_size,
+                           Util::ThreadPool &pool)
+    : myScore(score),
+      myViewOptions(view_options),
+      myPalette(palette),
+      myScale(page_size.width() / LayoutInfo::STAFF_WIDTH)
+{
+    PTE_TRACE_SCOPE("PageRenderer::PageRenderer");
+
+    const ViewFilter *filter =
+        myViewOptions.getFilter()
+            ? &myScore.getViewFilters()[*myViewOptions.getFilter()]
+            : nullptr;
+
+    // The bar number index is cached lazily, so build it before the pages are
+    // rendered from multiple threads.
+    score.getBarIndex();
+
+    // Compute the layouts of the visible staves in parallel.
+    const int num_systems = static_cast<int>(score.getSystems().size());
+    myLayouts.resize(num_systems);
+
+    std::vector<std::future<void>> tasks;
+    tasks.reserve(num_systems);
+    for (int i = 0; i < num_systems; ++i)
+    {
+        tasks.push_back(pool.submit([&, i]() {
+            PTE_TRACE_SCOPE("PageRenderer::computeLayout");
+
+            const System &system = myScore.getSystems()[i];
+            SystemLayout &layouts = myLayouts[i];
+            layouts.resize(system.getStaves().size());
+
+            for (int j = 0, n = static_cast<int>(layouts.size()); j < n; ++j)
+            {
+                if (!filter || filter->accept(myScore, i, j))
+                {
+                    layouts[j] = std::make_shared<LayoutInfo>(
+                        ConstScoreLocation(myScore, i, j));
+                }
+            }
+        }));
+    }
+
+    // Rethrow any errors from the tasks.
+    for (auto &&task : tasks)
+        task.get();
+
+    // Measure the score info block, which is rendered again for the first
+    // page.
+    double info_height = 0;
+    {
+        ScoreClickEvent click_event;
+        std::unique_ptr<QGraphicsItem> info(ScoreInfoRenderer::render(
+            myScore, myPalette.text().color(), click_event));
+        info_height = info->boundingRect().height();
+    }
+
+    // Place the items onto pages, as for printing from the score view.
+    double y = 0;
+    myPages.emplace_back();
+
+    auto add_item = [&](int item, double height, double spacing) {
+        // Skip empty items (e.g. if there is no score information).
+        if (height == 0.0)
+            return;
+
+        if (!myPages.back().empty())
+            y += spacing * myScale;
+
+        // Start a new page if the item doesn't fit.
+        height *= myScale;
+        if (!myPages.back().empty() && y + height > page_size.height())
+        {
+            myPages.emplace_back();
+            y = 0;
+        }
+
+        myPages.back().push_back({ item, y });
+        y += height;
+    };
+
+    add_item(theScoreInfo, info_height, 0);
+    for (int i = 0; i < num_systems; ++i)
+    {
+        add_item(i, getSystemHeight(myScore, i, filter, myLayouts[i]),
+                 i == 0 ? 0.5 * theSystemSpacing : theSystemSpacing);
+    }
+}
+
+int PageRenderer::getPageCount() const
+{
+    return static_cast<int>(myPages.size());
+}
+
+/// Draws the item and its children, where the transform maps scene
+/// coordinates to the device. QGraphicsScene::render() can't be used, since
+/// scenes must only be created on the GUI thread.
+static void paintItem(QPainter &painter, QGraphicsItem &item,
+                      const QTransform &transform)
+{
+    if (!item.isVisible())
+        return;
+
+    // The children are sorted by stacking order.
+    const QList<QGraphicsItem *> children = item.childItems();
+    auto it = children.begin();
+    for (; it != children.end() &&
+           ((*it)->flags() & QGraphicsItem::ItemStacksBehindParent);
+         ++it)
+    {
+        paintItem(painter, **it, transform);
+    }
+
+    // Without a scene, the scene transform maps the item's coordinates to its
+    // top-level item's parent coordinates.
+    painter.save();
+    painter.setTransform(item.sceneTransform() * transform);
+    painter.setOpacity(item.effectiveOpacity());
+
+    QStyleOptionGraphicsItem option;
+    option.exposedRect = item.boundingRect();
+    item.paint(&painter, &option, nullptr);
+    painter.restore();
+
+    for (; it != children.end(); ++it)
+        paintItem(painter, **it, transform);
+}
+
+void PageRenderer::renderPage(int page, QPainter &painter) const
+{
+    PTE_TRACE_SCOPE("PageRenderer::renderPage");
+
+    // The items are only clickable in the score view.
+    ScoreClickEvent click_event;
+
+    for (const PageItem &page_item : myPages[page])
+    {
+        std::unique_ptr<QGraphicsItem> item;
+        if (page_item.mySystem == theScoreInfo)
+        {
+            item.reset(ScoreInfoRenderer::render(
+                myScore, myPalette.text().color(), click_event));
+        }
+        else
+        {
+            // The layouts are shared with the other pages, so the renderer
+            // gets its own copy of the list.
+            SystemLayout layouts = myLayouts[page_item.mySystem];
+            SystemRenderer render(click_event, myPalette, myScore,
+                                  myViewOptions);
+            item.reset(render(myScore.getSystems()[page_item.mySystem],
+                              page_item.mySystem, layouts));
+        }
+
+        // Scale the item onto the page and clip it to its bounds, as
+        // QGraphicsScene::render() would.
+        const QRectF source_rect = item->sceneBoundingRect();
+        const QRectF target_rect(source_rect.left() * myScale, page_item.myY,
+                                 source_rect.width() * myScale,
+                                 source_rect.height() * myScale);
+
+        QTransform transform;
+        transform.translate(target_rect.left(), target_rect.top());
+        transform.scale(myScale, myScale);
+        transform.translate(-source_rect.left(), -source_rect.top());
+
+        painter.save();
+        painter.setClipRect(target_rect, Qt::IntersectClip);
+        paintItem(painter, *item, transform * painter.transform());
+        painter.restore();
+    }
+}
@@ -0,0 +1,73 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_PAGERENDERER_H
+#define PAINTERS_PAGERENDERER_H
+
+#include <painters/layoutinfo.h>
+#include <QPalette>
+#include <QSizeF>
+#include <vector>
+
+class QPainter;
+class Score;
+class ViewOptions;
+
+namespace Util
+{
+class ThreadPool;
+}
+
+/// Splits a score into pages for printing or exporting, without requiring a
+/// ScoreArea. The layouts are computed up front so that the pages can then be
+/// drawn independently, e.g. from multiple threads.
+class PageRenderer
+{
+public:
+    /// Computes the layout of each system in parallel using the thread pool,
+    /// and paginates the score for pages with the given size in device units.
+    PageRenderer(const Score &score, const ViewOptions &view_options,
+                 const QPalette &palette, const QSizeF &page_size,
+                 Util::ThreadPool &pool);
+
+    int getPageCount() const;
+
+    /// Draws the page onto the painter. This is safe to call concurrently for
+    /// different painters, and the score must not be modified meanwhile.
+    void renderPage(int page, QPainter &painter) const;
+
+private:
+    /// The score info block, or a system, and its offset from the top of the
+    /// page.
+    struct PageItem
+    {
+        int mySystem;
+        double myY;
+    };
+
+    static constexpr int theScoreInfo = -1;
+
+    const Score &myScore;
+    const ViewOptions &myViewOptions;
+    const QPalette myPalette;
+    /// Scale factor from the score's coordinates to the page.
+    double myScale;
+    std::vector<SystemLayout> myLayouts;
+    std::vector<std::vector<PageItem>> myPages;
+};
+
+#endif
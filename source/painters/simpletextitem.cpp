@@ -66,3 +66,15 @@ void SimpleTextItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *,
             break;
     }
 }
+
+void SimpleTextItem::setPen(const QPen &pen)
+{
+    myPen = pen;
+    update();
+}
+
+void SimpleTextItem::setBackground(const QBrush &background)
+{
+    myBackground = background;
+    update();
+}
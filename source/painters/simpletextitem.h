@@ -50,11 +50,17 @@ public:
                        const QStyleOptionGraphicsItem *option,
                        QWidget *widget) override;
 
+    const QPen &getPen() const { return myPen; }
+    void setPen(const QPen &pen);
+
+    const QBrush &getBackground() const { return myBackground; }
+    void setBackground(const QBrush &background);
+
 private:
     const QString myText;
     const QFont myFont;
-    const QPen myPen;
-    const QBrush myBackground;
+    QPen myPen;
+    QBrush myBackground;
     const TextAlignment myAlignment;
     QRectF myBoundingRect;
     double myAscent;
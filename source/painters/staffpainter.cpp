@@ -67,6 +67,12 @@ void StaffPainter::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
                         ScoreItemAction::Selected);
 }
 
+void StaffPainter::setStaffColor(const QColor &color)
+{
+    myStaffColor = color;
+    update();
+}
+
 void StaffPainter::paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                          QWidget *)
 {
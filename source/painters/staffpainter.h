@@ -42,6 +42,9 @@ public:
         return myBounds;
     }
 
+    const QColor &getStaffColor() const { return myStaffColor; }
+    void setStaffColor(const QColor &color);
+
 protected:
     virtual void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
     virtual void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
@@ -55,7 +58,7 @@ private:
     const ScoreClickEvent &myClickEvent;
     ConstScoreLocation myLocation;
     const QRectF myBounds;
-    const QColor myStaffColor;
+    QColor myStaffColor;
 };
 
 #endif
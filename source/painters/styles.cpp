@@ -17,9 +17,176 @@
 
 #include "styles.h"
 
+#include <optional>
+#include <painters/barlinepainter.h>
+#include <painters/simpletextitem.h>
+#include <painters/staffpainter.h>
 #include <QColor>
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QGraphicsTextItem>
+#include <QImage>
+#include <QPalette>
+#include <QPen>
+#include <QPixmap>
+#include <utility>
+#include <vector>
+
+namespace
+{
+/// Maps each color from the old palette to the same role in the new palette.
+class ColorMap
+{
+public:
+    ColorMap(const QPalette &old_palette, const QPalette &new_palette)
+    {
+        add(old_palette.text().color(), new_palette.text().color());
+        add(old_palette.light().color(), new_palette.light().color());
+        add(old_palette.dark().color(), new_palette.dark().color());
+        add(Styles::getStaffColor(old_palette),
+            Styles::getStaffColor(new_palette));
+
+        myTextColor = new_palette.text().color();
+        myIsTextChanged =
+            old_palette.text().color() != new_palette.text().color();
+    }
+
+    bool isEmpty() const { return myColors.empty(); }
+
+    std::optional<QColor> find(const QColor &color) const
+    {
+        const QRgb rgba = color.rgba();
+        for (auto &&[old_color, new_color] : myColors)
+        {
+            if (old_color == rgba)
+                return new_color;
+        }
+
+        return std::nullopt;
+    }
+
+    QPen map(QPen pen) const
+    {
+        if (auto color = find(pen.color()))
+            pen.setColor(*color);
+        return pen;
+    }
+
+    QBrush map(QBrush brush) const
+    {
+        if (auto color = find(brush.color()))
+            brush.setColor(*color);
+        return brush;
+    }
+
+    const QColor &getTextColor() const { return myTextColor; }
+    bool isTextChanged() const { return myIsTextChanged; }
+
+private:
+    void add(const QColor &old_color, const QColor &new_color)
+    {
+        if (old_color != new_color)
+            myColors.emplace_back(old_color.rgba(), new_color);
+    }
+
+    std::vector<std::pair<QRgb, QColor>> myColors;
+    QColor myTextColor;
+    bool myIsTextChanged = false;
+};
+} // namespace
 
 namespace Styles
 {
 const QColor SelectionColor(168, 205, 241, 125);
+
+QPalette getLightPalette()
+{
+    QPalette palette;
+    palette.setColor(QPalette::Base, Qt::white);
+    palette.setColor(QPalette::Text, Qt::black);
+    palette.setColor(QPalette::Light, Qt::white);
+    palette.setColor(QPalette::Dark, Qt::lightGray);
+    return palette;
+}
+
+QColor getStaffColor(const QPalette &palette)
+{
+    // Ratio of the background color in the weighted average.
+    const double weight = 0.7;
+
+    int r1, g1, b1;
+    palette.text().color().getRgb(&r1, &g1, &b1);
+    int r2, g2, b2;
+    palette.light().color().getRgb(&r2, &g2, &b2);
+
+    return QColor(r2 * weight + r1 * (1 - weight),
+                  g2 * weight + g1 * (1 - weight),
+                  b2 * weight + b1 * (1 - weight));
+}
+
+QPixmap tintPixmap(const QPixmap &pixmap, const QColor &color)
+{
+    QImage image = pixmap.toImage();
+    QColor pixel_color(color);
+    for (int y = 0; y < image.height(); ++y)
+    {
+        for (int x = 0; x < image.width(); ++x)
+        {
+            pixel_color.setAlpha(image.pixelColor(x, y).alpha());
+            image.setPixelColor(x, y, pixel_color);
+        }
+    }
+
+    return QPixmap::fromImage(image);
+}
+
+void applyPalette(QGraphicsScene &scene, const QPalette &old_palette,
+                  const QPalette &new_palette)
+{
+    const ColorMap colors(old_palette, new_palette);
+    if (colors.isEmpty())
+        return;
+
+    for (QGraphicsItem *item : scene.items())
+    {
+        if (auto shape = dynamic_cast<QAbstractGraphicsShapeItem *>(item))
+        {
+            shape->setPen(colors.map(shape->pen()));
+            shape->setBrush(colors.map(shape->brush()));
+        }
+        else if (auto line = qgraphicsitem_cast<QGraphicsLineItem *>(item))
+            line->setPen(colors.map(line->pen()));
+        else if (auto text = qgraphicsitem_cast<QGraphicsTextItem *>(item))
+        {
+            if (auto color = colors.find(text->defaultTextColor()))
+                text->setDefaultTextColor(*color);
+        }
+        else if (auto pixmap = qgraphicsitem_cast<QGraphicsPixmapItem *>(item))
+        {
+            // The only images in the score are symbols drawn in the text
+            // color.
+            if (colors.isTextChanged())
+            {
+                pixmap->setPixmap(
+                    tintPixmap(pixmap->pixmap(), colors.getTextColor()));
+            }
+        }
+        else if (auto simple_text = dynamic_cast<SimpleTextItem *>(item))
+        {
+            simple_text->setPen(colors.map(simple_text->getPen()));
+            simple_text->setBackground(
+                colors.map(simple_text->getBackground()));
+        }
+        else if (auto staff = dynamic_cast<StaffPainter *>(item))
+        {
+            if (auto color = colors.find(staff->getStaffColor()))
+                staff->setStaffColor(*color);
+        }
+        else if (auto barline = dynamic_cast<BarlinePainter *>(item))
+        {
+            if (auto color = colors.find(barline->getBarlineColor()))
+                barline->setBarlineColor(*color);
+        }
+    }
 }
+} // namespace Styles
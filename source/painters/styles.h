@@ -20,9 +20,31 @@
 
 #include <QColor>
 
+class QGraphicsScene;
+class QPalette;
+class QPixmap;
+
 namespace Styles
 {
 extern const QColor SelectionColor;
+
+/// Returns the palette for the light theme, which is also used for printing
+/// and exporting.
+QPalette getLightPalette();
+
+/// Returns the color for staff lines. This is a blend of the text and
+/// background colors, which works well with different palettes.
+QColor getStaffColor(const QPalette &palette);
+
+/// Returns a copy of a symbol's image drawn in the given color, keeping the
+/// image's transparency.
+QPixmap tintPixmap(const QPixmap &pixmap, const QColor &color);
+
+/// Changes the colors of the items in a rendered scene from the old palette
+/// to the new palette. This only requires a repaint, rather than laying out
+/// and rendering the score again.
+void applyPalette(QGraphicsScene &scene, const QPalette &old_palette,
+                  const QPalette &new_palette);
 }
 
 #endif
@@ -17,7 +17,6 @@
 
 #include "systemrenderer.h"
 
-#include <app/scorearea.h>
 #include <app/viewoptions.h>
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/find_if.hpp>
@@ -29,9 +28,11 @@
 #include <painters/simpletextitem.h>
 #include <painters/staffpainter.h>
 #include <painters/stdnotationnote.h>
+#include <painters/styles.h>
 #include <painters/timesignaturepainter.h>
 #include <painters/verticallayout.h>
 #include <QBrush>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QGraphicsItem>
 #include <QPen>
@@ -41,6 +42,7 @@
 #include <score/utils.h>
 #include <score/voiceutils.h>
 #include <util/tostring.h>
+#include <util/tracing.h>
 
 #include <algorithm>
 
@@ -58,9 +60,10 @@ void SystemRenderer::centerSymbolVertically(QGraphicsItem &item, double y)
                          item.boundingRect().height()));
 }
 
-SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
+SystemRenderer::SystemRenderer(const ScoreClickEvent &click_event,
+                               const QPalette &palette, const Score &score,
                                const ViewOptions &view_options)
-    : myScoreArea(score_area),
+    : myClickEvent(click_event),
       myScore(score),
       myViewOptions(view_options),
       myParentSystem(nullptr),
@@ -69,19 +72,21 @@ SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
       myMusicFontMetrics(myMusicNotationFont),
       myPlainTextFont(QStringLiteral("Liberation Sans")),
       mySymbolTextFont(QStringLiteral("Liberation Sans")),
-      myRehearsalSignFont(QStringLiteral("Helvetica"))
+      myRehearsalSignFont(QStringLiteral("Helvetica")),
+      myPalette(palette)
 {
     myPlainTextFont.setPixelSize(10);
     myPlainTextFont.setStyleStrategy(QFont::PreferAntialias);
     mySymbolTextFont.setPixelSize(9);
     myRehearsalSignFont.setPixelSize(12);
-
-    myPalette = *myScoreArea->getPalette();
 }
 
 QGraphicsItem *SystemRenderer::operator()(const System &system,
-                                          int systemIndex)
+                                          int systemIndex,
+                                          SystemLayout &layouts)
 {
+    PTE_TRACE_SCOPE("SystemRenderer");
+
     // Draw the bounding rectangle for the system.
     myParentSystem = new QGraphicsRectItem();
     myParentSystem->setPen(QPen(myPalette.text(), 0.5));
@@ -91,6 +96,8 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
             ? &myScore.getViewFilters()[*myViewOptions.getFilter()]
             : nullptr;
 
+    layouts.resize(system.getStaves().size());
+
     // Draw each staff.
     double height = 0;
     int i = 0;
@@ -104,7 +111,9 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
 
         const bool isFirstStaff = (height == 0);
         const ConstScoreLocation location(myScore, systemIndex, i);
-        LayoutConstPtr layout = std::make_shared<LayoutInfo>(location);
+        LayoutConstPtr &layout = layouts[i];
+        if (!layout)
+            layout = std::make_shared<LayoutInfo>(location);
 
         if (isFirstStaff)
         {
@@ -112,27 +121,9 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
             height += layout->getSystemSymbolSpacing();
         }
 
-        // set a custom color for the staff, depending on
-        // the background color and the text/note color
-        // getting the staff color as an average of both colors
-        // ensures flexibility with different palettes
-        
-        //rgb value for text
-        int r1, g1, b1; 
-        //rgb value for background 
-        int r2, g2, b2; //rgb value for background
-        //ratio of the background color in the weighted average
-        double avgWeight = 0.7; 
-
-        myPalette.text().color().getRgb(&r1,&g1,&b1);
-        myPalette.light().color().getRgb(&r2,&g2,&b2);
-
-        QColor staffColor(r2*avgWeight+r1*(1-avgWeight),
-                    g2*avgWeight+g1*(1-avgWeight), 
-                    b2*avgWeight+b1*(1-avgWeight));
-
         myParentStaff = new StaffPainter(
-            layout, location, myScoreArea->getClickEvent(), staffColor);
+            layout, location, myClickEvent,
+            Styles::getStaffColor(myPalette));
         myParentStaff->setPos(0, height);
         myParentStaff->setParentItem(myParentSystem);
         height += layout->getStaffHeight();
@@ -152,8 +143,9 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
                                            clef_font, TextAlignment::Baseline,
                                            QPen(myPalette.text().color()));
         auto group = new ClickableGroup(
-            ScoreArea::tr("Double-click to change clef type."),
-            myScoreArea->getClickEvent(), location, ScoreItem::Clef);
+            QCoreApplication::translate(
+                "ScoreArea", "Double-click to change clef type."),
+            myClickEvent, location, ScoreItem::Clef);
         group->addToGroup(clef);
         group->setPos(LayoutInfo::CLEF_PADDING, clef_y);
         group->setParentItem(myParentStaff);
@@ -194,8 +186,9 @@ void SystemRenderer::drawTabClef(double x, const LayoutInfo &layout,
     auto clef = new SimpleTextItem(QChar(MusicFont::TabClef), font, TextAlignment::Baseline, QPen(myPalette.text().color()));
 
     auto group = new ClickableGroup(
-        ScoreArea::tr("Double-click to edit the number of strings."),
-        myScoreArea->getClickEvent(), location, ScoreItem::Clef);
+        QCoreApplication::translate(
+            "ScoreArea", "Double-click to edit the number of strings."),
+        myClickEvent, location, ScoreItem::Clef);
     group->addToGroup(clef);
 
     // Position the clef symbol. The middle of the 'A' is aligned with the
@@ -206,12 +199,7 @@ void SystemRenderer::drawTabClef(double x, const LayoutInfo &layout,
 
 void SystemRenderer::drawBarNumber(int systemIndex, const LayoutInfo &layout)
 {
-    int number = 1;
-    for (int i = 0; i < systemIndex; ++i)
-    {
-        const System &system = myScore.getSystems()[i];
-        number += static_cast<int>(system.getBarlines().size()) - 1;
-    }
+    const int number = myScore.getBarIndex().getFirstBarNumber(systemIndex);
 
     auto text = new SimpleTextItem(QString::number(number), myPlainTextFont,TextAlignment::Top ,QPen(myPalette.text().color()));
     text->setPos(-text->boundingRect().width() - LayoutInfo::BAR_NUMBER_PADDING,
@@ -233,7 +221,7 @@ SystemRenderer::drawBarlines(const ConstScoreLocation &location,
         const TimeSignature &timeSig = barline.getTimeSignature();
 
         BarlinePainter *barlinePainter = new BarlinePainter(
-            layout, barline, bar_location, myScoreArea->getClickEvent(),
+            layout, barline, bar_location, myClickEvent,
             myPalette.text().color());
 
         double x = layout->getPositionX(barline.getPosition());
@@ -280,7 +268,7 @@ SystemRenderer::drawBarlines(const ConstScoreLocation &location,
         if (keySig.isVisible())
         {
             auto keySigPainter = new KeySignaturePainter(
-                layout, keySig, bar_location, myScoreArea->getClickEvent());
+                layout, keySig, bar_location, myClickEvent);
 
             keySigPainter->setPos(keySigX, layout->getTopStdNotationLine());
             keySigPainter->setParentItem(myParentStaff);
@@ -289,7 +277,7 @@ SystemRenderer::drawBarlines(const ConstScoreLocation &location,
         if (timeSig.isVisible())
         {
             auto timeSigPainter = new TimeSignaturePainter(
-                layout, timeSig, bar_location, myScoreArea->getClickEvent());
+                layout, timeSig, bar_location, myClickEvent);
 
             timeSigPainter->setPos(timeSigX, layout->getTopStdNotationLine());
             timeSigPainter->setParentItem(myParentStaff);
@@ -301,8 +289,9 @@ SystemRenderer::drawBarlines(const ConstScoreLocation &location,
             static constexpr int RECTANGLE_OFFSET = 4;
 
             auto group = new ClickableGroup(
-                ScoreArea::tr("Double-click to edit rehearsal sign."),
-                myScoreArea->getClickEvent(), bar_location,
+                QCoreApplication::translate(
+                    "ScoreArea", "Double-click to edit rehearsal sign."),
+                myClickEvent, bar_location,
                 ScoreItem::RehearsalSign);
 
             auto signLetters = new SimpleTextItem(
@@ -500,8 +489,9 @@ SystemRenderer::drawAlternateEndings(const ConstScoreLocation &location,
         ending_location.setPositionIndex(ending.getPosition());
 
         auto group = new ClickableGroup(
-            ScoreArea::tr("Double-click to edit repeat endings."),
-            myScoreArea->getClickEvent(), ending_location,
+            QCoreApplication::translate(
+                "ScoreArea", "Double-click to edit repeat endings."),
+            myClickEvent, ending_location,
             ScoreItem::AlternateEnding);
 
         // Draw the vertical line.
@@ -630,8 +620,9 @@ SystemRenderer::drawTempoMarkers(const ConstScoreLocation &location,
         ConstScoreLocation marker_location(location);
         marker_location.setPositionIndex(tempo.getPosition());
         auto group = new ClickableGroup(
-            ScoreArea::tr("Double-click to edit tempo marker."),
-            myScoreArea->getClickEvent(), marker_location,
+            QCoreApplication::translate(
+                "ScoreArea", "Double-click to edit tempo marker."),
+            myClickEvent, marker_location,
             tempo.getMarkerType() == TempoMarker::AlterationOfPace
                 ? ScoreItem::AlterationOfPace
                 : ScoreItem::TempoMarker);
@@ -656,22 +647,11 @@ SystemRenderer::drawTempoMarkers(const ConstScoreLocation &location,
             const QString imageSpacing(3, ' ');
             const double NOTE_HEIGHT = 16;
 
-            // Add the beat type image.
+            // Add the beat type image, drawn with the theme's text color.
             QFontMetricsF fm(font);
-            QPixmap image(getBeatTypeImage(tempo.getBeatType()));
-
-            //set the color of the beat type image according to theme
-            QImage tmp = image.toImage();
-            QColor color(myPalette.text().color());
-            for(int y = 0; y < tmp.height(); y++)
-            {
-                for(int x= 0; x < tmp.width(); x++)
-                {
-                    color.setAlpha(tmp.pixelColor(x,y).alpha());
-                    tmp.setPixelColor(x,y,color);
-                }
-            }
-            image = QPixmap::fromImage(tmp);
+            const QPixmap image = Styles::tintPixmap(
+                QPixmap(getBeatTypeImage(tempo.getBeatType())),
+                myPalette.text().color());
 
             auto pixmap = new QGraphicsPixmapItem(image.scaled(
                 fm.width(imageSpacing), NOTE_HEIGHT,
@@ -686,7 +666,9 @@ SystemRenderer::drawTempoMarkers(const ConstScoreLocation &location,
             if (tempo.getMarkerType() == TempoMarker::ListessoMarker)
             {
                 // Add the second beat type image.
-                QPixmap image(getBeatTypeImage(tempo.getListessoBeatType()));
+                QPixmap image = Styles::tintPixmap(
+                    QPixmap(getBeatTypeImage(tempo.getListessoBeatType())),
+                    myPalette.text().color());
                 auto pixmap = new QGraphicsPixmapItem(image.scaled(
                     fm.width(imageSpacing), NOTE_HEIGHT,
                     Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
@@ -705,7 +687,9 @@ SystemRenderer::drawTempoMarkers(const ConstScoreLocation &location,
                 text += QStringLiteral(" ( ");
 
                 const QString imageSpacing(12, ' ');
-                QPixmap image(getTripletFeelImage(tempo));
+                QPixmap image =
+                    Styles::tintPixmap(QPixmap(getTripletFeelImage(tempo)),
+                                       myPalette.text().color());
                 pixmap = new QGraphicsPixmapItem(image.scaled(
                     fm.width(imageSpacing), 21,
                     Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
@@ -737,8 +721,9 @@ SystemRenderer::drawChordText(const ConstScoreLocation &location,
         ConstScoreLocation item_location(location);
         item_location.setPositionIndex(chord.getPosition());
         auto group = new ClickableGroup(
-            ScoreArea::tr("Double-click to edit chord text."),
-            myScoreArea->getClickEvent(), item_location, ScoreItem::ChordText);
+            QCoreApplication::translate(
+                "ScoreArea", "Double-click to edit chord text."),
+            myClickEvent, item_location, ScoreItem::ChordText);
 
         const std::string text = Util::toString(chord.getChordName());
         auto textItem = new SimpleTextItem(QString::fromStdString(text),
@@ -763,8 +748,9 @@ SystemRenderer::drawTextItems(const ConstScoreLocation &location,
         ConstScoreLocation item_location(location);
         item_location.setPositionIndex(text.getPosition());
         auto group = new ClickableGroup(
-            ScoreArea::tr("Double-click to edit text."),
-            myScoreArea->getClickEvent(), item_location, ScoreItem::TextItem);
+            QCoreApplication::translate(
+                "ScoreArea", "Double-click to edit text."),
+            myClickEvent, item_location, ScoreItem::TextItem);
 
         // Note: the SimpleTextItem class is not used here since multi-line
         // support is needed.
@@ -933,8 +919,9 @@ SystemRenderer::drawPlayerChanges(const ConstScoreLocation &location,
         ConstScoreLocation change_location(location);
         change_location.setPositionIndex(change.getPosition());
         auto group = new ClickableGroup(
-            ScoreArea::tr("Double-click to edit the active players."),
-            myScoreArea->getClickEvent(), change_location,
+            QCoreApplication::translate(
+                "ScoreArea", "Double-click to edit the active players."),
+            myClickEvent, change_location,
             ScoreItem::PlayerChange);
 
         QString description;
@@ -1386,8 +1373,9 @@ SystemRenderer::createVolumeSwell(const ConstScoreLocation &location,
     path.lineTo(end_x, (1.0 - padding) * LayoutInfo::TAB_SYMBOL_SPACING);
 
     auto path_item = new ClickableItemT<QGraphicsPathItem>(
-        ScoreArea::tr("Double-click to edit volume swell."),
-        myScoreArea->getClickEvent(), swell_location, ScoreItem::VolumeSwell);
+        QCoreApplication::translate(
+            "ScoreArea", "Double-click to edit volume swell."),
+        myClickEvent, swell_location, ScoreItem::VolumeSwell);
     path_item->setPath(path);
     path_item->setPen(myPalette.text().color());
     return path_item;
@@ -1406,8 +1394,9 @@ SystemRenderer::createTremoloBar(const ConstScoreLocation &location,
     ConstScoreLocation trem_location(location);
     trem_location.setPositionIndex(pos->getPosition());
     auto group = new ClickableGroup(
-        ScoreArea::tr("Double-click to edit tremolo bar."),
-        myScoreArea->getClickEvent(), trem_location, ScoreItem::TremoloBar);
+        QCoreApplication::translate(
+            "ScoreArea", "Double-click to edit tremolo bar."),
+        myClickEvent, trem_location, ScoreItem::TremoloBar);
 
     double x_start = 0;
     double x_end = symbol_group.getWidth();
@@ -1581,8 +1570,9 @@ SystemRenderer::createDynamic(const ConstScoreLocation &location,
     ConstScoreLocation item_location(location);
     item_location.setPositionIndex(dynamic->getPosition());
     auto group = new ClickableGroup(
-        ScoreArea::tr("Double-click to edit dynamic."),
-        myScoreArea->getClickEvent(), item_location, ScoreItem::Dynamic);
+        QCoreApplication::translate(
+            "ScoreArea", "Double-click to edit dynamic."),
+        myClickEvent, item_location, ScoreItem::Dynamic);
     group->addToGroup(textItem);
     return group;
 }
@@ -1924,8 +1914,9 @@ SystemRenderer::drawMultiBarRest(const ConstScoreLocation &location,
                    LayoutInfo::STAFF_WIDTH - layout.getPositionSpacing() / 2.0);
 
     auto group = new ClickableGroup(
-        ScoreArea::tr("Double-click to edit multi-bar rest."),
-        myScoreArea->getClickEvent(), location, ScoreItem::MultiBarRest);
+        QCoreApplication::translate(
+            "ScoreArea", "Double-click to edit multi-bar rest."),
+        myClickEvent, location, ScoreItem::MultiBarRest);
 
     // Draw the measure count.
     auto measureCountText = new SimpleTextItem(
@@ -2177,8 +2168,9 @@ SystemRenderer::createBendGroup(const ConstScoreLocation &location,
             bend_location.setString(note.getString());
 
             auto bend_group = new ClickableGroup(
-                ScoreArea::tr("Double-click to edit bend."),
-                myScoreArea->getClickEvent(), bend_location, ScoreItem::Bend);
+                QCoreApplication::translate(
+                    "ScoreArea", "Double-click to edit bend."),
+                myClickEvent, bend_location, ScoreItem::Bend);
 
             const Bend &bend = note.getBend();
             const Bend::BendType type = bend.getType();
@@ -29,7 +29,7 @@ class QGraphicsItem;
 class QGraphicsItemGroup;
 class QGraphicsRectItem;
 class Score;
-class ScoreArea;
+class ScoreClickEvent;
 class ScoreLocation;
 class System;
 class ViewOptions;
@@ -37,10 +37,15 @@ class ViewOptions;
 class SystemRenderer
 {
 public:
-    SystemRenderer(const ScoreArea *score_area, const Score &score,
-                   const ViewOptions &view_options);
+    SystemRenderer(const ScoreClickEvent &click_event, const QPalette &palette,
+                   const Score &score, const ViewOptions &view_options);
 
-    QGraphicsItem *operator()(const System &system, int systemIndex);
+    /// Renders the system. Any layouts in the list (e.g. computed in advance)
+    /// are used instead of computing the layout from scratch, and the list is
+    /// filled in with the layouts of the other visible staves so that they can
+    /// be retained by the caller.
+    QGraphicsItem *operator()(const System &system, int systemIndex,
+                              SystemLayout &layouts);
 
 private:
     /// Draws the tab clef.
@@ -204,7 +209,7 @@ private:
     void drawSlide(const LayoutInfo &layout, int string, bool slideUp,
                    int position1, int position2) const;
 
-    const ScoreArea *myScoreArea;
+    const ScoreClickEvent &myClickEvent;
     const Score &myScore;
     const ViewOptions &myViewOptions;
 
@@ -0,0 +1,384 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_BINARYSERIALIZATION_H
+#define SCORE_BINARYSERIALIZATION_H
+
+#include <array>
+#include <bitset>
+#include <cstring>
+#include "fileversion.h"
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <util/date.h>
+#include <vector>
+
+/// A compact binary encoding of score objects, using the same serialize()
+/// methods as the JSON file format. Fields are written in order without their
+/// names, and integers are stored as variable-length integers.
+/// Unlike the JSON format, the data can only be read if it was written with a
+/// known file version, so this is intended for short-lived data such as the
+/// clipboard rather than for saving files.
+namespace ScoreUtils
+{
+namespace detail
+{
+    constexpr std::string_view BINARY_MAGIC = "PTEB";
+
+    class BinaryOutputArchive
+    {
+    public:
+        explicit BinaryOutputArchive(std::string &output) : myOutput(output)
+        {
+        }
+
+        template <typename T>
+        void operator()(const std::string_view & /*name*/, const T &obj)
+        {
+            write(obj);
+        }
+
+    private:
+        void writeVarint(uint64_t val)
+        {
+            while (val >= 0x80)
+            {
+                myOutput.push_back(static_cast<char>((val & 0x7f) | 0x80));
+                val >>= 7;
+            }
+
+            myOutput.push_back(static_cast<char>(val));
+        }
+
+        void write(const std::string &str)
+        {
+            writeVarint(str.size());
+            myOutput.append(str);
+        }
+
+        void write(const Util::Date &date)
+        {
+            write(date.year());
+            write(date.month());
+            write(date.day());
+        }
+
+        template <typename T>
+        void write(const std::vector<T> &vec)
+        {
+            writeVarint(vec.size());
+            for (const T &obj : vec)
+                write(obj);
+        }
+
+        template <typename K, typename V, typename C>
+        void write(const std::map<K, V, C> &map)
+        {
+            writeVarint(map.size());
+            for (auto &&[key, value] : map)
+            {
+                write(key);
+                write(value);
+            }
+        }
+
+        template <typename T, size_t N>
+        void write(const std::array<T, N> &arr)
+        {
+            for (const T &obj : arr)
+                write(obj);
+        }
+
+        template <size_t N>
+        void write(const std::bitset<N> &bits)
+        {
+            for (size_t i = 0; i < N; i += 8)
+            {
+                uint8_t byte = 0;
+                for (size_t j = i; j < std::min(N, i + 8); ++j)
+                    byte |= bits[j] << (j - i);
+
+                myOutput.push_back(static_cast<char>(byte));
+            }
+        }
+
+        template <typename T>
+        void write(const std::optional<T> &val)
+        {
+            write(val.has_value());
+            if (val)
+                write(*val);
+        }
+
+        template <typename T>
+        void write(const T &obj)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                myOutput.push_back(obj ? 1 : 0);
+            else if constexpr (std::is_enum_v<T>)
+                write(static_cast<std::underlying_type_t<T>>(obj));
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                // Zigzag encoding, so that small negative numbers are also
+                // compact.
+                const auto val = static_cast<int64_t>(obj);
+                writeVarint((static_cast<uint64_t>(val) << 1) ^
+                            static_cast<uint64_t>(val >> 63));
+            }
+            else if constexpr (std::is_integral_v<T>)
+                writeVarint(obj);
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                char bytes[sizeof(T)];
+                std::memcpy(bytes, &obj, sizeof(T));
+                myOutput.append(bytes, sizeof(T));
+            }
+            else // score objects.
+            {
+                const_cast<T &>(obj).serialize(*this,
+                                               FileVersion::LATEST_VERSION);
+            }
+        }
+
+        std::string &myOutput;
+    };
+
+    class BinaryInputArchive
+    {
+    public:
+        /// Reads the header from the data.
+        /// @throws std::runtime_error if the data is not in the binary format
+        /// or was written by a newer version.
+        explicit BinaryInputArchive(std::string_view data) : myData(data)
+        {
+            if (myData.substr(0, BINARY_MAGIC.size()) != BINARY_MAGIC)
+                throwInvalidData();
+            myPos = BINARY_MAGIC.size();
+
+            int version = 0;
+            read(version);
+            if (version < static_cast<int>(FileVersion::INITIAL_VERSION) ||
+                version > static_cast<int>(FileVersion::LATEST_VERSION))
+            {
+                throw std::runtime_error(
+                    "Unsupported binary score data version");
+            }
+            myVersion = static_cast<FileVersion>(version);
+        }
+
+        template <typename T>
+        void operator()(const std::string_view & /*name*/, T &obj)
+        {
+            read(obj);
+        }
+
+        bool atEnd() const
+        {
+            return myPos == myData.size();
+        }
+
+    private:
+        [[noreturn]] static void throwInvalidData()
+        {
+            throw std::runtime_error("Invalid binary score data");
+        }
+
+        uint8_t readByte()
+        {
+            if (myPos >= myData.size())
+                throwInvalidData();
+
+            return static_cast<uint8_t>(myData[myPos++]);
+        }
+
+        uint64_t readVarint()
+        {
+            uint64_t val = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                const uint8_t byte = readByte();
+                val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return val;
+            }
+
+            throwInvalidData();
+        }
+
+        /// Reads the number of items in a container. Every item uses at least
+        /// one byte, which avoids huge allocations for corrupt data.
+        size_t readSize()
+        {
+            const uint64_t size = readVarint();
+            if (size > myData.size() - myPos)
+                throwInvalidData();
+
+            return static_cast<size_t>(size);
+        }
+
+        void read(std::string &str)
+        {
+            const size_t size = readSize();
+            str.assign(myData.data() + myPos, size);
+            myPos += size;
+        }
+
+        void read(Util::Date &date)
+        {
+            int year, month, day;
+            read(year);
+            read(month);
+            read(day);
+            date = Util::Date(year, month, day);
+        }
+
+        template <typename T>
+        void read(std::vector<T> &vec)
+        {
+            vec.clear();
+            vec.resize(readSize());
+            for (T &obj : vec)
+                read(obj);
+        }
+
+        template <typename K, typename V, typename C>
+        void read(std::map<K, V, C> &map)
+        {
+            map.clear();
+            const size_t size = readSize();
+            for (size_t i = 0; i < size; ++i)
+            {
+                K key;
+                read(key);
+                read(map[key]);
+            }
+        }
+
+        template <typename T, size_t N>
+        void read(std::array<T, N> &arr)
+        {
+            for (T &obj : arr)
+                read(obj);
+        }
+
+        template <size_t N>
+        void read(std::bitset<N> &bits)
+        {
+            bits.reset();
+            for (size_t i = 0; i < N; i += 8)
+            {
+                const uint8_t byte = readByte();
+                for (size_t j = i; j < std::min(N, i + 8); ++j)
+                    bits[j] = (byte >> (j - i)) & 1;
+            }
+        }
+
+        template <typename T>
+        void read(std::optional<T> &val)
+        {
+            bool has_value = false;
+            read(has_value);
+            if (has_value)
+            {
+                T data;
+                read(data);
+                val = data;
+            }
+            else
+                val.reset();
+        }
+
+        template <typename T>
+        void read(T &obj)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                obj = readByte() != 0;
+            else if constexpr (std::is_enum_v<T>)
+            {
+                std::underlying_type_t<T> val;
+                read(val);
+                obj = static_cast<T>(val);
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                const uint64_t encoded = readVarint();
+                const auto val = static_cast<int64_t>(encoded >> 1) ^
+                                 -static_cast<int64_t>(encoded & 1);
+                if (val < std::numeric_limits<T>::min() ||
+                    val > std::numeric_limits<T>::max())
+                {
+                    throw std::overflow_error("Invalid integer value");
+                }
+                obj = static_cast<T>(val);
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                const uint64_t val = readVarint();
+                if (val > std::numeric_limits<T>::max())
+                    throw std::overflow_error("Invalid integer value");
+                obj = static_cast<T>(val);
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                if (myData.size() - myPos < sizeof(T))
+                    throwInvalidData();
+                std::memcpy(&obj, myData.data() + myPos, sizeof(T));
+                myPos += sizeof(T);
+            }
+            else // score objects.
+                obj.serialize(*this, myVersion);
+        }
+
+        std::string_view myData;
+        size_t myPos = 0;
+        FileVersion myVersion = FileVersion::LATEST_VERSION;
+    };
+} // namespace detail
+
+/// Saves the object in the binary format.
+template <typename T>
+std::string
+saveBinary(const T &obj)
+{
+    std::string output(detail::BINARY_MAGIC);
+    detail::BinaryOutputArchive ar(output);
+    ar("version", static_cast<int>(FileVersion::LATEST_VERSION));
+    ar("data", obj);
+    return output;
+}
+
+/// Loads an object that was saved with saveBinary().
+/// @throws std::runtime_error if the data is invalid or was written by a newer
+/// version.
+template <typename T>
+void
+loadBinary(std::string_view data, T &obj)
+{
+    detail::BinaryInputArchive ar(data);
+    ar("data", obj);
+
+    if (!ar.atEnd())
+        throw std::runtime_error("Invalid binary score data");
+}
+} // namespace ScoreUtils
+
+#endif
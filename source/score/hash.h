@@ -0,0 +1,156 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_HASH_H
+#define SCORE_HASH_H
+
+#include <array>
+#include <bitset>
+#include <boost/functional/hash.hpp>
+#include "fileversion.h"
+#include <map>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <util/date.h>
+#include <vector>
+
+namespace ScoreUtils
+{
+namespace detail
+{
+    /// Detects score objects which cache a hash of their contents (e.g.
+    /// voices and staves), so that a parent's hash can be combined from the
+    /// hashes of its children without revisiting their contents.
+    template <typename T, typename = void>
+    struct HasCachedHash : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct HasCachedHash<
+        T, std::void_t<decltype(std::declval<const T &>().getHash())>>
+        : std::true_type
+    {
+    };
+
+    /// Archive which combines an object's fields into a hash. This uses the
+    /// same serialize() methods as for saving files, so that no fields are
+    /// missed.
+    class HashArchive
+    {
+    public:
+        template <typename T>
+        void operator()(const std::string_view & /*name*/, const T &obj)
+        {
+            add(obj);
+        }
+
+        size_t value() const
+        {
+            return mySeed;
+        }
+
+    private:
+        void add(const std::string &str)
+        {
+            boost::hash_combine(mySeed, str);
+        }
+
+        void add(const Util::Date &date)
+        {
+            boost::hash_combine(mySeed, date.year());
+            boost::hash_combine(mySeed, date.month());
+            boost::hash_combine(mySeed, date.day());
+        }
+
+        template <typename T>
+        void add(const std::vector<T> &vec)
+        {
+            boost::hash_combine(mySeed, vec.size());
+            for (const T &obj : vec)
+                add(obj);
+        }
+
+        template <typename K, typename V, typename C>
+        void add(const std::map<K, V, C> &map)
+        {
+            boost::hash_combine(mySeed, map.size());
+            for (auto &&[key, value] : map)
+            {
+                add(key);
+                add(value);
+            }
+        }
+
+        template <typename T, size_t N>
+        void add(const std::array<T, N> &arr)
+        {
+            for (const T &obj : arr)
+                add(obj);
+        }
+
+        template <size_t N>
+        void add(const std::bitset<N> &bits)
+        {
+            boost::hash_combine(mySeed, std::hash<std::bitset<N>>()(bits));
+        }
+
+        template <typename T>
+        void add(const std::optional<T> &val)
+        {
+            boost::hash_combine(mySeed, val.has_value());
+            if (val)
+                add(*val);
+        }
+
+        template <typename T>
+        void add(const T &obj)
+        {
+            if constexpr (std::is_enum_v<T>)
+            {
+                boost::hash_combine(
+                    mySeed, static_cast<std::underlying_type_t<T>>(obj));
+            }
+            else if constexpr (std::is_arithmetic_v<T>)
+                boost::hash_combine(mySeed, obj);
+            else if constexpr (HasCachedHash<T>::value)
+                boost::hash_combine(mySeed, obj.getHash());
+            else // score objects.
+            {
+                const_cast<T &>(obj).serialize(*this,
+                                               FileVersion::LATEST_VERSION);
+            }
+        }
+
+        size_t mySeed = 0;
+    };
+} // namespace detail
+
+/// Computes a hash of the object's contents. Any child objects which cache
+/// their hash (see e.g. Staff::getHash()) are not revisited.
+template <typename T>
+size_t
+computeHash(const T &obj)
+{
+    detail::HashArchive ar;
+    const_cast<T &>(obj).serialize(ar, FileVersion::LATEST_VERSION);
+    return ar.value();
+}
+} // namespace ScoreUtils
+
+#endif
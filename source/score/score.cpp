@@ -17,6 +17,7 @@
 
 #include "score.h"
 
+#include "hash.h"
 #include <stdexcept>
 
 const int Score::MIN_LINE_SPACING = 6;
@@ -36,6 +37,36 @@ bool Score::operator==(const Score &other) const
            myViewFilters == other.myViewFilters;
 }
 
+std::unique_ptr<Score> Score::clone() const
+{
+    auto score = std::make_unique<Score>();
+    score->myScoreInfo = myScoreInfo;
+    score->mySystems = mySystems;
+    score->myPlayers = myPlayers;
+    score->myInstruments = myInstruments;
+    score->myLineSpacing = myLineSpacing;
+    score->myViewFilters = myViewFilters;
+    score->myCachedHash = myCachedHash;
+    score->myCachedBarIndex = myCachedBarIndex;
+    return score;
+}
+
+size_t Score::getHash() const
+{
+    if (!myCachedHash)
+        myCachedHash = ScoreUtils::computeHash(*this);
+
+    return *myCachedHash;
+}
+
+const BarIndex &Score::getBarIndex() const
+{
+    if (!myCachedBarIndex)
+        myCachedBarIndex.emplace(*this);
+
+    return *myCachedBarIndex;
+}
+
 const ScoreInfo &Score::getScoreInfo() const
 {
     return myScoreInfo;
@@ -43,11 +74,14 @@ const ScoreInfo &Score::getScoreInfo() const
 
 void Score::setScoreInfo(const ScoreInfo &info)
 {
+    myCachedHash.reset();
     myScoreInfo = info;
 }
 
 boost::iterator_range<Score::SystemIterator> Score::getSystems()
 {
+    myCachedHash.reset();
+    myCachedBarIndex.reset();
     return boost::make_iterator_range(mySystems);
 }
 
@@ -58,6 +92,8 @@ boost::iterator_range<Score::SystemConstIterator> Score::getSystems() const
 
 void Score::insertSystem(const System &system, int index)
 {
+    myCachedHash.reset();
+    myCachedBarIndex.reset();
     if (index < 0)
         mySystems.push_back(system);
     else
@@ -66,11 +102,14 @@ void Score::insertSystem(const System &system, int index)
 
 void Score::removeSystem(int index)
 {
+    myCachedHash.reset();
+    myCachedBarIndex.reset();
     mySystems.erase(mySystems.begin() + index);
 }
 
 boost::iterator_range<Score::PlayerIterator> Score::getPlayers()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myPlayers);
 }
 
@@ -81,21 +120,25 @@ boost::iterator_range<Score::PlayerConstIterator> Score::getPlayers() const
 
 void Score::insertPlayer(const Player &player)
 {
+    myCachedHash.reset();
     myPlayers.push_back(player);
 }
 
 void Score::insertPlayer(const Player &player, int index)
 {
+    myCachedHash.reset();
     myPlayers.insert(myPlayers.begin() + index, player);
 }
 
 void Score::removePlayer(int index)
 {
+    myCachedHash.reset();
     myPlayers.erase(myPlayers.begin() + index);
 }
 
 boost::iterator_range<Score::InstrumentIterator> Score::getInstruments()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myInstruments);
 }
 
@@ -106,21 +149,25 @@ boost::iterator_range<Score::InstrumentConstIterator> Score::getInstruments() co
 
 void Score::insertInstrument(const Instrument &instrument)
 {
+    myCachedHash.reset();
     myInstruments.push_back(instrument);
 }
 
 void Score::insertInstrument(const Instrument &instrument, int index)
 {
+    myCachedHash.reset();
     myInstruments.insert(myInstruments.begin() + index, instrument);
 }
 
 void Score::removeInstrument(int index)
 {
+    myCachedHash.reset();
     myInstruments.erase(myInstruments.begin() + index);
 }
 
 boost::iterator_range<Score::ViewFilterIterator> Score::getViewFilters()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myViewFilters);
 }
 
@@ -131,11 +178,13 @@ boost::iterator_range<Score::ViewFilterConstIterator> Score::getViewFilters() co
 
 void Score::insertViewFilter(const ViewFilter &filter)
 {
+    myCachedHash.reset();
     myViewFilters.push_back(filter);
 }
 
 void Score::removeViewFilter(int index)
 {
+    myCachedHash.reset();
     myViewFilters.erase(myViewFilters.begin() + index);
 }
 
@@ -146,6 +195,7 @@ int Score::getLineSpacing() const
 
 void Score::setLineSpacing(int value)
 {
+    myCachedHash.reset();
     if (value < MIN_LINE_SPACING || value > MAX_LINE_SPACING)
         throw std::out_of_range("Invalid line spacing");
 
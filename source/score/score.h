@@ -24,7 +24,10 @@
 #include "player.h"
 #include "scoreinfo.h"
 #include "system.h"
+#include "utils/barindex.h"
 #include "viewfilter.h"
+#include <memory>
+#include <optional>
 #include <vector>
 
 class PlayerChange;
@@ -46,9 +49,29 @@ public:
     Score &operator=(const Score &other) = delete;
     bool operator==(const Score &other) const;
 
+    /// Returns a deep copy of the score. Copying is otherwise disabled to
+    /// avoid accidentally copying large scores.
+    std::unique_ptr<Score> clone() const;
+
     template <class Archive>
     void serialize(Archive &ar, const FileVersion version);
 
+    /// Returns a hash of the score's contents, which is computed from the
+    /// hashes of its systems. This is cached until the score is modified,
+    /// including through any non-const access to its contents.
+    /// The cached hashes are not synchronized, so a score should not be hashed
+    /// from multiple threads at once.
+    /// Children do not know their parents, so an edit only clears the caches
+    /// along the path that was used to reach the edited object. A reference
+    /// to a system, staff, voice, etc. that was obtained before the score was
+    /// hashed must not be used for edits afterwards; look it up again from the
+    /// score instead (e.g. via ScoreLocation).
+    size_t getHash() const;
+
+    /// Returns an index of the bar numbers in the score. Like the hash, this
+    /// is cached until the systems are modified.
+    const BarIndex &getBarIndex() const;
+
     /// Returns information about the score (e.g. title, author, etc.).
     const ScoreInfo &getScoreInfo() const;
     /// Sets information about the score (e.g. title, author, etc.).
@@ -112,11 +135,18 @@ private:
     std::vector<Instrument> myInstruments;
     int myLineSpacing; ///< Spacing between tab lines (in pixels).
     std::vector<ViewFilter> myViewFilters;
+    /// Cleared by any non-const access to the score, but not when a child is
+    /// edited through an older reference (see getHash()).
+    mutable std::optional<size_t> myCachedHash;
+    mutable std::optional<BarIndex> myCachedBarIndex;
 };
 
 template <class Archive>
 void Score::serialize(Archive &ar, const FileVersion version)
 {
+    myCachedHash.reset();
+    myCachedBarIndex.reset();
+
     ar("score_info", myScoreInfo);
     ar("systems", mySystems);
     ar("players", myPlayers);
@@ -17,6 +17,8 @@
 
 #include "scorelocation.h"
 
+#include <algorithm>
+#include <ostream>
 #include <score/score.h>
 #include <score/utils.h>
 
@@ -69,13 +71,8 @@ void ConstScoreLocation::setPositionIndex(int position)
 
 const Position *ConstScoreLocation::getPosition() const
 {
-    for (const Position &pos : getVoice().getPositions())
-    {
-        if (pos.getPosition() == myPositionIndex)
-            return &pos;
-    }
-
-    return nullptr;
+    return ScoreUtils::findByPosition(getVoice().getPositions(),
+                                      myPositionIndex);
 }
 
 Position *ScoreLocation::getPosition()
@@ -160,10 +157,10 @@ std::vector<const Position *> ConstScoreLocation::getSelectedPositions() const
     const int min = std::min(myPositionIndex, mySelectionStart);
     const int max = std::max(myPositionIndex, mySelectionStart);
 
-    for (const Position &pos : getVoice().getPositions())
+    for (const Position &pos :
+         ScoreUtils::findInRange(getVoice().getPositions(), min, max))
     {
-        if (pos.getPosition() >= min && pos.getPosition() <= max)
-            positions.push_back(&pos);
+        positions.push_back(&pos);
     }
 
     return positions;
@@ -328,7 +325,26 @@ ConstScoreLocation::getSelectedIrregularGroupings() const
 
 std::ostream &operator <<(std::ostream &os, const ScoreLocation &location)
 {
-    os << "System: " << location.getSystemIndex() + 1;
+    const System &system = location.getSystem();
+    const auto barlines = system.getBarlines();
+
+    // Find the bar containing the position. The end bar is not the start of a
+    // new bar, so it is counted as part of the last bar in the system.
+    int barline_index = static_cast<int>(
+        std::upper_bound(barlines.begin(), barlines.end(),
+                         location.getPositionIndex(),
+                         [](int position, const Barline &barline) {
+                             return position < barline.getPosition();
+                         }) -
+        barlines.begin());
+    barline_index =
+        std::clamp(barline_index - 1, 0,
+                   std::max(0, static_cast<int>(barlines.size()) - 2));
+
+    os << "Bar: "
+       << location.getScore().getBarIndex().getBarNumber(
+              location.getSystemIndex(), barline_index);
+    os << ", System: " << location.getSystemIndex() + 1;
     os << ", Staff: " << location.getStaffIndex() + 1;
     os << ", Position: " << location.getPositionIndex() + 1;
     os << ", String: " << location.getString() + 1;
@@ -17,6 +17,7 @@
 
 #include "staff.h"
 
+#include "hash.h"
 #include "utils.h"
 
 Staff::Staff() : myClefType(TrebleClef), myStringCount(6)
@@ -35,6 +36,14 @@ bool Staff::operator==(const Staff &other) const
            myDynamics == other.myDynamics;
 }
 
+size_t Staff::getHash() const
+{
+    if (!myCachedHash)
+        myCachedHash = ScoreUtils::computeHash(*this);
+
+    return *myCachedHash;
+}
+
 Staff::ClefType Staff::getClefType() const
 {
     return myClefType;
@@ -42,6 +51,7 @@ Staff::ClefType Staff::getClefType() const
 
 void Staff::setClefType(ClefType type)
 {
+    myCachedHash.reset();
     myClefType = type;
 }
 
@@ -52,6 +62,7 @@ int Staff::getStringCount() const
 
 void Staff::setStringCount(int count)
 {
+    myCachedHash.reset();
     myStringCount = count;
 
     // Clean up notes / positions that are no longer valid.
@@ -72,6 +83,7 @@ void Staff::setStringCount(int count)
 
 boost::iterator_range<Staff::VoiceIterator> Staff::getVoices()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myVoices);
 }
 
@@ -82,6 +94,7 @@ boost::iterator_range<Staff::VoiceConstIterator> Staff::getVoices() const
 
 boost::iterator_range<Staff::DynamicIterator> Staff::getDynamics()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myDynamics);
 }
 
@@ -92,10 +105,12 @@ boost::iterator_range<Staff::DynamicConstIterator> Staff::getDynamics() const
 
 void Staff::insertDynamic(const Dynamic &dynamic)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myDynamics, dynamic);
 }
 
 void Staff::removeDynamic(const Dynamic &dynamic)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myDynamics, dynamic);
 }
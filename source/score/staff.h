@@ -22,6 +22,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include "dynamic.h"
 #include "fileversion.h"
+#include <optional>
 #include <vector>
 #include "voice.h"
 
@@ -53,6 +54,11 @@ public:
     template <class Archive>
     void serialize(Archive &ar, const FileVersion version);
 
+    /// Returns a hash of the staff's contents, which is computed from the
+    /// hashes of its voices. This is cached until the staff is modified,
+    /// including through any non-const access to its voices or dynamics.
+    size_t getHash() const;
+
     /// Returns whether the staff is a treble or bass clef.
     ClefType getClefType() const;
     /// Sets the staff's clef type.
@@ -84,11 +90,14 @@ private:
     int myStringCount;
     std::array<Voice, NUM_VOICES> myVoices;
     std::vector<Dynamic> myDynamics;
+    mutable std::optional<size_t> myCachedHash;
 };
 
 template <class Archive>
 void Staff::serialize(Archive &ar, const FileVersion version)
 {
+    myCachedHash.reset();
+
     if (version < FileVersion::VIEW_FILTERS)
     {
         int view_type = 0;
@@ -18,8 +18,8 @@
 #include "system.h"
 
 #include <algorithm>
-#include <boost/range/adaptor/reversed.hpp>
 #include <cstddef>
+#include "hash.h"
 #include "utils.h"
 
 System::System()
@@ -31,6 +31,14 @@ System::System()
     myBarlines.push_back(endBar);
 }
 
+size_t System::getHash() const
+{
+    if (!myCachedHash)
+        myCachedHash = ScoreUtils::computeHash(*this);
+
+    return *myCachedHash;
+}
+
 bool System::operator==(const System &other) const
 {
     return myStaves == other.myStaves && myBarlines == other.myBarlines &&
@@ -44,6 +52,7 @@ bool System::operator==(const System &other) const
 
 boost::iterator_range<System::StaffIterator> System::getStaves()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myStaves);
 }
 
@@ -54,21 +63,25 @@ boost::iterator_range<System::StaffConstIterator> System::getStaves() const
 
 void System::insertStaff(const Staff &staff)
 {
+    myCachedHash.reset();
     myStaves.push_back(staff);
 }
 
 void System::insertStaff(const Staff &staff, int index)
 {
+    myCachedHash.reset();
     myStaves.insert(myStaves.begin() + index, staff);
 }
 
 void System::removeStaff(int index)
 {
+    myCachedHash.reset();
     myStaves.erase(myStaves.begin() + index);
 }
 
 boost::iterator_range<System::BarlineIterator> System::getBarlines()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myBarlines);
 }
 
@@ -79,6 +92,7 @@ boost::iterator_range<System::BarlineConstIterator> System::getBarlines() const
 
 void System::insertBarline(const Barline &barline)
 {
+    myCachedHash.reset();
     // Ensure that the end bar remains the end bar.
     myBarlines.back().setPosition(
         std::max(myBarlines.back().getPosition(), barline.getPosition() + 1));
@@ -87,44 +101,28 @@ void System::insertBarline(const Barline &barline)
 
 void System::removeBarline(const Barline &barline)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myBarlines, barline);
 }
 
 const Barline *System::getPreviousBarline(int position) const
 {
-    for (const Barline &barline : boost::adaptors::reverse(myBarlines))
-    {
-        if (barline.getPosition() < position)
-            return &barline;
-    }
-
-    return nullptr;
+    return ScoreUtils::findPrevious(getBarlines(), position);
 }
 
 const Barline *System::getNextBarline(int position) const
 {
-    for (const Barline &barline : myBarlines)
-    {
-        if (barline.getPosition() > position)
-            return &barline;
-    }
-
-    return nullptr;
+    return ScoreUtils::findNext(getBarlines(), position);
 }
 
 Barline *System::getNextBarline(int position)
 {
-    for (Barline &barline : myBarlines)
-    {
-        if (barline.getPosition() > position)
-            return &barline;
-    }
-
-    return nullptr;
+    return ScoreUtils::findNext(getBarlines(), position);
 }
 
 boost::iterator_range<System::TempoMarkerIterator> System::getTempoMarkers()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myTempoMarkers);
 }
 
@@ -135,16 +133,19 @@ boost::iterator_range<System::TempoMarkerConstIterator> System::getTempoMarkers(
 
 void System::insertTempoMarker(const TempoMarker &marker)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myTempoMarkers, marker);
 }
 
 void System::removeTempoMarker(const TempoMarker &marker)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myTempoMarkers, marker);
 }
 
 boost::iterator_range<System::AlternateEndingIterator> System::getAlternateEndings()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myAlternateEndings);
 }
 
@@ -155,16 +156,19 @@ boost::iterator_range<System::AlternateEndingConstIterator> System::getAlternate
 
 void System::insertAlternateEnding(const AlternateEnding &ending)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myAlternateEndings, ending);
 }
 
 void System::removeAlternateEnding(const AlternateEnding &ending)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myAlternateEndings, ending);
 }
 
 boost::iterator_range<System::DirectionIterator> System::getDirections()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myDirections);
 }
 
@@ -175,16 +179,19 @@ boost::iterator_range<System::DirectionConstIterator> System::getDirections() co
 
 void System::insertDirection(const Direction &direction)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myDirections, direction);
 }
 
 void System::removeDirection(const Direction &direction)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myDirections, direction);
 }
 
 boost::iterator_range<System::PlayerChangeIterator> System::getPlayerChanges()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myPlayerChanges);
 }
 
@@ -195,16 +202,19 @@ boost::iterator_range<System::PlayerChangeConstIterator> System::getPlayerChange
 
 void System::insertPlayerChange(const PlayerChange &change)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myPlayerChanges, change);
 }
 
 void System::removePlayerChange(const PlayerChange &change)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myPlayerChanges, change);
 }
 
 boost::iterator_range<System::ChordTextIterator> System::getChords()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myChords);
 }
 
@@ -215,16 +225,19 @@ boost::iterator_range<System::ChordTextConstIterator> System::getChords() const
 
 void System::insertChord(const ChordText &chord)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myChords, chord);
 }
 
 void System::removeChord(const ChordText &chord)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myChords, chord);
 }
 
 boost::iterator_range<System::TextItemIterator> System::getTextItems()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myTextItems);
 }
 
@@ -235,11 +248,13 @@ boost::iterator_range<System::TextItemConstIterator> System::getTextItems() cons
 
 void System::insertTextItem(const TextItem &text)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myTextItems, text);
 }
 
 void System::removeTextItem(const TextItem &text)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myTextItems, text);
 }
 
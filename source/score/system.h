@@ -24,6 +24,7 @@
 #include "chordtext.h"
 #include "direction.h"
 #include "fileversion.h"
+#include <optional>
 #include "playerchange.h"
 #include "staff.h"
 #include "tempomarker.h"
@@ -57,6 +58,11 @@ public:
     template <class Archive>
     void serialize(Archive &ar, const FileVersion version);
 
+    /// Returns a hash of the system's contents, which is computed from the
+    /// hashes of its staves. This is cached until the system is modified,
+    /// including through any non-const access to its contents.
+    size_t getHash() const;
+
     /// Returns the set of staves in the system.
     boost::iterator_range<StaffIterator> getStaves();
     /// Returns the set of staves in the system.
@@ -155,11 +161,14 @@ private:
     std::vector<PlayerChange> myPlayerChanges;
     std::vector<ChordText> myChords;
     std::vector<TextItem> myTextItems;
+    mutable std::optional<size_t> myCachedHash;
 };
 
 template <class Archive>
 void System::serialize(Archive &ar, const FileVersion version)
 {
+    myCachedHash.reset();
+
     ar("staves", myStaves);
     ar("barlines", myBarlines);
     ar("tempo_markers", myTempoMarkers);
@@ -177,7 +186,9 @@ namespace SystemUtils {
 void shiftForward(System &system, int position);
 /// Shifts everything backward starting from the given position.
 void shiftBackward(System &system, int position);
-/// Shifts everything by the given offset.
+/// Shifts everything at or after the given position by the given offset. This
+/// is done in a single pass, so it is much faster than repeatedly calling
+/// shiftForward() or shiftBackward().
 void shift(System &system, int position, int offset);
 
 }
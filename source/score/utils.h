@@ -19,22 +19,57 @@
 #define SCORE_UTILS_H
 
 #include <algorithm>
-#include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <vector>
 
 namespace ScoreUtils {
 
+    // Objects in the score (positions, barlines, dynamics, etc) are stored in
+    // vectors which are kept sorted by position (see insertObject()), so
+    // these lookups use a binary search.
+
+    namespace detail
+    {
+        struct PositionLess
+        {
+            template <typename T>
+            bool operator()(const T &obj, int position) const
+            {
+                return obj.getPosition() < position;
+            }
+
+            template <typename T>
+            bool operator()(int position, const T &obj) const
+            {
+                return position < obj.getPosition();
+            }
+        };
+    }
+
+    /// Returns the first object at or after the given position.
+    template <typename T>
+    T lowerBound(const boost::iterator_range<T> &range, int position)
+    {
+        return std::lower_bound(range.begin(), range.end(), position,
+                                detail::PositionLess());
+    }
+
+    /// Returns the first object after the given position.
+    template <typename T>
+    T upperBound(const boost::iterator_range<T> &range, int position)
+    {
+        return std::upper_bound(range.begin(), range.end(), position,
+                                detail::PositionLess());
+    }
+
     /// Returns the object at the given position index, or null.
     template <typename T>
     typename T::pointer findByPosition(const boost::iterator_range<T> &range,
                                        int position)
     {
-        size_t n = range.size();
-        for (size_t i = 0; i < n; ++i)
-        {
-            if (range[i].getPosition() == position)
-                return &range[i];
-        }
+        T it = lowerBound(range, position);
+        if (it != range.end() && it->getPosition() == position)
+            return &*it;
 
         return nullptr;
     }
@@ -42,16 +77,31 @@ namespace ScoreUtils {
     template <typename T>
     int findIndexByPosition(const boost::iterator_range<T> &range, int position)
     {
-        const int n = static_cast<int>(range.size());
-        for (int i = 0; i < n; ++i)
-        {
-            if (range[i].getPosition() == position)
-                return i;
-        }
+        T it = lowerBound(range, position);
+        if (it != range.end() && it->getPosition() == position)
+            return static_cast<int>(it - range.begin());
 
         return -1;
     }
 
+    /// Returns the first object after the given position, or null.
+    template <typename T>
+    typename T::pointer findNext(const boost::iterator_range<T> &range,
+                                 int position)
+    {
+        T it = upperBound(range, position);
+        return (it != range.end()) ? &*it : nullptr;
+    }
+
+    /// Returns the last object before the given position, or null.
+    template <typename T>
+    typename T::pointer findPrevious(const boost::iterator_range<T> &range,
+                                     int position)
+    {
+        T it = lowerBound(range, position);
+        return (it != range.begin()) ? &*std::prev(it) : nullptr;
+    }
+
     struct InPositionRange
     {
         InPositionRange(int left, int right) : myLeft(left), myRight(right)
@@ -69,13 +119,16 @@ namespace ScoreUtils {
         const int myRight;
     };
 
-    template <typename Range>
-    boost::filtered_range<InPositionRange, Range> findInRange(Range range,
-                                                              int left,
-                                                              int right)
+    /// Returns the objects in the range [left, right].
+    template <typename T>
+    boost::iterator_range<T> findInRange(const boost::iterator_range<T> &range,
+                                         int left, int right)
     {
-        return boost::adaptors::filter(
-            range, InPositionRange(left, right));
+        if (left > right)
+            return boost::make_iterator_range(range.end(), range.end());
+
+        return boost::make_iterator_range(lowerBound(range, left),
+                                          upperBound(range, right));
     }
 
     // Some helper methods to reduce code duplication.
@@ -104,6 +157,24 @@ namespace ScoreUtils {
             std::sort(objects.begin(), objects.end(), OrderByPosition<T>());
     }
 
+    /// Inserts a batch of objects. Rather than inserting the objects one at a
+    /// time (and possibly re-sorting after each insertion), the new objects
+    /// are merged with the existing objects in a single pass.
+    template <typename T>
+    void insertObjects(std::vector<T> &objects,
+                       const std::vector<T> &newObjects)
+    {
+        const auto n = static_cast<std::ptrdiff_t>(objects.size());
+        objects.insert(objects.end(), newObjects.begin(), newObjects.end());
+
+        auto middle = objects.begin() + n;
+        if (!std::is_sorted(middle, objects.end(), OrderByPosition<T>()))
+            std::stable_sort(middle, objects.end(), OrderByPosition<T>());
+
+        std::inplace_merge(objects.begin(), middle, objects.end(),
+                           OrderByPosition<T>());
+    }
+
     template <typename T>
     void removeObject(std::vector<T> &objects, const T &obj)
     {
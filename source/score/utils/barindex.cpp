@@ -0,0 +1,68 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "barindex.h"
+
+#include <algorithm>
+#include <score/score.h>
+#include <stdexcept>
+
+BarIndex::BarIndex(const Score &score)
+{
+    myFirstBarNumbers.reserve(score.getSystems().size() + 1);
+
+    int bar_number = 1;
+    myFirstBarNumbers.push_back(bar_number);
+
+    for (const System &system : score.getSystems())
+    {
+        const int num_barlines = static_cast<int>(system.getBarlines().size());
+        bar_number += std::max(num_barlines - 1, 0);
+        myFirstBarNumbers.push_back(bar_number);
+    }
+}
+
+int BarIndex::getBarCount() const
+{
+    return myFirstBarNumbers.back() - 1;
+}
+
+int BarIndex::getFirstBarNumber(int system) const
+{
+    return myFirstBarNumbers.at(system);
+}
+
+int BarIndex::getBarNumber(int system, int barline) const
+{
+    return getFirstBarNumber(system) + barline;
+}
+
+std::pair<int, int> BarIndex::findBar(int bar_number) const
+{
+    if (bar_number < 1 || bar_number > getBarCount())
+        throw std::out_of_range("Invalid bar number");
+
+    // Find the last system that starts at or before this bar. Systems without
+    // any bars share their first bar number with the next system, so
+    // upper_bound skips past them.
+    auto it = std::upper_bound(myFirstBarNumbers.begin(),
+                               myFirstBarNumbers.end(), bar_number);
+    --it;
+
+    const int system = static_cast<int>(it - myFirstBarNumbers.begin());
+    return { system, bar_number - *it };
+}
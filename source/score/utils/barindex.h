@@ -0,0 +1,56 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_UTILS_BARINDEX_H
+#define SCORE_UTILS_BARINDEX_H
+
+#include <utility>
+#include <vector>
+
+class Score;
+
+/// Numbers the bars of the whole score, so that a bar number can be mapped to
+/// a barline and vice versa without walking all of the preceding systems.
+/// Bars are numbered from 1, and each barline other than a system's end bar
+/// begins a new bar.
+class BarIndex
+{
+public:
+    explicit BarIndex(const Score &score);
+
+    /// Returns the total number of bars in the score.
+    int getBarCount() const;
+
+    /// Returns the number of the first bar in the given system.
+    int getFirstBarNumber(int system) const;
+
+    /// Returns the number of the bar beginning at the given barline (i.e. its
+    /// index in System::getBarlines()). The end bar of a system has the
+    /// number of the first bar in the next system.
+    int getBarNumber(int system, int barline) const;
+
+    /// Returns the system index and barline index where the given bar begins.
+    /// @throws std::out_of_range if the bar number is invalid.
+    std::pair<int, int> findBar(int bar_number) const;
+
+private:
+    /// The number of the first bar in each system, followed by one past the
+    /// last bar number in the score.
+    std::vector<int> myFirstBarNumbers;
+};
+
+#endif
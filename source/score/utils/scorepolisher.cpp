@@ -70,8 +70,12 @@ template <typename T>
 static void shiftItemsAtPosition(const T &items, int position, int newPosition,
                                  std::unordered_set<const void *> &knownItems)
 {
-    for (auto &item : ScoreUtils::findInRange(items, position, position))
+    // The items might not be sorted while the bar is being rearranged, so a
+    // binary search (e.g. ScoreUtils::findInRange()) can't be used here.
+    for (auto &item : items)
     {
+        if (item.getPosition() != position)
+            continue;
         if (knownItems.find(&item) != knownItems.end())
             continue;
 
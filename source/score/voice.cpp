@@ -17,6 +17,7 @@
 
 #include "voice.h"
 
+#include "hash.h"
 #include "utils.h"
 
 Voice::Voice()
@@ -29,8 +30,17 @@ bool Voice::operator==(const Voice &other) const
            myIrregularGroupings == other.myIrregularGroupings;
 }
 
+size_t Voice::getHash() const
+{
+    if (!myCachedHash)
+        myCachedHash = ScoreUtils::computeHash(*this);
+
+    return *myCachedHash;
+}
+
 boost::iterator_range<Voice::PositionIterator> Voice::getPositions()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myPositions);
 }
 
@@ -41,17 +51,26 @@ boost::iterator_range<Voice::PositionConstIterator> Voice::getPositions() const
 
 void Voice::insertPosition(const Position &position)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myPositions, position);
 }
 
+void Voice::insertPositions(const std::vector<Position> &positions)
+{
+    myCachedHash.reset();
+    ScoreUtils::insertObjects(myPositions, positions);
+}
+
 void Voice::removePosition(const Position &position)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myPositions, position);
 }
 
 boost::iterator_range<Voice::IrregularGroupingIterator>
 Voice:: getIrregularGroupings()
 {
+    myCachedHash.reset();
     return boost::make_iterator_range(myIrregularGroupings);
 }
 
@@ -63,10 +82,19 @@ Voice:: getIrregularGroupings() const
 
 void Voice::insertIrregularGrouping(const IrregularGrouping &group)
 {
+    myCachedHash.reset();
     ScoreUtils::insertObject(myIrregularGroupings, group);
 }
 
+void Voice::insertIrregularGroupings(
+    const std::vector<IrregularGrouping> &groups)
+{
+    myCachedHash.reset();
+    ScoreUtils::insertObjects(myIrregularGroupings, groups);
+}
+
 void Voice::removeIrregularGrouping(const IrregularGrouping &group)
 {
+    myCachedHash.reset();
     ScoreUtils::removeObject(myIrregularGroupings, group);
 }
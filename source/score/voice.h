@@ -21,6 +21,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include "fileversion.h"
 #include "irregulargrouping.h"
+#include <optional>
 #include "position.h"
 #include <vector>
 
@@ -40,6 +41,11 @@ public:
     template <class Archive>
     void serialize(Archive &ar, const FileVersion version);
 
+    /// Returns a hash of the voice's contents. This is cached until the voice
+    /// is modified, which includes any non-const access to its positions or
+    /// irregular groupings.
+    size_t getHash() const;
+
     /// Returns the set of positions in the voice.
     boost::iterator_range<PositionIterator> getPositions();
     /// Returns the set of positions in the voice.
@@ -47,6 +53,9 @@ public:
 
     /// Adds a new position to the voice.
     void insertPosition(const Position &position);
+    /// Adds several positions to the voice. This is much faster than
+    /// inserting the positions individually.
+    void insertPositions(const std::vector<Position> &positions);
     /// Removes any positions that satisfy the given predicate.
     template <typename Predicate>
     void removePositions(Predicate p);
@@ -61,17 +70,21 @@ public:
 
     /// Adds a new irregular grouping to the voice.
     void insertIrregularGrouping(const IrregularGrouping &group);
+    /// Adds several irregular groupings to the voice.
+    void insertIrregularGroupings(const std::vector<IrregularGrouping> &groups);
     /// Removes the specified irregular grouping from the voice.
     void removeIrregularGrouping(const IrregularGrouping &group);
 
 private:
     std::vector<Position> myPositions;
     std::vector<IrregularGrouping> myIrregularGroupings;
+    mutable std::optional<size_t> myCachedHash;
 };
 
 template <class Archive>
 void Voice::serialize(Archive &ar, const FileVersion /*version*/)
 {
+    myCachedHash.reset();
     ar("positions", myPositions);
     ar("irregular_groupings", myIrregularGroupings);
 }
@@ -79,6 +92,7 @@ void Voice::serialize(Archive &ar, const FileVersion /*version*/)
 template <typename Predicate>
 void Voice::removePositions(Predicate p)
 {
+    myCachedHash.reset();
     myPositions.erase(std::remove_if(myPositions.begin(), myPositions.end(), p),
                       myPositions.end());
 }
@@ -17,7 +17,6 @@
 
 #include "voiceutils.h"
 
-#include <boost/range/adaptor/reversed.hpp>
 #include "score.h"
 #include "scorelocation.h"
 #include "utils.h"
@@ -46,24 +45,12 @@ const Voice *getAdjacentVoice(const ConstScoreLocation &location, int offset)
 
 const Position *getNextPosition(const Voice &voice, int position)
 {
-    for (const Position &pos : voice.getPositions())
-    {
-        if (pos.getPosition() > position)
-            return &pos;
-    }
-
-    return nullptr;
+    return ScoreUtils::findNext(voice.getPositions(), position);
 }
 
 const Position *getPreviousPosition(const Voice &voice, int position)
 {
-    for (const Position &pos : boost::adaptors::reverse(voice.getPositions()))
-    {
-        if (pos.getPosition() < position)
-            return &pos;
-    }
-
-    return nullptr;
+    return ScoreUtils::findPrevious(voice.getPositions(), position);
 }
 
 Position *
@@ -0,0 +1,55 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "arena.h"
+
+#include <algorithm>
+
+namespace Util
+{
+Arena::Arena(size_t initial_block_size)
+    : myNextBlockSize(std::max<size_t>(initial_block_size, 1))
+{
+}
+
+void *Arena::allocate(size_t size, size_t alignment)
+{
+    void *ptr = myCurrent;
+    if (!myCurrent || !std::align(alignment, size, ptr, myRemaining))
+    {
+        // Start a new block, which is large enough for the allocation even in
+        // the worst case for alignment.
+        const size_t block_size = std::max(myNextBlockSize, size + alignment);
+        myBlocks.emplace_back(new std::byte[block_size]);
+        myReservedBytes += block_size;
+        myNextBlockSize *= 2;
+
+        ptr = myBlocks.back().get();
+        myRemaining = block_size;
+        std::align(alignment, size, ptr, myRemaining);
+    }
+
+    myCurrent = static_cast<std::byte *>(ptr) + size;
+    myRemaining -= size;
+    return ptr;
+}
+
+size_t Arena::getReservedBytes() const
+{
+    return myReservedBytes;
+}
+} // namespace Util
@@ -0,0 +1,107 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UTIL_ARENA_H
+#define UTIL_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Util
+{
+/// A monotonic allocator for short-lived groups of objects, such as the object
+/// graph that is built while importing a file. Allocations are carved out of
+/// large blocks, and freeing an individual allocation does nothing. All of the
+/// memory is released at once when the arena is destroyed.
+class Arena
+{
+public:
+    /// Creates an arena whose first block has the given size. Each subsequent
+    /// block is twice as large as the previous one, so the first block can be
+    /// small without needing many blocks for large groups of objects.
+    explicit Arena(size_t initial_block_size = 4 * 1024);
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /// Returns uninitialized memory with the given size and alignment, which
+    /// remains valid until the arena is destroyed.
+    void *allocate(size_t size, size_t alignment);
+
+    /// Returns the total size of the blocks that have been allocated.
+    size_t getReservedBytes() const;
+
+private:
+    std::vector<std::unique_ptr<std::byte[]>> myBlocks;
+    std::byte *myCurrent = nullptr;
+    size_t myRemaining = 0;
+    size_t myNextBlockSize;
+    size_t myReservedBytes = 0;
+};
+
+/// A standard allocator which allocates from an arena, e.g. for use with
+/// std::allocate_shared() or a container.
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena &arena) noexcept : myArena(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+        : myArena(other.getArena())
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        return static_cast<T *>(myArena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /// The memory is only released when the arena is destroyed.
+    void deallocate(T *, size_t) noexcept
+    {
+    }
+
+    Arena *getArena() const noexcept
+    {
+        return myArena;
+    }
+
+private:
+    Arena *myArena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+    return a.getArena() == b.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &a, const ArenaAllocator<U> &b)
+{
+    return !(a == b);
+}
+} // namespace Util
+
+#endif
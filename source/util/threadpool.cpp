@@ -0,0 +1,89 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "threadpool.h"
+
+#include <algorithm>
+
+namespace Util
+{
+ThreadPool::ThreadPool(unsigned int num_threads)
+{
+    if (num_threads == 0)
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    myThreads.reserve(num_threads);
+    for (unsigned int i = 0; i < num_threads; ++i)
+        myThreads.emplace_back(&ThreadPool::run, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        myIsStopping = true;
+    }
+
+    myTaskAvailable.notify_all();
+
+    for (std::thread &thread : myThreads)
+        thread.join();
+}
+
+void ThreadPool::waitForAll()
+{
+    std::unique_lock<std::mutex> lock(myMutex);
+    myTasksFinished.wait(
+        lock, [this]() { return myTasks.empty() && myActiveTasks == 0; });
+}
+
+unsigned int ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned int>(myThreads.size());
+}
+
+void ThreadPool::run()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(myMutex);
+            myTaskAvailable.wait(
+                lock, [this]() { return myIsStopping || !myTasks.empty(); });
+
+            // Finish any remaining tasks before shutting down.
+            if (myTasks.empty())
+                return;
+
+            task = std::move(myTasks.front());
+            myTasks.pop_front();
+            ++myActiveTasks;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(myMutex);
+            --myActiveTasks;
+        }
+
+        myTasksFinished.notify_all();
+    }
+}
+} // namespace Util
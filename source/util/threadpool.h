@@ -0,0 +1,88 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UTIL_THREADPOOL_H
+#define UTIL_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Util
+{
+/// A fixed-size pool of worker threads which run tasks in FIFO order.
+/// Unlike std::async, the number of threads is bounded regardless of how many
+/// tasks are queued.
+class ThreadPool
+{
+public:
+    /// Creates a pool with the given number of workers. If zero, the number of
+    /// hardware threads is used.
+    explicit ThreadPool(unsigned int num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Queues a task, and returns a future for its result. Any exception
+    /// thrown by the task is stored in the future.
+    template <typename F>
+    auto submit(F &&f) -> std::future<decltype(f())>;
+
+    /// Blocks until all queued tasks have finished running.
+    void waitForAll();
+
+    unsigned int getThreadCount() const;
+
+private:
+    void run();
+
+    std::vector<std::thread> myThreads;
+    std::deque<std::function<void()>> myTasks;
+    std::mutex myMutex;
+    std::condition_variable myTaskAvailable;
+    std::condition_variable myTasksFinished;
+    int myActiveTasks = 0;
+    bool myIsStopping = false;
+};
+
+template <typename F>
+auto ThreadPool::submit(F &&f) -> std::future<decltype(f())>
+{
+    using Result = decltype(f());
+
+    // std::function requires a copyable callable, so the packaged_task must be
+    // held through a shared_ptr.
+    auto task = std::make_shared<std::packaged_task<Result()>>(
+        std::forward<F>(f));
+    std::future<Result> future = task->get_future();
+
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        myTasks.emplace_back([task]() { (*task)(); });
+    }
+
+    myTaskAvailable.notify_one();
+    return future;
+}
+} // namespace Util
+
+#endif
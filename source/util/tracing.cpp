@@ -0,0 +1,250 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tracing.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace Util::Tracing
+{
+namespace
+{
+struct Event
+{
+    const char *myName;
+    std::string myDetail;
+    int64_t myStart;
+    int64_t myEnd;
+};
+
+/// Events are buffered per thread so that recording a span doesn't contend
+/// with other threads. The mutex is only contended while the trace is being
+/// cleared or written.
+struct ThreadBuffer
+{
+    std::mutex myMutex;
+    int myId = 0;
+    std::string myName;
+    std::vector<Event> myEvents;
+};
+
+struct Registry
+{
+    std::mutex myMutex;
+    /// Buffers are kept alive after their thread exits so that its events
+    /// still appear in the trace.
+    std::vector<std::shared_ptr<ThreadBuffer>> myBuffers;
+    std::atomic<int64_t> myEpoch{ 0 };
+};
+
+Registry &getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+ThreadBuffer &getThreadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto buffer = std::make_shared<ThreadBuffer>();
+
+        Registry &registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.myMutex);
+        buffer->myId = static_cast<int>(registry.myBuffers.size()) + 1;
+        registry.myBuffers.push_back(buffer);
+        return buffer;
+    }();
+
+    return *buffer;
+}
+
+int64_t steadyTime()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void writeString(std::ostream &os, const std::string &str)
+{
+    os << '"';
+    for (char c : str)
+    {
+        switch (c)
+        {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    os << escaped;
+                }
+                else
+                    os << c;
+        }
+    }
+    os << '"';
+}
+
+/// Writes a time in nanoseconds as (fractional) microseconds.
+void writeTime(std::ostream &os, int64_t ns)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%lld.%03d",
+                  static_cast<long long>(ns / 1000),
+                  static_cast<int>(ns % 1000));
+    os << buf;
+}
+} // namespace
+
+namespace Detail
+{
+std::atomic<bool> theIsEnabled{ false };
+
+int64_t now()
+{
+    return steadyTime();
+}
+
+void record(const char *name, std::string detail, int64_t start, int64_t end)
+{
+    // Skip spans that began before the trace was (re)started.
+    if (start < getRegistry().myEpoch.load(std::memory_order_relaxed))
+        return;
+
+    ThreadBuffer &buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.myMutex);
+    buffer.myEvents.push_back({ name, std::move(detail), start, end });
+}
+} // namespace Detail
+
+void start()
+{
+    Registry &registry = getRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.myMutex);
+        for (auto &buffer : registry.myBuffers)
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->myMutex);
+            buffer->myEvents.clear();
+        }
+
+        registry.myEpoch.store(steadyTime(), std::memory_order_relaxed);
+    }
+
+    Detail::theIsEnabled.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+    Detail::theIsEnabled.store(false, std::memory_order_relaxed);
+}
+
+void setThreadName(std::string name)
+{
+    ThreadBuffer &buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.myMutex);
+    buffer.myName = std::move(name);
+}
+
+void writeJson(std::ostream &os)
+{
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.myMutex);
+    const int64_t epoch = registry.myEpoch.load(std::memory_order_relaxed);
+
+    os << "{\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first)
+            os << ",\n";
+        first = false;
+    };
+
+    for (auto &buffer : registry.myBuffers)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->myMutex);
+
+        if (!buffer->myName.empty())
+        {
+            separator();
+            os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+               << buffer->myId << ",\"args\":{\"name\":";
+            writeString(os, buffer->myName);
+            os << "}}";
+        }
+
+        for (const Event &event : buffer->myEvents)
+        {
+            separator();
+            os << "{\"name\":";
+            writeString(os, event.myName);
+            os << ",\"cat\":\"pte\",\"ph\":\"X\",\"ts\":";
+            writeTime(os, event.myStart - epoch);
+            os << ",\"dur\":";
+            writeTime(os, event.myEnd - event.myStart);
+            os << ",\"pid\":1,\"tid\":" << buffer->myId;
+
+            if (!event.myDetail.empty())
+            {
+                os << ",\"args\":{\"detail\":";
+                writeString(os, event.myDetail);
+                os << "}";
+            }
+
+            os << "}";
+        }
+    }
+
+    os << "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+std::map<std::string, int64_t> getTotalDurations()
+{
+    std::map<std::string, int64_t> durations;
+
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.myMutex);
+
+    for (auto &buffer : registry.myBuffers)
+    {
+        std::lock_guard<std::mutex> buffer_lock(buffer->myMutex);
+
+        for (const Event &event : buffer->myEvents)
+            durations[event.myName] += event.myEnd - event.myStart;
+    }
+
+    return durations;
+}
+} // namespace Util::Tracing
@@ -0,0 +1,117 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UTIL_TRACING_H
+#define UTIL_TRACING_H
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+/// Lightweight scoped tracing. While tracing is enabled, each Span records its
+/// start time and duration on the current thread, and the collected events can
+/// be written out in the Chrome trace event format (viewable in
+/// chrome://tracing or https://ui.perfetto.dev).
+/// When tracing is disabled, a span costs a single relaxed atomic load.
+namespace Util::Tracing
+{
+namespace Detail
+{
+extern std::atomic<bool> theIsEnabled;
+
+/// Returns a monotonic timestamp in nanoseconds.
+int64_t now();
+
+void record(const char *name, std::string detail, int64_t start,
+            int64_t end);
+} // namespace Detail
+
+/// Discards any previously recorded events and begins recording.
+void start();
+
+/// Stops recording. The recorded events are kept until the next call to
+/// start().
+void stop();
+
+inline bool isEnabled()
+{
+    return Detail::theIsEnabled.load(std::memory_order_relaxed);
+}
+
+/// Sets the name that is displayed for the current thread in the trace.
+void setThreadName(std::string name);
+
+/// Writes the recorded events as a Chrome trace event JSON document.
+void writeJson(std::ostream &os);
+
+/// Returns the total time (in nanoseconds) of the recorded spans with each
+/// name, e.g. to break down a benchmark by phase.
+std::map<std::string, int64_t> getTotalDurations();
+
+/// Records the time spent between construction and destruction. The name must
+/// be a string literal (or otherwise outlive the trace).
+class Span
+{
+public:
+    explicit Span(const char *name)
+        : myName(isEnabled() ? name : nullptr),
+          myStart(myName ? Detail::now() : 0)
+    {
+    }
+
+    /// Attaches additional information (e.g. a filename) to the event.
+    Span(const char *name, std::string detail)
+        : myName(isEnabled() ? name : nullptr),
+          myDetail(myName ? std::move(detail) : std::string()),
+          myStart(myName ? Detail::now() : 0)
+    {
+    }
+
+    ~Span()
+    {
+        if (myName && isEnabled())
+            Detail::record(myName, std::move(myDetail), myStart,
+                           Detail::now());
+    }
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    const char *myName;
+    std::string myDetail;
+    int64_t myStart;
+};
+} // namespace Util::Tracing
+
+#define PTE_TRACE_CONCAT_IMPL(a, b) a##b
+#define PTE_TRACE_CONCAT(a, b) PTE_TRACE_CONCAT_IMPL(a, b)
+
+/// Traces the remainder of the enclosing scope.
+#define PTE_TRACE_SCOPE(name)                                                  \
+    Util::Tracing::Span PTE_TRACE_CONCAT(pte_trace_span_, __LINE__)(name)
+
+/// Traces the remainder of the enclosing scope, with additional information
+/// about the event. The detail is only evaluated if tracing is enabled, so it
+/// can be expensive to build (e.g. converting a QString).
+#define PTE_TRACE_SCOPE_DETAIL(name, detail)                                   \
+    Util::Tracing::Span PTE_TRACE_CONCAT(pte_trace_span_, __LINE__)(          \
+        name, Util::Tracing::isEnabled() ? std::string(detail) : std::string())
+
+#endif
@@ -32,28 +32,38 @@ InstrumentPanel::InstrumentPanel(QWidget *parent)
 
 void InstrumentPanel::reset(const Score &score)
 {
-    clear();
+    const int num_instruments = static_cast<int>(score.getInstruments().size());
 
-    for (unsigned int i = 0; i < score.getInstruments().size(); ++i)
+    for (int i = 0; i < num_instruments; ++i)
     {
-        auto item = new InstrumentPanelItem(this, i, score.getInstruments()[i]);
+        const Instrument &instrument = score.getInstruments()[i];
+
+        if (i < static_cast<int>(myItems.size()))
+        {
+            myItems[i]->update(instrument);
+            myItems[i]->show();
+            continue;
+        }
+
+        auto item = new InstrumentPanelItem(this, i, instrument);
         connect(item, &InstrumentPanelItem::instrumentEdited,
                 [=](const Instrument &inst) { instrumentEdited(i, inst); });
         connect(item, &InstrumentPanelItem::instrumentRemoved,
                 [=]() { instrumentRemoved(i); });
 
         myLayout->addWidget(item);
+        myItems.push_back(item);
     }
+
+    // Hide any leftover items rather than deleting them, so that they can be
+    // reused later. This also means that it is safe to reset the panel in
+    // response to a signal from one of its items.
+    for (int i = num_instruments; i < static_cast<int>(myItems.size()); ++i)
+        myItems[i]->hide();
 }
 
 void InstrumentPanel::clear()
 {
-    while (QLayoutItem *item = myLayout->takeAt(0))
-    {
-        // We might be clearing the instrument panel in response to a signal
-        // from one of its widgets, so it's not safe to delete the widget until
-        // control returns to the event loop.
-        item->widget()->deleteLater();
-        delete item;
-    }
+    for (InstrumentPanelItem *item : myItems)
+        item->hide();
 }
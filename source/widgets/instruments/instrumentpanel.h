@@ -19,8 +19,10 @@
 #define WIDGETS_INSTRUMENTPANEL_H
 
 #include <QWidget>
+#include <vector>
 
 class Instrument;
+class InstrumentPanelItem;
 class QVBoxLayout;
 class Score;
 
@@ -31,10 +33,11 @@ class InstrumentPanel : public QWidget
 public:
     InstrumentPanel(QWidget *parent);
 
-    /// Clear and then populate the instrument panel.
+    /// Updates the panel to show the instruments in the score. Existing items
+    /// are reused, since creating them is fairly expensive.
     void reset(const Score &score);
 
-    /// Removes all items from the panel.
+    /// Hides all items in the panel. The items are kept for reuse.
     void clear();
 
 signals:
@@ -43,6 +46,9 @@ signals:
 
 private:
     QVBoxLayout *myLayout;
+    /// All items that have been created. Only the items for the current
+    /// score's instruments are visible.
+    std::vector<InstrumentPanelItem *> myItems;
 };
 
 #endif
@@ -72,6 +72,11 @@ void InstrumentPanelItem::update(const Instrument &instrument)
         QString::fromStdString(instrument.getDescription()));
     ui->instrumentNameEdit->setText(ui->instrumentNameLabel->text());
     ui->midiInstrument->setCurrentIndex(instrument.getMidiPreset());
+
+    // Cancel any edit of the name, since the item may now be showing a
+    // different instrument.
+    ui->instrumentNameEdit->hide();
+    ui->instrumentNameLabel->show();
 }
 
 void InstrumentPanelItem::onInstrumentNameEdited()
@@ -33,28 +33,39 @@ Mixer::Mixer(QWidget *parent, const TuningDictionary &dictionary)
 
 void Mixer::reset(const Score &score)
 {
-    clear();
+    const int num_players = static_cast<int>(score.getPlayers().size());
 
-    for (unsigned int i = 0; i < score.getPlayers().size(); ++i)
+    for (int i = 0; i < num_players; ++i)
     {
-        auto item = new MixerItem(this, i, score.getPlayers()[i], myDictionary);
+        const Player &player = score.getPlayers()[i];
+
+        if (i < static_cast<int>(myItems.size()))
+        {
+            myItems[i]->update(player);
+            myItems[i]->show();
+            continue;
+        }
+
+        auto item = new MixerItem(this, i, player, myDictionary);
         connect(item, &MixerItem::playerEdited,
                 [=](const Player &player, bool undoable) {
                     playerEdited(i, player, undoable);
                 });
         connect(item, &MixerItem::playerRemoved, [=]() { playerRemoved(i); });
         myLayout->addWidget(item);
+        myItems.push_back(item);
     }
+
+    // Hide any leftover items rather than deleting them, so that they can be
+    // reused when switching to a score with more players. This also means
+    // that it is safe to reset the mixer in response to a signal from one of
+    // its items.
+    for (int i = num_players; i < static_cast<int>(myItems.size()); ++i)
+        myItems[i]->hide();
 }
 
 void Mixer::clear()
 {
-    while (QLayoutItem *item = myLayout->takeAt(0))
-    {
-        // We might be clearing the mixer in response to a signal from one of
-        // its widgets, so it's not safe to delete the widget until control
-        // returns to the event loop.
-        item->widget()->deleteLater();
-        delete item;
-    }
+    for (MixerItem *item : myItems)
+        item->hide();
 }
@@ -19,7 +19,9 @@
 #define WIDGETS_MIXER_H
 
 #include <QWidget>
+#include <vector>
 
+class MixerItem;
 class Player;
 class QVBoxLayout;
 class Score;
@@ -32,10 +34,11 @@ class Mixer : public QWidget
 public:
     Mixer(QWidget *parent, const TuningDictionary &dictionary);
 
-    /// Clear and then populate the mixer.
+    /// Updates the mixer to show the players in the score. Existing items are
+    /// reused, since creating them is fairly expensive.
     void reset(const Score &score);
 
-    /// Removes all items from the mixer.
+    /// Hides all items in the mixer. The items are kept for reuse.
     void clear();
 
 signals:
@@ -45,6 +48,9 @@ signals:
 private:
     QVBoxLayout *myLayout;
     const TuningDictionary &myDictionary;
+    /// All items that have been created. Only the items for the current
+    /// score's players are visible.
+    std::vector<MixerItem *> myItems;
 };
 
 #endif
@@ -22,6 +22,7 @@
 #include <score/player.h>
 #include <util/tostring.h>
 
+#include <QSignalBlocker>
 #include <QStyle>
 #include <memory>
 
@@ -35,19 +36,13 @@ MixerItem::MixerItem(QWidget *parent, int playerIndex, const Player &player,
     ui->setupUi(this);
 
     ui->playerIndexLabel->setText(QStringLiteral("%1.").arg(playerIndex + 1));
-    ui->playerNameLabel->setText(
-        QString::fromStdString(player.getDescription()));
-    ui->playerNameEdit->setText(ui->playerNameLabel->text());
-    ui->playerVolume->setValue(player.getMaxVolume());
-    ui->playerPan->setValue(player.getPan());
     ui->playerTuning->setText(
-        QString::fromStdString(Util::toString(player.getTuning())));
+        QString::fromStdString(Util::toString(myTuning)));
+    update(player);
 
     ui->removeButton->setIcon(
         style()->standardIcon(QStyle::SP_TitleBarCloseButton));
 
-    ui->playerNameEdit->hide();
-
     connect(ui->playerNameLabel, &ClickableLabel::clicked, ui->playerNameLabel,
             &QWidget::hide);
     connect(ui->playerNameLabel, &ClickableLabel::clicked, ui->playerNameEdit,
@@ -78,6 +73,33 @@ MixerItem::~MixerItem()
     delete ui;
 }
 
+void MixerItem::update(const Player &player)
+{
+    // The item is not being edited by the user, so don't emit playerEdited().
+    const QSignalBlocker volume_blocker(ui->playerVolume);
+    const QSignalBlocker pan_blocker(ui->playerPan);
+
+    ui->playerNameLabel->setText(
+        QString::fromStdString(player.getDescription()));
+    ui->playerNameEdit->setText(ui->playerNameLabel->text());
+    ui->playerVolume->setValue(player.getMaxVolume());
+    ui->playerPan->setValue(player.getPan());
+
+    // Formatting the tuning is relatively expensive, so only do this when it
+    // has changed.
+    if (!(player.getTuning() == myTuning))
+    {
+        myTuning = player.getTuning();
+        ui->playerTuning->setText(
+            QString::fromStdString(Util::toString(myTuning)));
+    }
+
+    // Cancel any edit of the name, since the item may now be showing a
+    // different player.
+    ui->playerNameEdit->hide();
+    ui->playerNameLabel->show();
+}
+
 void MixerItem::onPlayerNameEdited()
 {
     // Avoid sending another message when the editor becomes hidden.
@@ -100,7 +122,11 @@ void MixerItem::editTuning()
 
     if (dialog->exec() == QDialog::Accepted)
     {
+        // Update the label here, since update() skips reformatting the tuning
+        // once myTuning matches the player's tuning.
         myTuning = dialog->getTuning();
+        ui->playerTuning->setText(
+            QString::fromStdString(Util::toString(myTuning)));
         dialog.reset();
         onEdited(true);
     }
@@ -38,6 +38,9 @@ public:
                        const TuningDictionary &dictionary);
     ~MixerItem();
 
+    /// Updates the item to show a different player, or changes to the player.
+    void update(const Player &player);
+
 signals:
     void playerEdited(const Player &player, bool undoable);
     void playerRemoved();
@@ -172,17 +172,27 @@ void PlaybackWidget::reset(const Document &doc)
 {
     ui->filterComboBox->blockSignals(true);
 
-    // Rebuild the filter list.
-    ui->filterComboBox->clear();
+    // Rebuild the filter list, unless it is unchanged (e.g. when switching
+    // between documents with the default filters).
+    QStringList filters;
     for (const ViewFilter &filter : doc.getScore().getViewFilters())
+        filters.append(QString::fromStdString(filter.getDescription()));
+
+    bool filters_changed = (filters.size() != ui->filterComboBox->count());
+    for (int i = 0; !filters_changed && i < filters.size(); ++i)
+        filters_changed = (filters[i] != ui->filterComboBox->itemText(i));
+
+    if (filters_changed)
     {
-        ui->filterComboBox->addItem(
-            QString::fromStdString(filter.getDescription()));
+        ui->filterComboBox->clear();
+        ui->filterComboBox->addItems(filters);
     }
 
     // Update the selected filter.
     if (doc.getViewOptions().getFilter())
         ui->filterComboBox->setCurrentIndex(*doc.getViewOptions().getFilter());
+    else if (!filters_changed)
+        ui->filterComboBox->setCurrentIndex(filters.isEmpty() ? -1 : 0);
 
     // Update the selected voice.
     myVoices->button(doc.getCaret().getLocation().getVoiceIndex())
@@ -0,0 +1,73 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <actions/insertnotes.h>
+#include <score/score.h>
+
+TEST_CASE("Actions/InsertNotes")
+{
+    Score score;
+    System system;
+    system.insertBarline(Barline(6, Barline::SingleBar));
+
+    Staff staff(6);
+    staff.getVoices()[0].insertPosition(Position(2));
+    staff.getVoices()[0].insertPosition(Position(4));
+    staff.getVoices()[0].insertPosition(Position(8));
+    system.insertStaff(staff);
+    score.insertSystem(system);
+
+    ScoreLocation location(score, 0, 0, 3);
+
+    std::vector<Position> positions;
+    for (int i = 0; i < 3; ++i)
+    {
+        Position pos(10 + i);
+        pos.insertNote(Note(1, i));
+        positions.push_back(pos);
+    }
+    std::vector<IrregularGrouping> groups;
+    groups.emplace_back(10, 3, 3, 2);
+
+    InsertNotes action(location, positions, groups);
+    action.redo();
+
+    // The new notes are inserted at positions 3-5, and the existing notes and
+    // barline after position 3 are shifted right by 2 positions.
+    const Voice &voice = location.getVoice();
+    REQUIRE(voice.getPositions().size() == 6);
+    REQUIRE(voice.getPositions()[0].getPosition() == 2);
+    REQUIRE(voice.getPositions()[1].getPosition() == 3);
+    REQUIRE(voice.getPositions()[1].getNotes()[0].getFretNumber() == 0);
+    REQUIRE(voice.getPositions()[3].getPosition() == 5);
+    REQUIRE(voice.getPositions()[4].getPosition() == 6);
+    REQUIRE(voice.getPositions()[5].getPosition() == 10);
+    REQUIRE(voice.getIrregularGroupings().size() == 1);
+    REQUIRE(voice.getIrregularGroupings()[0].getPosition() == 3);
+    REQUIRE(location.getSystem().getBarlines()[1].getPosition() == 8);
+
+    action.undo();
+
+    REQUIRE(voice.getPositions().size() == 3);
+    REQUIRE(voice.getPositions()[0].getPosition() == 2);
+    REQUIRE(voice.getPositions()[1].getPosition() == 4);
+    REQUIRE(voice.getPositions()[2].getPosition() == 8);
+    REQUIRE(voice.getIrregularGroupings().size() == 0);
+    REQUIRE(location.getSystem().getBarlines()[1].getPosition() == 6);
+}
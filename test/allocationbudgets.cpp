@@ -0,0 +1,110 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "allocationbudgets.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace AllocationBudgets
+{
+static std::map<std::string, AllocationStats> theBudgets;
+static std::map<std::string, AllocationStats> theMeasurements;
+static bool theIsUpdating = false;
+
+/// Headroom that is given when writing new budgets, so that minor differences
+/// between standard library implementations don't cause failures.
+static size_t addHeadroom(size_t measured, size_t minimum)
+{
+    return measured + std::max(measured / 4, minimum);
+}
+
+void load(const std::string &filename)
+{
+    std::ifstream input(filename);
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream ss(line);
+        std::string name;
+        AllocationStats budget;
+        if (ss >> name >> budget.myAllocations >> budget.myBytes)
+            theBudgets[name] = budget;
+    }
+}
+
+bool save(const std::string &filename)
+{
+    std::map<std::string, AllocationStats> budgets = theBudgets;
+    for (auto &&[name, stats] : theMeasurements)
+    {
+        AllocationStats &budget = budgets[name];
+        budget.myAllocations = addHeadroom(stats.myAllocations, 16);
+        budget.myBytes = addHeadroom(stats.myBytes, 1024);
+    }
+
+    std::ofstream output(filename);
+    output << "# Maximum allocations and bytes for each operation checked "
+              "with CHECK_ALLOCATIONS.\n"
+              "# Regenerate with: pte_tests "
+              "--update-allocation-budgets=<path to this file>\n"
+              "# name allocations bytes\n";
+
+    for (auto &&[name, budget] : budgets)
+    {
+        output << name << " " << budget.myAllocations << " " << budget.myBytes
+               << "\n";
+    }
+
+    return static_cast<bool>(output);
+}
+
+void setUpdating(bool updating)
+{
+    theIsUpdating = updating;
+}
+
+bool isEnforced()
+{
+#if defined(_MSC_VER) && defined(_DEBUG)
+    return false;
+#else
+    return !theIsUpdating;
+#endif
+}
+
+std::optional<AllocationStats> record(const std::string &name,
+                                      const AllocationStats &stats)
+{
+    // If an operation is measured several times, keep the largest values.
+    AllocationStats &measured = theMeasurements[name];
+    measured.myAllocations =
+        std::max(measured.myAllocations, stats.myAllocations);
+    measured.myBytes = std::max(measured.myBytes, stats.myBytes);
+
+    auto it = theBudgets.find(name);
+    if (it == theBudgets.end())
+        return std::nullopt;
+
+    return it->second;
+}
+} // namespace AllocationBudgets
@@ -0,0 +1,86 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEST_ALLOCATIONBUDGETS_H
+#define TEST_ALLOCATIONBUDGETS_H
+
+#include "allocationtracker.h"
+
+#include <doctest/doctest.h>
+#include <optional>
+#include <string>
+
+/// Allocation budgets are checked into allocation_budgets.txt, which contains
+/// the maximum number of allocations and bytes that each named operation may
+/// use. Every operation must have a budget. Running the tests with
+/// --update-allocation-budgets=<file> writes out new budgets from the measured
+/// values.
+namespace AllocationBudgets
+{
+/// Loads the budgets from the given file, if it exists.
+void load(const std::string &filename);
+
+/// Writes the budgets to a file, using the measurements of any operations that
+/// were run, with some headroom added.
+bool save(const std::string &filename);
+
+/// Sets whether the budgets are being regenerated, in which case the
+/// measurements are not checked against the current budgets.
+void setUpdating(bool updating);
+
+/// Returns whether the measurements should be checked against the budgets.
+/// This is not done while updating the budgets, or if the budgets are not
+/// meaningful for this build (e.g. MSVC's debug iterators allocate much more
+/// frequently).
+bool isEnforced();
+
+/// Records a measurement, and returns the budget that it should be checked
+/// against, if the operation is listed in the file.
+std::optional<AllocationStats> record(const std::string &name,
+                                      const AllocationStats &stats);
+} // namespace AllocationBudgets
+
+/// Runs the statement(s) and checks their allocations against the named
+/// budget. The check fails if there is no budget with that name.
+#define CHECK_ALLOCATIONS(name, ...)                                           \
+    do                                                                         \
+    {                                                                          \
+        AllocationTracker pte_tracker;                                         \
+        __VA_ARGS__;                                                           \
+        const AllocationStats pte_stats = pte_tracker.stop();                  \
+        const std::string pte_name = (name);                                   \
+        INFO("allocation budget: " << pte_name);                               \
+        const auto pte_budget =                                                \
+            AllocationBudgets::record(pte_name, pte_stats);                    \
+        if (!AllocationBudgets::isEnforced())                                  \
+            break;                                                             \
+        if (pte_budget)                                                        \
+        {                                                                      \
+            CHECK(pte_stats.myAllocations <= pte_budget->myAllocations);       \
+            CHECK(pte_stats.myBytes <= pte_budget->myBytes);                   \
+        }                                                                      \
+        else                                                                   \
+        {                                                                      \
+            FAIL_CHECK("no allocation budget for "                             \
+                       << pte_name << " (" << pte_stats.myAllocations          \
+                       << " allocations, " << pte_stats.myBytes                \
+                       << " bytes). Regenerate the budgets with "              \
+                          "--update-allocation-budgets=<file>.");              \
+        }                                                                      \
+    } while (false)
+
+#endif
@@ -0,0 +1,122 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "allocationtracker.h"
+
+#include <cstdlib>
+#include <new>
+
+static thread_local AllocationTracker *theActiveTracker = nullptr;
+
+AllocationTracker::AllocationTracker()
+    : myParent(theActiveTracker), myIsActive(true)
+{
+    theActiveTracker = this;
+}
+
+AllocationTracker::~AllocationTracker()
+{
+    stop();
+}
+
+AllocationStats AllocationTracker::stop()
+{
+    if (myIsActive)
+    {
+        myIsActive = false;
+        theActiveTracker = myParent;
+
+        if (myParent)
+        {
+            myParent->myStats.myAllocations += myStats.myAllocations;
+            myParent->myStats.myBytes += myStats.myBytes;
+        }
+    }
+
+    return myStats;
+}
+
+void AllocationTracker::recordAllocation(size_t bytes)
+{
+    if (AllocationTracker *tracker = theActiveTracker)
+    {
+        ++tracker->myStats.myAllocations;
+        tracker->myStats.myBytes += bytes;
+    }
+}
+
+// Replacements for the global allocation functions. The aligned overloads are
+// left alone, since they are rarely used and are paired with their own
+// deallocation functions.
+
+void *operator new(std::size_t size)
+{
+    AllocationTracker::recordAllocation(size);
+
+    // malloc(0) may return null, but operator new must return a unique
+    // pointer.
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    AllocationTracker::recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept
+{
+    return ::operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    std::free(ptr);
+}
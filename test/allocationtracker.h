@@ -0,0 +1,58 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEST_ALLOCATIONTRACKER_H
+#define TEST_ALLOCATIONTRACKER_H
+
+#include <cstddef>
+
+/// Allocation statistics gathered by an AllocationTracker.
+struct AllocationStats
+{
+    size_t myAllocations = 0;
+    size_t myBytes = 0;
+};
+
+/// Counts the heap allocations (via operator new) that are made by the
+/// current thread while the tracker is active. The replacement operators are
+/// only linked into the test and benchmark executables, and do no extra work
+/// unless a tracker exists.
+/// Trackers may be nested, in which case the outer tracker also includes the
+/// inner tracker's allocations.
+class AllocationTracker
+{
+public:
+    AllocationTracker();
+    ~AllocationTracker();
+
+    AllocationTracker(const AllocationTracker &) = delete;
+    AllocationTracker &operator=(const AllocationTracker &) = delete;
+
+    /// Stops counting, and returns the allocations made since the tracker was
+    /// created.
+    AllocationStats stop();
+
+    /// Records an allocation in the current thread's active tracker, if any.
+    static void recordAllocation(size_t bytes);
+
+private:
+    AllocationTracker *myParent;
+    AllocationStats myStats;
+    bool myIsActive;
+};
+
+#endif
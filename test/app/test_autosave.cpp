@@ -0,0 +1,79 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <algorithm>
+#include <app/autosave.h>
+#include <app/documentmanager.h>
+#include <fstream>
+#include <QTemporaryDir>
+
+TEST_CASE("App/Autosave/Save")
+{
+    QTemporaryDir temp_dir;
+    const std::filesystem::path dir =
+        std::filesystem::u8path(temp_dir.path().toStdString());
+
+    Document doc;
+    doc.getScore().insertSystem(System());
+
+    Autosave autosave(dir);
+    REQUIRE(autosave.isModified(doc));
+
+    autosave.save(doc);
+    REQUIRE(!autosave.isModified(doc));
+    autosave.waitForAll();
+
+    // The session is still running, so its files should not be recovered.
+    {
+        Autosave other_session(dir);
+        REQUIRE(other_session.findRecoverableFiles().empty());
+    }
+
+    autosave.markModified(doc);
+    REQUIRE(autosave.isModified(doc));
+}
+
+TEST_CASE("App/Autosave/Recover")
+{
+    QTemporaryDir temp_dir;
+    const std::filesystem::path dir =
+        std::filesystem::u8path(temp_dir.path().toStdString());
+
+    // Simulate the files left behind by a session that crashed.
+    const std::filesystem::path session_dir = dir / "crashed";
+    std::filesystem::create_directories(session_dir);
+    std::ofstream(session_dir / "document1.pt2") << "";
+    std::ofstream(session_dir / "document1.pt2.path") << "original.pt2";
+    std::ofstream(session_dir / "document2.pt2") << "";
+
+    Autosave autosave(dir);
+    std::vector<Autosave::RecoverableFile> files =
+        autosave.findRecoverableFiles();
+    REQUIRE(files.size() == 2);
+
+    std::sort(files.begin(), files.end(), [](auto &&a, auto &&b) {
+        return a.myAutosavePath < b.myAutosavePath;
+    });
+    REQUIRE(files[0].myOriginalPath == std::filesystem::path("original.pt2"));
+    REQUIRE(!files[1].myOriginalPath);
+
+    autosave.discardRecoverableFiles();
+    REQUIRE(autosave.findRecoverableFiles().empty());
+    REQUIRE(!std::filesystem::exists(session_dir));
+}
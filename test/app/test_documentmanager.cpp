@@ -49,3 +49,18 @@ TEST_CASE("App/Document")
     REQUIRE(!document.hasFilename());
 }
 
+
+TEST_CASE("App/DocumentManager/AddExistingDocument")
+{
+    DocumentManager manager;
+    manager.addDocument();
+
+    auto doc = std::make_unique<Document>();
+    doc->setFilename("test.pt2");
+    const Document *expected = doc.get();
+
+    Document &added = manager.addDocument(std::move(doc));
+    REQUIRE(&added == expected);
+    REQUIRE(manager.getCurrentDocumentIndex() == 1);
+    REQUIRE(manager.findDocument("test.pt2") == 1);
+}
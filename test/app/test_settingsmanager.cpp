@@ -39,3 +39,25 @@ TEST_CASE("App/SettingsManager")
 
     REQUIRE(count == 1);
 }
+
+TEST_CASE("App/SettingsManager/Snapshot")
+{
+    SettingsManager manager;
+
+    {
+        auto settings = manager.getWriteHandle();
+        settings->set("foo", 42);
+    }
+
+    std::shared_ptr<const SettingsTree> snapshot = manager.getSnapshot();
+    REQUIRE(snapshot->get<int>("foo") == 42);
+
+    {
+        auto settings = manager.getWriteHandle();
+        settings->set("foo", 7);
+    }
+
+    // Existing snapshots should not be modified.
+    REQUIRE(snapshot->get<int>("foo") == 42);
+    REQUIRE(manager.getSnapshot()->get<int>("foo") == 7);
+}
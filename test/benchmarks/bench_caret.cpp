@@ -0,0 +1,121 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <score/score.h>
+#include <score/scorelocation.h>
+#include <score/utils.h>
+#include <score/voiceutils.h>
+
+namespace
+{
+/// Creates a system with 1000 positions per voice, a bar every 8 positions,
+/// and various other symbols.
+void createSystem(Score &score)
+{
+    constexpr int num_positions = 1000;
+
+    System system;
+    Staff staff(6);
+    for (int i = 1; i <= num_positions; ++i)
+    {
+        if (i % 9 == 0)
+        {
+            system.insertBarline(Barline(i, Barline::SingleBar));
+            continue;
+        }
+
+        Position pos(i);
+        pos.insertNote(Note(i % 6, i % 24));
+        staff.getVoices()[0].insertPosition(pos);
+        staff.getVoices()[1].insertPosition(pos);
+
+        if (i % 50 == 1)
+        {
+            staff.insertDynamic(Dynamic(i, VolumeLevel::f));
+            system.insertChord(ChordText(i, ChordName()));
+            system.insertTempoMarker(TempoMarker(i));
+            system.insertDirection(Direction(i));
+            system.insertTextItem(TextItem(i, "text"));
+        }
+    }
+
+    system.insertStaff(staff);
+    system.insertStaff(staff);
+    score.insertSystem(system);
+}
+
+/// Performs the lookups that PowerTabEditor::updateCommands() does whenever
+/// the caret moves.
+int updateCommandState(const ConstScoreLocation &location)
+{
+    const System &system = location.getSystem();
+    const Staff &staff = location.getStaff();
+    const int position = location.getPositionIndex();
+
+    int count = 0;
+    count += location.getPosition() != nullptr;
+    count += location.getNote() != nullptr;
+    count += location.getBarline() != nullptr;
+    count += !location.getSelectedPositions().empty();
+    count += ScoreUtils::findByPosition(system.getTempoMarkers(), position) !=
+             nullptr;
+    count += ScoreUtils::findByPosition(system.getAlternateEndings(),
+                                        position) != nullptr;
+    count += ScoreUtils::findByPosition(staff.getDynamics(), position) !=
+             nullptr;
+    count += ScoreUtils::findByPosition(system.getChords(), position) !=
+             nullptr;
+    count += ScoreUtils::findByPosition(system.getTextItems(), position) !=
+             nullptr;
+    count += ScoreUtils::findByPosition(system.getDirections(), position) !=
+             nullptr;
+    count += ScoreUtils::findByPosition(system.getPlayerChanges(), position) !=
+             nullptr;
+    count += system.getPreviousBarline(position) != nullptr;
+    count += system.getNextBarline(position) != nullptr;
+    count += VoiceUtils::getNextPosition(location.getVoice(), position) !=
+             nullptr;
+    count += VoiceUtils::getPreviousPosition(location.getVoice(), position) !=
+             nullptr;
+
+    return count;
+}
+} // namespace
+
+PTE_BENCHMARK("Score/CaretMove")
+{
+    Score score;
+    createSystem(score);
+
+    ConstScoreLocation location(score);
+    int position = 0;
+    int result = 0;
+
+    // Move the caret through every position in the last staff.
+    location.setStaffIndex(1);
+    location.setVoiceIndex(1);
+    runner.measure("update command state", 10000, [&]() {
+        position = (position + 1) % 1000;
+        location.setPositionIndex(position);
+        location.setSelectionStart(position);
+        result += updateCommandState(location);
+    });
+
+    runner.report("(checksum)", result, "");
+}
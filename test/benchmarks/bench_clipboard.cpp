@@ -0,0 +1,88 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <score/binaryserialization.h>
+#include <score/position.h>
+#include <score/serialization.h>
+#include <sstream>
+
+namespace
+{
+/// Creates positions with three-note chords and a few properties, which is
+/// similar to a dense selection from a real score.
+std::vector<Position> createPositions(int count)
+{
+    std::vector<Position> positions;
+    for (int i = 0; i < count; ++i)
+    {
+        Position pos(i, Position::SixteenthNote);
+        pos.setProperty(Position::PalmMuting, i % 4 == 0);
+        for (int string = 0; string < 3; ++string)
+        {
+            Note note(string, (i + string) % 24);
+            note.setProperty(Note::HammerOnOrPullOff, i % 3 == 0);
+            pos.insertNote(note);
+        }
+
+        positions.push_back(pos);
+    }
+
+    return positions;
+}
+} // namespace
+
+/// Compares the JSON and binary formats for copying and pasting a large
+/// selection.
+PTE_BENCHMARK("Score/ClipboardFormats")
+{
+    const int num_positions = 5000;
+    const std::vector<Position> positions = createPositions(num_positions);
+    const std::string suffix = std::to_string(num_positions) + " positions";
+
+    std::string json;
+    runner.measure("copy " + suffix + " (JSON)", 10, [&]() {
+        std::ostringstream output;
+        ScoreUtils::save(output, "positions", positions);
+        json = output.str();
+    });
+    const double json_copy_time = runner.getLastResult();
+
+    std::string binary;
+    runner.measure("copy " + suffix + " (binary)", 10,
+                   [&]() { binary = ScoreUtils::saveBinary(positions); });
+    runner.report("copy speedup", json_copy_time / runner.getLastResult(),
+                  "x");
+
+    runner.measure("paste " + suffix + " (JSON)", 10, [&]() {
+        std::vector<Position> copy;
+        std::istringstream input(json);
+        ScoreUtils::load(input, "positions", copy);
+    });
+    const double json_paste_time = runner.getLastResult();
+
+    runner.measure("paste " + suffix + " (binary)", 10, [&]() {
+        std::vector<Position> copy;
+        ScoreUtils::loadBinary(binary, copy);
+    });
+    runner.report("paste speedup", json_paste_time / runner.getLastResult(),
+                  "x");
+
+    runner.report("JSON size", json.size() / 1024.0, "KiB");
+    runner.report("binary size", binary.size() / 1024.0, "KiB");
+}
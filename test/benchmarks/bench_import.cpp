@@ -0,0 +1,171 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <app/appinfo.h>
+#include <app/settingsmanager.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <formats/fileformatmanager.h>
+#include <map>
+#include <optional>
+#include <score/score.h>
+#include <string>
+#include <util/tracing.h>
+#include <vector>
+
+namespace
+{
+struct Corpus
+{
+    std::optional<FileFormat> myFormat;
+    std::vector<std::filesystem::path> myFiles;
+    uintmax_t myBytes = 0;
+};
+
+/// Returns the value at the given percentile (0-100) of the sorted values.
+double getPercentile(const std::vector<double> &values, double percentile)
+{
+    if (values.empty())
+        return 0;
+
+    const size_t index = static_cast<size_t>(
+        (percentile / 100.0) * static_cast<double>(values.size() - 1) + 0.5);
+    return values[std::min(index, values.size() - 1)];
+}
+} // namespace
+
+/// Measures the throughput of each importer over a directory of files, as
+/// used when converting files in bulk. The time spent in each phase of the
+/// import is collected from the "Import::" trace spans.
+/// Parameters:
+///   dir=<path>      Directory to search (recursively) for files to import.
+///                   By default, the test files are used.
+///   iterations=<n>  Number of times to import each file (default 5).
+PTE_BENCHMARK("Formats/Import")
+{
+    const int iterations = runner.getIntParameter("iterations", 5);
+    const std::filesystem::path dir = runner.getStringParameter(
+        "dir", AppInfo::getAbsolutePath("data"));
+
+    SettingsManager settings_manager;
+    FileFormatManager format_manager(settings_manager);
+
+    // Group the files by their format.
+    std::map<std::string, Corpus> corpora;
+    for (const auto &entry :
+         std::filesystem::recursive_directory_iterator(dir))
+    {
+        if (!entry.is_regular_file())
+            continue;
+
+        // Strip the leading '.' from the extension.
+        std::string extension = entry.path().extension().u8string();
+        if (!extension.empty())
+            extension.erase(0, 1);
+
+        if (!format_manager.extensionImportSupported(extension))
+            continue;
+
+        const FileFormat format = *format_manager.findFormat(extension);
+        Corpus &corpus = corpora[format.fileFilter()];
+        corpus.myFormat = format;
+        corpus.myFiles.push_back(entry.path());
+        corpus.myBytes += entry.file_size();
+    }
+
+    if (corpora.empty())
+        std::printf("  No files found in %s\n", dir.u8string().c_str());
+
+    for (auto &&[name, corpus] : corpora)
+    {
+        std::sort(corpus.myFiles.begin(), corpus.myFiles.end());
+
+        std::vector<double> latencies;
+        latencies.reserve(corpus.myFiles.size() * iterations);
+        int num_failures = 0;
+
+        Benchmark::resetPeakMemoryUsage();
+        Util::Tracing::start();
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (const std::filesystem::path &path : corpus.myFiles)
+            {
+                const auto file_start = std::chrono::steady_clock::now();
+                try
+                {
+                    Score score;
+                    format_manager.importFile(score, path, *corpus.myFormat);
+                }
+                catch (const std::exception &e)
+                {
+                    if (i == 0)
+                    {
+                        std::printf("  Failed to import %s: %s\n",
+                                    path.u8string().c_str(), e.what());
+                    }
+                    ++num_failures;
+                }
+
+                latencies.push_back(
+                    std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - file_start)
+                        .count());
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+        Util::Tracing::stop();
+        const std::map<std::string, int64_t> phases =
+            Util::Tracing::getTotalDurations();
+
+        std::sort(latencies.begin(), latencies.end());
+        const double num_imports = static_cast<double>(latencies.size());
+
+        std::printf("  %s: %zu files, %.1f KB\n", name.c_str(),
+                    corpus.myFiles.size(), corpus.myBytes / 1024.0);
+        runner.report("throughput",
+                      corpus.myBytes * iterations / 1.0e6 / seconds, "MB/s");
+        runner.report("files", num_imports / seconds, "files/s");
+        runner.report("p50 latency", getPercentile(latencies, 50), "ms");
+        runner.report("p99 latency", getPercentile(latencies, 99), "ms");
+
+        for (const char *phase :
+             { "Import::decode", "Import::parse", "Import::convert" })
+        {
+            auto it = phases.find(phase);
+            const double total = it != phases.end() ? it->second : 0;
+            runner.report(std::string(phase) + " per file",
+                          total / 1.0e6 / num_imports, "ms");
+        }
+
+        runner.report("peak RSS",
+                      Benchmark::getPeakMemoryUsage() / (1024.0 * 1024.0),
+                      "MB");
+
+        if (num_failures > 0)
+            runner.report("failed imports", num_failures, "");
+    }
+}
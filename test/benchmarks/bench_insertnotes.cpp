@@ -0,0 +1,65 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <actions/insertnotes.h>
+#include <score/score.h>
+#include <string>
+
+namespace
+{
+std::vector<Position> createPositions(int count)
+{
+    std::vector<Position> positions;
+    for (int i = 0; i < count; ++i)
+    {
+        Position pos(i, Position::SixteenthNote);
+        pos.insertNote(Note(i % 6, i % 24));
+        positions.push_back(pos);
+    }
+
+    return positions;
+}
+} // namespace
+
+/// Pastes a large selection into the middle of an existing system, which
+/// requires the existing notes to be shifted right.
+PTE_BENCHMARK("Actions/InsertNotes")
+{
+    for (int paste_size : { 100, 500, 2000 })
+    {
+        Score score;
+        {
+            Staff staff(6);
+            staff.getVoices()[0].insertPositions(createPositions(2000));
+
+            System system;
+            system.insertStaff(staff);
+            score.insertSystem(system);
+        }
+
+        ScoreLocation location(score, 0, 0, 1000);
+        InsertNotes action(location, createPositions(paste_size), {});
+
+        runner.measure("paste " + std::to_string(paste_size) + " positions",
+                       20, [&]() {
+                           action.redo();
+                           action.undo();
+                       });
+    }
+}
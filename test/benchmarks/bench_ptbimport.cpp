@@ -0,0 +1,172 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <app/appinfo.h>
+#include <formats/powertab_old/powertabdocument/note.h>
+#include <formats/powertab_old/powertabdocument/position.h>
+#include <formats/powertab_old/powertabdocument/powertabdocument.h>
+#include <formats/powertab_old/powertabdocument/powertabinputstream.h>
+#include <formats/powertab_old/powertabdocument/score.h>
+#include <formats/powertab_old/powertabdocument/staff.h>
+#include <formats/powertab_old/powertabdocument/system.h>
+#include <formats/powertab_old/powertaboldimporter.h>
+#include <score/score.h>
+#include <util/arena.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+const char *theFixtures[] = {
+    "alternate_endings.ptb", "barlines.ptb",      "bends.ptb",
+    "chordtext.ptb",         "directions.ptb",    "floating_text.ptb",
+    "guitar_ins.ptb",        "guitars.ptb",       "merge_multibar_rests.ptb",
+    "notes.ptb",             "positions.ptb",     "song_header.ptb",
+    "staves.ptb",            "tempo_markers.ptb", "tremolo_bars.ptb",
+    "volume_swells.ptb",
+};
+
+std::filesystem::path getFixturePath(const char *filename)
+{
+    return AppInfo::getAbsolutePath((std::string("data/") + filename).c_str());
+}
+
+/// Writes a larger version of a fixture. The seed chooses the fixture, and
+/// how many positions (up to num_positions) and notes (up to num_notes) are
+/// added to each voice of each staff.
+/// ScoreGenerator can't be used here, since only the legacy document can be
+/// saved as a .ptb file. The legacy classes also can't be edited, so the added
+/// notes are placeholders and the files are only suitable for measuring the
+/// reader.
+void generateFile(const std::filesystem::path &path, unsigned int seed,
+                  int num_positions, int num_notes)
+{
+    // As in ScoreGenerator, the standard distributions are avoided so that
+    // the files match across platforms.
+    std::mt19937 random(seed);
+    auto next = [&](int n) {
+        return static_cast<int>(random() % static_cast<uint32_t>(n));
+    };
+
+    PowerTabDocument::Document document;
+    document.Load(getFixturePath(
+        theFixtures[next(static_cast<int>(std::size(theFixtures)))]));
+
+    for (size_t i = 0; i < document.GetNumberOfScores(); ++i)
+    {
+        const PowerTabDocument::Score *score = document.GetScore(i);
+        for (size_t j = 0; j < score->GetSystemCount(); ++j)
+        {
+            const auto system = score->GetSystem(j);
+            for (size_t k = 0; k < system->GetStaffCount(); ++k)
+            {
+                const auto staff = system->GetStaff(k);
+                for (auto &voice : staff->positionArrays)
+                {
+                    const int positions =
+                        num_positions / 2 + next(num_positions / 2 + 1);
+                    for (int p = 0; p < positions; ++p)
+                    {
+                        auto position =
+                            std::make_shared<PowerTabDocument::Position>();
+                        // Positions without any notes are rests.
+                        const int notes = next(num_notes + 1);
+                        for (int n = 0; n < notes; ++n)
+                        {
+                            position->m_noteArray.push_back(
+                                std::make_shared<PowerTabDocument::Note>());
+                        }
+
+                        voice.push_back(position);
+                    }
+                }
+            }
+        }
+    }
+
+    document.Save(path);
+}
+
+/// Reads the document, optionally allocating its objects from an arena.
+void readDocument(const std::filesystem::path &path, bool use_arena)
+{
+    // The arena must outlive the document.
+    Util::Arena arena;
+    PowerTabDocument::Document document;
+
+    std::ifstream file(path, std::ifstream::in | std::ifstream::binary);
+    PowerTabDocument::PowerTabInputStream stream(file,
+                                                 use_arena ? &arena : nullptr);
+    document.GetHeader().Deserialize(stream);
+    document.Deserialize(stream);
+}
+} // namespace
+
+PTE_BENCHMARK("Formats/PowerTabOldImport")
+{
+    // Import each of the test fixtures, which are all small files.
+    PowerTabOldImporter importer;
+    runner.measure("import all fixtures", 50, [&]() {
+        for (const char *filename : theFixtures)
+        {
+            Score score;
+            importer.load(getFixturePath(filename), score);
+        }
+    });
+
+    // Generate a larger corpus, and compare reading it with and without an
+    // arena for the document's objects.
+    const int num_files = runner.getIntParameter("files", 20);
+    const int num_positions = runner.getIntParameter("positions", 250);
+    const int num_notes = runner.getIntParameter("notes", 3);
+    const int seed = runner.getIntParameter("seed", 1);
+
+    const std::filesystem::path dir =
+        std::filesystem::temp_directory_path() / "pte_ptb_benchmark";
+    std::filesystem::create_directories(dir);
+
+    std::vector<std::filesystem::path> corpus;
+    for (int i = 0; i < num_files; ++i)
+    {
+        corpus.push_back(dir / ("generated_" + std::to_string(i) + ".ptb"));
+        generateFile(corpus.back(), static_cast<unsigned int>(seed + i),
+                     num_positions, num_notes);
+    }
+
+    runner.measure("read generated corpus (heap)", 10, [&]() {
+        for (const auto &path : corpus)
+            readDocument(path, /* use_arena */ false);
+    });
+    const double heap_time = runner.getLastResult();
+
+    runner.measure("read generated corpus (arena)", 10, [&]() {
+        for (const auto &path : corpus)
+            readDocument(path, /* use_arena */ true);
+    });
+    const double arena_time = runner.getLastResult();
+
+    runner.report("arena speedup", heap_time / arena_time, "x");
+
+    std::filesystem::remove_all(dir);
+}
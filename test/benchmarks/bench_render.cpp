@@ -0,0 +1,156 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <app/settingsmanager.h>
+#include <app/viewoptions.h>
+#include <cstdio>
+#include <filesystem>
+#include <formats/fileformatmanager.h>
+#include <generator/scoregenerator.h>
+#include <painters/layoutinfo.h>
+#include <painters/scoreclickevent.h>
+#include <painters/systemrenderer.h>
+#include <QGraphicsItem>
+#include <QPalette>
+#include <score/score.h>
+
+namespace
+{
+std::vector<SystemLayout> computeLayouts(const Score &score)
+{
+    std::vector<SystemLayout> layouts;
+    layouts.reserve(score.getSystems().size());
+
+    for (int i = 0, n = static_cast<int>(score.getSystems().size()); i < n; ++i)
+    {
+        const System &system = score.getSystems()[i];
+
+        SystemLayout system_layout;
+        for (int j = 0, m = static_cast<int>(system.getStaves().size()); j < m;
+             ++j)
+        {
+            system_layout.push_back(
+                std::make_shared<LayoutInfo>(ConstScoreLocation(score, i, j)));
+        }
+
+        layouts.push_back(std::move(system_layout));
+    }
+
+    return layouts;
+}
+
+int countItems(const QGraphicsItem &item)
+{
+    int count = 1;
+    for (const QGraphicsItem *child : item.childItems())
+        count += countItems(*child);
+    return count;
+}
+} // namespace
+
+/// Parameters:
+///   file=<path>     Renders the given file instead of a generated score.
+///   systems=<n>     Number of systems in the generated score (default 20).
+///   staves=<n>      Number of staves in each system (default 2).
+///   voices=<n>      Number of voices with notes in each staff (default 1).
+///   density=<n>     Percentage of positions with symbols (default 25).
+///   seed=<n>        Seed for the generated score (default 1).
+///   iterations=<n>  Number of iterations per phase (default 5).
+PTE_BENCHMARK("Render/Score")
+{
+    const int iterations = runner.getIntParameter("iterations", 5);
+    const std::string filename = runner.getStringParameter("file", "");
+
+    SettingsManager settings_manager;
+    Score score;
+
+    if (!filename.empty())
+    {
+        FileFormatManager format_manager(settings_manager);
+        const std::filesystem::path path(filename);
+
+        // Strip the leading '.' from the extension.
+        std::string extension = path.extension().string();
+        if (!extension.empty())
+            extension.erase(0, 1);
+
+        auto format = format_manager.findFormat(extension);
+        if (!format)
+        {
+            std::printf("  Unsupported file format: %s\n", filename.c_str());
+            return;
+        }
+
+        format_manager.importFile(score, path, *format);
+    }
+    else
+    {
+        ScoreGenerator::Options options;
+        options.mySystems = runner.getIntParameter("systems", 20);
+        options.myStaves = runner.getIntParameter("staves", 2);
+        options.myPlayers = options.myStaves;
+        options.myVoices = runner.getIntParameter("voices", 1);
+        options.myDensity = runner.getIntParameter("density", 25);
+        options.mySeed = runner.getIntParameter("seed", 1);
+        ScoreGenerator::generate(score, options);
+    }
+
+    int num_staves = 0;
+    for (const System &system : score.getSystems())
+        num_staves += static_cast<int>(system.getStaves().size());
+
+    runner.report("Systems", score.getSystems().size(), "");
+    runner.report("Staves", num_staves, "");
+
+    std::vector<SystemLayout> layouts;
+    runner.measure("LayoutInfo (all staves)", iterations,
+                   [&]() { layouts = computeLayouts(score); });
+
+    const ScoreClickEvent click_event;
+    const QPalette palette;
+    const ViewOptions view_options;
+
+    int num_items = 0;
+    auto render_systems = [&](bool use_layouts) {
+        num_items = 0;
+        for (int i = 0, n = static_cast<int>(score.getSystems().size()); i < n;
+             ++i)
+        {
+            SystemLayout system_layouts;
+            if (use_layouts)
+                system_layouts = layouts[i];
+
+            SystemRenderer render(click_event, palette, score, view_options);
+            std::unique_ptr<QGraphicsItem> item(
+                render(score.getSystems()[i], i, system_layouts));
+            num_items += countItems(*item);
+        }
+    };
+
+    runner.measure("SystemRenderer (precomputed layouts)", iterations,
+                   [&]() { render_systems(true); });
+    const double render_time = runner.getLastResult();
+
+    runner.measure("SystemRenderer (including layout)", iterations,
+                   [&]() { render_systems(false); });
+
+    runner.report("Graphics items", num_items, "items");
+    runner.report("Time per item", render_time / std::max(num_items, 1), "ns");
+}
@@ -0,0 +1,93 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <score/score.h>
+
+namespace
+{
+/// Fills the score with the given number of systems, each containing two
+/// staves with a bar of eighth notes.
+void createScore(Score &score, int num_systems)
+{
+    Staff staff(6);
+    for (int i = 0; i < 8; ++i)
+    {
+        Position pos(i, Position::EighthNote);
+        pos.insertNote(Note(i % 6, i));
+        staff.getVoices()[0].insertPosition(pos);
+    }
+
+    System system;
+    system.insertStaff(staff);
+    system.insertStaff(staff);
+
+    for (int i = 0; i < num_systems; ++i)
+        score.insertSystem(system);
+}
+
+/// Changes the fret number of a note, through the same mutable accessors that
+/// the editing actions use.
+void editNote(Score &score, int edit)
+{
+    const int num_systems = static_cast<int>(score.getSystems().size());
+    System &system = score.getSystems()[(edit * 7) % num_systems];
+    Staff &staff = system.getStaves()[edit % 2];
+    Position &pos = staff.getVoices()[0].getPositions()[edit % 8];
+    Note &note = pos.getNotes()[0];
+    note.setFretNumber((note.getFretNumber() + 1) % 24);
+}
+} // namespace
+
+PTE_BENCHMARK("Score/Hash")
+{
+    constexpr int num_systems = 500;
+    constexpr int num_edits = 1000;
+
+    Score score;
+    createScore(score, num_systems);
+    const Score &const_score = score;
+
+    int edit = 0;
+    runner.measure("edit only", num_edits, [&]() { editNote(score, ++edit); });
+    const double edit_time = runner.getLastResult();
+
+    // Rehash the score after every edit, which only revisits the edited
+    // system, staff and voice.
+    runner.measure("edit + incremental hash", num_edits, [&]() {
+        editNote(score, ++edit);
+        const_score.getHash();
+    });
+    const double incremental_time = runner.getLastResult();
+
+    // For comparison, rehash the entire score from scratch.
+    runner.measure("full hash", 20, [&]() {
+        for (System &system : score.getSystems())
+        {
+            for (Staff &staff : system.getStaves())
+            {
+                for (Voice &voice : staff.getVoices())
+                    voice.getPositions(); // Discard the cached hash.
+            }
+        }
+        const_score.getHash();
+    });
+
+    runner.report("hash maintenance overhead per edit",
+                  incremental_time - edit_time, "ns");
+}
@@ -0,0 +1,168 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include "../allocationtracker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Benchmark
+{
+void Runner::measure(const std::string &label, int iterations,
+                     const std::function<void()> &fn)
+{
+    // Count the allocations during the warm-up iteration, so that the tracking
+    // doesn't affect the timings.
+    AllocationTracker tracker;
+    fn();
+    const AllocationStats allocations = tracker.stop();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        fn();
+    const auto end = std::chrono::steady_clock::now();
+
+    myLastResult =
+        std::chrono::duration<double, std::nano>(end - start).count() /
+        std::max(iterations, 1);
+
+    std::printf("  %-50s %14.0f ns/iter  (%d iterations, %zu allocs, %zu "
+                "bytes)\n",
+                label.c_str(), myLastResult, iterations,
+                allocations.myAllocations, allocations.myBytes);
+}
+
+int Runner::getIntParameter(const std::string &name, int default_value) const
+{
+    auto it = myParameters.find(name);
+    return it != myParameters.end() ? std::stoi(it->second) : default_value;
+}
+
+std::string Runner::getStringParameter(const std::string &name,
+                                       const std::string &default_value) const
+{
+    auto it = myParameters.find(name);
+    return it != myParameters.end() ? it->second : default_value;
+}
+
+void Runner::setParameter(const std::string &name, const std::string &value)
+{
+    myParameters[name] = value;
+}
+
+void Runner::report(const std::string &label, double value,
+                    const std::string &units)
+{
+    std::printf("  %-50s %14.2f %s\n", label.c_str(), value, units.c_str());
+}
+
+Registration::Registration(const char *name, Function fn)
+    : myName(name), myFunction(fn)
+{
+    getRegistry().push_back(*this);
+}
+
+std::vector<Registration> &getRegistry()
+{
+    static std::vector<Registration> registry;
+    return registry;
+}
+
+size_t getPeakMemoryUsage()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters)))
+    {
+        return 0;
+    }
+
+    return counters.PeakWorkingSetSize;
+#else
+#ifdef __linux__
+    // Unlike getrusage(), this reflects any reset of the peak.
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind("VmHWM:", 0) == 0)
+            return std::stoull(line.substr(6)) * 1024;
+    }
+#endif
+
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+void resetPeakMemoryUsage()
+{
+#ifdef __linux__
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+#endif
+}
+
+int run(int argc, char *argv[])
+{
+    Runner runner;
+    std::string filter;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const size_t separator = arg.find('=');
+
+        if (separator == std::string::npos)
+            filter = arg;
+        else
+            runner.setParameter(arg.substr(0, separator),
+                                arg.substr(separator + 1));
+    }
+
+    for (const Registration &benchmark : getRegistry())
+    {
+        if (std::string(benchmark.myName).find(filter) == std::string::npos)
+            continue;
+
+        std::printf("%s\n", benchmark.myName);
+        benchmark.myFunction(runner);
+    }
+
+    return 0;
+}
+} // namespace Benchmark
@@ -0,0 +1,106 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARKS_BENCHMARK_H
+#define BENCHMARKS_BENCHMARK_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/// A minimal harness for timing parts of the application. Benchmarks are
+/// registered with PTE_BENCHMARK() and are run by the pte_benchmarks
+/// executable, optionally filtered by name.
+namespace Benchmark
+{
+class Runner
+{
+public:
+    /// Runs the function for the given number of iterations (after a single
+    /// warm-up iteration), and reports the average time per iteration along
+    /// with the number of allocations made by the warm-up iteration.
+    void measure(const std::string &label, int iterations,
+                 const std::function<void()> &fn);
+
+    /// Reports a value which was computed by the benchmark, such as a size
+    /// or a ratio between two measurements.
+    void report(const std::string &label, double value,
+                const std::string &units);
+
+    /// Returns the average time per iteration (in nanoseconds) of the most
+    /// recent call to measure().
+    double getLastResult() const
+    {
+        return myLastResult;
+    }
+
+    /// Returns a parameter that was given on the command line as name=value,
+    /// or the default value if it was not provided.
+    int getIntParameter(const std::string &name, int default_value) const;
+    std::string getStringParameter(const std::string &name,
+                                   const std::string &default_value) const;
+
+    void setParameter(const std::string &name, const std::string &value);
+
+private:
+    double myLastResult = 0;
+    std::map<std::string, std::string> myParameters;
+};
+
+struct Registration
+{
+    using Function = void (*)(Runner &);
+
+    Registration(const char *name, Function fn);
+
+    const char *myName;
+    Function myFunction;
+};
+
+/// Returns all of the registered benchmarks.
+std::vector<Registration> &getRegistry();
+
+/// Returns the peak resident memory usage of the process, in bytes.
+size_t getPeakMemoryUsage();
+
+/// Resets the peak memory usage to the current usage, so that the peak of a
+/// single benchmark can be measured. This is only supported on Linux, and
+/// elsewhere the peak covers the lifetime of the process.
+void resetPeakMemoryUsage();
+
+/// Runs the benchmarks. The arguments are a filter (each benchmark whose name
+/// contains the filter is run), and any number of name=value parameters.
+int run(int argc, char *argv[]);
+} // namespace Benchmark
+
+#define PTE_BENCHMARK_CONCAT2(a, b) a##b
+#define PTE_BENCHMARK_CONCAT(a, b) PTE_BENCHMARK_CONCAT2(a, b)
+
+/// Defines a benchmark function, which receives a Benchmark::Runner named
+/// `runner`.
+#define PTE_BENCHMARK(name)                                                    \
+    static void PTE_BENCHMARK_CONCAT(pteBenchmark, __LINE__)(                  \
+        Benchmark::Runner & runner);                                           \
+    static const Benchmark::Registration PTE_BENCHMARK_CONCAT(                 \
+        pteBenchmarkReg, __LINE__)(name,                                       \
+                                   &PTE_BENCHMARK_CONCAT(pteBenchmark,         \
+                                                         __LINE__));           \
+    static void PTE_BENCHMARK_CONCAT(pteBenchmark, __LINE__)(                  \
+        Benchmark::Runner & runner)
+
+#endif
@@ -0,0 +1,30 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmark.h"
+
+#include <QCoreApplication>
+
+/// Usage: pte_benchmarks [filter] [name=value ...]
+/// Runs each benchmark whose name contains the filter, or all benchmarks if no
+/// filter is given.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    return Benchmark::run(argc, argv);
+}
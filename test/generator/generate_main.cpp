@@ -0,0 +1,100 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scoregenerator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <map>
+#include <string>
+
+/// Usage: pte_generate <output.pt2> [name=value ...]
+/// Writes a generated score, e.g. for stress testing the editor or for use
+/// with the `dir=` parameter of the import benchmark. The parameters are:
+///   seed, systems, staves, players, voices, bars (per system), positions
+///   (per bar), density (see ScoreGenerator::Options).
+///   files=<n>  Writes n files named e.g. output-1.pt2, each with a different
+///              seed.
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <output.pt2> [name=value ...]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ScoreGenerator::Options options;
+    int num_files = 1;
+    int seed = static_cast<int>(options.mySeed);
+
+    const std::map<std::string, int *> parameters = {
+        { "seed", &seed },
+        { "systems", &options.mySystems },
+        { "staves", &options.myStaves },
+        { "players", &options.myPlayers },
+        { "voices", &options.myVoices },
+        { "bars", &options.myBarsPerSystem },
+        { "positions", &options.myPositionsPerBar },
+        { "density", &options.myDensity },
+        { "files", &num_files },
+    };
+
+    const std::filesystem::path output = argv[1];
+
+    try
+    {
+        for (int i = 2; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const size_t separator = arg.find('=');
+            auto it = parameters.find(arg.substr(0, separator));
+
+            if (separator == std::string::npos || it == parameters.end())
+            {
+                std::fprintf(stderr, "Unknown parameter: %s\n", arg.c_str());
+                return EXIT_FAILURE;
+            }
+
+            *it->second = std::stoi(arg.substr(separator + 1));
+        }
+
+        for (int i = 0; i < num_files; ++i)
+        {
+            options.mySeed = static_cast<unsigned int>(seed + i);
+
+            std::filesystem::path path = output;
+            if (num_files > 1)
+            {
+                path.replace_filename(output.stem().u8string() + "-" +
+                                      std::to_string(i + 1) +
+                                      output.extension().u8string());
+            }
+
+            ScoreGenerator::generateFile(path, options);
+            std::printf("Wrote %s\n", path.u8string().c_str());
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
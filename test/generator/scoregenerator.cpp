@@ -0,0 +1,332 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scoregenerator.h"
+
+#include <cstdint>
+#include <formats/powertab/powertabexporter.h>
+#include <random>
+#include <score/score.h>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+/// Wraps a Mersenne Twister, whose output is fully specified by the standard.
+/// The standard distributions are not, so they are avoided in order for the
+/// generated scores to match across platforms.
+class Random
+{
+public:
+    explicit Random(unsigned int seed) : myEngine(seed)
+    {
+    }
+
+    /// Returns a value in the range [0, n).
+    int next(int n)
+    {
+        return static_cast<int>(myEngine() % static_cast<uint32_t>(n));
+    }
+
+    /// Returns true with the given probability (0-100).
+    bool chance(int percent)
+    {
+        return next(100) < percent;
+    }
+
+    template <typename Enum>
+    Enum nextEnum(Enum count)
+    {
+        return static_cast<Enum>(next(static_cast<int>(count)));
+    }
+
+    /// Returns one of the values.
+    template <typename T, size_t N>
+    const T &pick(const T (&values)[N])
+    {
+        return values[next(static_cast<int>(N))];
+    }
+
+private:
+    std::mt19937 myEngine;
+};
+
+const VolumeLevel theVolumeLevels[] = {
+    VolumeLevel::ppp, VolumeLevel::pp, VolumeLevel::p,  VolumeLevel::mp,
+    VolumeLevel::mf,  VolumeLevel::f,  VolumeLevel::ff, VolumeLevel::fff
+};
+
+const Position::SimpleProperty thePositionProperties[] = {
+    Position::Vibrato,      Position::LetRing,        Position::PalmMuting,
+    Position::Staccato,     Position::Marcato,        Position::Sforzando,
+    Position::PickStrokeUp, Position::PickStrokeDown, Position::Fermata
+};
+
+const Note::SimpleProperty theNoteProperties[] = {
+    Note::HammerOnOrPullOff, Note::Muted, Note::GhostNote,
+    Note::NaturalHarmonic,   Note::Octave8va
+};
+
+void checkRange(const char *name, int value, int min, int max)
+{
+    if (value < min || value > max)
+    {
+        throw std::invalid_argument(std::string(name) + " must be between " +
+                                    std::to_string(min) + " and " +
+                                    std::to_string(max));
+    }
+}
+
+/// Returns a player change which assigns the players to the staves, starting
+/// from the given offset.
+PlayerChange makePlayerChange(int position, const ScoreGenerator::Options &o,
+                              int offset)
+{
+    PlayerChange change(position);
+    for (int i = 0; i < o.myPlayers; ++i)
+    {
+        change.insertActivePlayer((i + offset) % o.myStaves,
+                                  ActivePlayer(i, i));
+    }
+
+    return change;
+}
+
+Note makeNote(Random &random, const ScoreGenerator::Options &o)
+{
+    Note note(random.next(6), random.next(25));
+
+    if (random.chance(o.myDensity))
+    {
+        note.setProperty(random.pick(theNoteProperties));
+    }
+
+    if (random.chance(o.myDensity / 4))
+    {
+        const auto type = random.nextEnum(Bend::ImmediateRelease);
+        note.setBend(Bend(type, 1 + random.next(12)));
+    }
+
+    return note;
+}
+
+/// Fills one voice of a bar, where the first position is at the given
+/// position.
+void generateBar(Voice &voice, int voice_index, int start, Random &random,
+                 const ScoreGenerator::Options &o)
+{
+    // Lower voices are played in quarter notes.
+    const int step = voice_index + 1;
+    const auto duration =
+        voice_index == 0 ? Position::EighthNote : Position::QuarterNote;
+
+    for (int i = 0; i < o.myPositionsPerBar; i += step)
+    {
+        Position pos(start + i, duration);
+
+        if (random.chance(o.myDensity / 5))
+        {
+            pos.setRest();
+            voice.insertPosition(pos);
+            continue;
+        }
+
+        // Add chords of up to three notes, on different strings.
+        const int num_notes = random.chance(o.myDensity) ? 3 : 1;
+        for (int n = 0; n < num_notes; ++n)
+        {
+            Note note = makeNote(random, o);
+            if (!Utils::findByString(pos, note.getString()))
+                pos.insertNote(note);
+        }
+
+        if (random.chance(o.myDensity))
+        {
+            pos.setProperty(random.pick(thePositionProperties));
+        }
+
+        if (random.chance(o.myDensity / 4))
+        {
+            const auto type = random.nextEnum(TremoloBar::Type::InvertedDip);
+            pos.setTremoloBar(TremoloBar(type, 1 + random.next(12)));
+        }
+
+        voice.insertPosition(pos);
+    }
+
+    // Group the first three notes of the bar as a triplet.
+    if (o.myPositionsPerBar >= 3 * step && random.chance(o.myDensity / 2))
+        voice.insertIrregularGrouping(IrregularGrouping(start, 3, 3, 2));
+}
+} // namespace
+
+namespace ScoreGenerator
+{
+void generate(Score &score, const Options &o)
+{
+    checkRange("systems", o.mySystems, 1, 100000);
+    checkRange("staves", o.myStaves, 1, 64);
+    checkRange("players", o.myPlayers, 1, 64);
+    checkRange("voices", o.myVoices, 1, Staff::NUM_VOICES);
+    checkRange("bars", o.myBarsPerSystem, 1, 1000);
+    checkRange("positions", o.myPositionsPerBar, 1, 64);
+    checkRange("density", o.myDensity, 0, 100);
+
+    Random random(o.mySeed);
+
+    ScoreInfo info;
+    SongData song;
+    song.setTitle("Generated Score (seed " + std::to_string(o.mySeed) + ")");
+    info.setSongData(song);
+    score.setScoreInfo(info);
+
+    for (int i = 0; i < o.myPlayers; ++i)
+    {
+        Player player;
+        player.setDescription("Player " + std::to_string(i + 1));
+        score.insertPlayer(player);
+
+        Instrument instrument;
+        instrument.setDescription("Instrument " + std::to_string(i + 1));
+        instrument.setMidiPreset(random.next(128));
+        score.insertInstrument(instrument);
+    }
+
+    // Each bar has a barline followed by its positions.
+    const int bar_width = o.myPositionsPerBar + 1;
+    bool pending_ending = false;
+
+    for (int s = 0; s < o.mySystems; ++s)
+    {
+        System system;
+
+        for (int b = 1; b < o.myBarsPerSystem; ++b)
+            system.insertBarline(Barline(b * bar_width, Barline::SingleBar));
+        system.getBarlines().back().setPosition(o.myBarsPerSystem * bar_width);
+
+        if (s == 0)
+        {
+            system.insertTempoMarker(TempoMarker(0));
+            system.insertPlayerChange(makePlayerChange(0, o, 0));
+        }
+        else if (o.myStaves > 1 && random.chance(o.myDensity / 2))
+        {
+            // Move the players to different staves.
+            system.insertPlayerChange(
+                makePlayerChange(0, o, 1 + random.next(o.myStaves - 1)));
+        }
+
+        // Finish a repeat from the previous system with the second ending.
+        if (pending_ending)
+        {
+            AlternateEnding ending(0);
+            ending.addNumber(2);
+            system.insertAlternateEnding(ending);
+            pending_ending = false;
+        }
+        else if (o.myBarsPerSystem > 1 && s + 1 < o.mySystems &&
+                 random.chance(o.myDensity / 2))
+        {
+            // Repeat the system, with the last bar as the first ending.
+            system.getBarlines().front().setBarType(Barline::RepeatStart);
+
+            Barline &end_bar = system.getBarlines().back();
+            end_bar.setBarType(Barline::RepeatEnd);
+            end_bar.setRepeatCount(2);
+
+            AlternateEnding ending((o.myBarsPerSystem - 1) * bar_width + 1);
+            ending.addNumber(1);
+            system.insertAlternateEnding(ending);
+            pending_ending = true;
+        }
+
+        // Returns a position within one of the bars.
+        auto random_position = [&]() {
+            return random.next(o.myBarsPerSystem) * bar_width + 1 +
+                   random.next(o.myPositionsPerBar);
+        };
+
+        if (random.chance(o.myDensity / 2))
+        {
+            Direction direction(random_position());
+            direction.insertSymbol(DirectionSymbol(
+                random.nextEnum(DirectionSymbol::NumSymbolTypes)));
+            system.insertDirection(direction);
+        }
+
+        if (random.chance(o.myDensity / 4))
+        {
+            TempoMarker marker(random_position());
+            marker.setBeatsPerMinute(60 + random.next(140));
+            system.insertTempoMarker(marker);
+        }
+
+        for (int b = 0; b < o.myBarsPerSystem; ++b)
+        {
+            const int start = b * bar_width + 1;
+
+            if (random.chance(o.myDensity))
+                system.insertChord(ChordText(start, ChordName()));
+            if (random.chance(o.myDensity / 2))
+            {
+                system.insertTextItem(
+                    TextItem(start + random.next(o.myPositionsPerBar),
+                             "Text " + std::to_string(s) + "." +
+                                 std::to_string(b)));
+            }
+        }
+
+        for (int i = 0; i < o.myStaves; ++i)
+        {
+            Staff staff(6);
+            if (random.chance(50))
+                staff.setClefType(Staff::BassClef);
+
+            for (int v = 0; v < o.myVoices; ++v)
+            {
+                for (int b = 0; b < o.myBarsPerSystem; ++b)
+                {
+                    generateBar(staff.getVoices()[v], v, b * bar_width + 1,
+                                random, o);
+                }
+            }
+
+            for (int b = 0; b < o.myBarsPerSystem; ++b)
+            {
+                if (random.chance(o.myDensity / 2))
+                {
+                    staff.insertDynamic(Dynamic(
+                        b * bar_width + 1, random.pick(theVolumeLevels)));
+                }
+            }
+
+            system.insertStaff(staff);
+        }
+
+        score.insertSystem(system);
+    }
+}
+
+void generateFile(const std::filesystem::path &path, const Options &options)
+{
+    Score score;
+    generate(score, options);
+
+    PowerTabExporter exporter;
+    exporter.save(path, score);
+}
+} // namespace ScoreGenerator
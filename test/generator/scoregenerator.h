@@ -0,0 +1,58 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GENERATOR_SCOREGENERATOR_H
+#define GENERATOR_SCOREGENERATOR_H
+
+#include <filesystem>
+
+class Score;
+
+/// Builds synthetic scores of arbitrary size for stress testing, using the
+/// same score APIs as the editor and importers.
+namespace ScoreGenerator
+{
+struct Options
+{
+    /// Seeds the random choices. The same options always produce the same
+    /// score, on any platform.
+    unsigned int mySeed = 1;
+    int mySystems = 20;
+    int myStaves = 2;
+    int myPlayers = 2;
+    /// Number of voices with notes in each staff.
+    int myVoices = 1;
+    int myBarsPerSystem = 4;
+    /// Number of positions in each bar, which are filled with eighth notes.
+    int myPositionsPerBar = 8;
+    /// Percentage (0-100) of positions which have additional symbols, such
+    /// as bends or text items.
+    int myDensity = 25;
+};
+
+/// Fills the (empty) score with systems, staves, players and notes. Depending
+/// on the density, this also adds irregular groupings, bends, tremolo bars,
+/// repeats, alternate endings, directions, player changes, text items and
+/// other symbols.
+/// @throws std::invalid_argument if the options are out of range.
+void generate(Score &score, const Options &options);
+
+/// Generates a score and saves it as a .pt2 file.
+void generateFile(const std::filesystem::path &path, const Options &options);
+} // namespace ScoreGenerator
+
+#endif
@@ -0,0 +1,147 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <formats/powertab/powertabimporter.h>
+#include <generator/scoregenerator.h>
+#include <score/score.h>
+#include <stdexcept>
+
+TEST_CASE("Generator/ScoreGenerator/Reproducible")
+{
+    ScoreGenerator::Options options;
+    options.mySystems = 10;
+    options.mySeed = 42;
+
+    Score score1;
+    ScoreGenerator::generate(score1, options);
+    Score score2;
+    ScoreGenerator::generate(score2, options);
+    REQUIRE(score1 == score2);
+
+    options.mySeed = 43;
+    Score score3;
+    ScoreGenerator::generate(score3, options);
+    REQUIRE(!(score1 == score3));
+}
+
+TEST_CASE("Generator/ScoreGenerator/Structure")
+{
+    ScoreGenerator::Options options;
+    options.mySystems = 30;
+    options.myStaves = 3;
+    options.myPlayers = 2;
+    options.myVoices = 2;
+    options.myBarsPerSystem = 5;
+    options.myPositionsPerBar = 6;
+    options.myDensity = 100;
+
+    Score generated_score;
+    ScoreGenerator::generate(generated_score, options);
+    const Score &score = generated_score;
+
+    REQUIRE(score.getSystems().size() == 30);
+    REQUIRE(score.getPlayers().size() == 2);
+    REQUIRE(score.getInstruments().size() == 2);
+
+    int num_player_changes = 0;
+    int num_repeats = 0;
+    int num_endings = 0;
+    int num_directions = 0;
+    int num_text_items = 0;
+    int num_groups = 0;
+    int num_bends = 0;
+    int num_tremolo_bars = 0;
+
+    for (const System &system : score.getSystems())
+    {
+        REQUIRE(system.getStaves().size() == 3);
+        REQUIRE(system.getBarlines().size() == 6);
+        REQUIRE(system.getBarlines().back().getPosition() == 35);
+
+        num_player_changes += system.getPlayerChanges().size();
+        num_repeats += system.getBarlines()[0].getBarType() ==
+                       Barline::RepeatStart;
+        num_endings += system.getAlternateEndings().size();
+        num_directions += system.getDirections().size();
+        num_text_items += system.getTextItems().size();
+
+        for (const Staff &staff : system.getStaves())
+        {
+            REQUIRE(!staff.getVoices()[0].getPositions().empty());
+            REQUIRE(!staff.getVoices()[1].getPositions().empty());
+
+            for (const Voice &voice : staff.getVoices())
+            {
+                num_groups += voice.getIrregularGroupings().size();
+
+                for (const Position &pos : voice.getPositions())
+                {
+                    // Positions must be within a bar.
+                    REQUIRE(system.getPreviousBarline(pos.getPosition()));
+                    REQUIRE(system.getNextBarline(pos.getPosition()));
+                    REQUIRE(pos.getPosition() % 7 != 0);
+
+                    num_tremolo_bars += pos.hasTremoloBar();
+                    for (const Note &note : pos.getNotes())
+                        num_bends += note.hasBend();
+                }
+            }
+        }
+    }
+
+    REQUIRE(num_player_changes > 1);
+    REQUIRE(num_repeats > 0);
+    REQUIRE(num_endings == 2 * num_repeats);
+    REQUIRE(num_directions > 0);
+    REQUIRE(num_text_items > 0);
+    REQUIRE(num_groups > 0);
+    REQUIRE(num_bends > 0);
+    REQUIRE(num_tremolo_bars > 0);
+}
+
+TEST_CASE("Generator/ScoreGenerator/InvalidOptions")
+{
+    ScoreGenerator::Options options;
+    options.myVoices = Staff::NUM_VOICES + 1;
+
+    Score score;
+    REQUIRE_THROWS_AS(ScoreGenerator::generate(score, options),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Generator/ScoreGenerator/WriteFile")
+{
+    ScoreGenerator::Options options;
+    options.mySystems = 5;
+    options.myDensity = 50;
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "pte_generated_score.pt2";
+    ScoreGenerator::generateFile(path, options);
+
+    Score expected;
+    ScoreGenerator::generate(expected, options);
+
+    Score score;
+    PowerTabImporter importer;
+    importer.load(path, score);
+    std::filesystem::remove(path);
+
+    REQUIRE(score == expected);
+}
@@ -0,0 +1,122 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <midi/midifile.h>
+#include <midi/offlinerenderer.h>
+#include <score/score.h>
+#include <util/threadpool.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static std::vector<float> render(const Score &score, int sample_rate,
+                                 unsigned int num_threads)
+{
+    MidiFile file;
+    file.load(score, MidiFile::LoadOptions());
+
+    std::vector<float> samples;
+    OfflineRenderer renderer(sample_rate);
+    for (int i = 0, n = static_cast<int>(score.getPlayers().size()); i < n; ++i)
+    {
+        const Player &player = score.getPlayers()[i];
+        renderer.setPlayerMix(i, player.getMaxVolume(), player.getPan());
+    }
+
+    Util::ThreadPool pool(num_threads);
+    const int64_t num_frames = renderer.render(
+        file,
+        [&](const float *data, int frames) {
+            samples.insert(samples.end(), data, data + 2 * frames);
+        },
+        pool);
+
+    REQUIRE(samples.size() == static_cast<size_t>(2 * num_frames));
+    return samples;
+}
+
+TEST_CASE("Midi/OfflineRenderer")
+{
+    // A bar with four quarter notes, at 120bpm.
+    Score score;
+    score.insertPlayer(Player());
+    score.insertInstrument(Instrument());
+    {
+        System system;
+        PlayerChange change;
+        change.insertActivePlayer(0, ActivePlayer(0, 0));
+        system.insertPlayerChange(change);
+
+        Staff staff(6);
+        Voice &voice = staff.getVoices()[0];
+        for (int i = 0; i < 4; ++i)
+        {
+            Position pos(i, Position::QuarterNote);
+            pos.insertNote(Note(2, 5));
+            voice.insertPosition(pos);
+        }
+        system.insertStaff(staff);
+
+        score.insertSystem(system);
+    }
+
+    const int sample_rate = 8000;
+    const std::vector<float> samples = render(score, sample_rate, 2);
+
+    // The bar lasts for two seconds, followed by the release of the last note.
+    REQUIRE(samples.size() >= 2 * 2 * sample_rate);
+    REQUIRE(samples.size() < 2 * 8 * sample_rate);
+
+    auto peak = [&](int start_frame, int end_frame) {
+        float result = 0;
+        for (int i = 2 * start_frame; i < 2 * end_frame; ++i)
+            result = std::max(result, std::abs(samples[i]));
+        return result;
+    };
+
+    // The notes should be audible, and silent by the end.
+    REQUIRE(peak(0, sample_rate / 2) > 0.01f);
+    REQUIRE(peak(sample_rate, 3 * sample_rate / 2) > 0.01f);
+    const int num_frames = static_cast<int>(samples.size() / 2);
+    REQUIRE(peak(num_frames - 100, num_frames) < 0.001f);
+
+    // The output does not depend on the number of threads.
+    REQUIRE(render(score, sample_rate, 1) == samples);
+
+    auto channel_peak = [](const std::vector<float> &data, int channel) {
+        float result = 0;
+        for (size_t i = channel; i < data.size(); i += 2)
+            result = std::max(result, std::abs(data[i]));
+        return result;
+    };
+
+    // Panning the player hard left silences the right channel.
+    score.getPlayers()[0].setPan(0);
+    std::vector<float> panned = render(score, sample_rate, 1);
+    REQUIRE(channel_peak(panned, 0) > 0.01f);
+    REQUIRE(channel_peak(panned, 1) < 0.001f);
+
+    // Lowering the player's volume makes the output quieter.
+    score.getPlayers()[0].setPan(64);
+    score.getPlayers()[0].setMaxVolume(Player::MAX_VOLUME / 2);
+    std::vector<float> quieter = render(score, sample_rate, 1);
+    REQUIRE(channel_peak(quieter, 0) < 0.75f * channel_peak(samples, 0));
+    REQUIRE(channel_peak(quieter, 0) > 0.01f);
+}
@@ -0,0 +1,108 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <midi/midifile.h>
+#include <midi/playbackloop.h>
+#include <score/score.h>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Midi/PlaybackLoop")
+{
+    // Two bars with four quarter notes each, at 120bpm.
+    Score score;
+    score.insertPlayer(Player());
+    score.insertInstrument(Instrument());
+    {
+        System system;
+        system.insertBarline(Barline(4, Barline::SingleBar));
+
+        PlayerChange change;
+        change.insertActivePlayer(0, ActivePlayer(0, 0));
+        system.insertPlayerChange(change);
+
+        Staff staff(6);
+        Voice &voice = staff.getVoices()[0];
+        for (int i : { 0, 1, 2, 3, 5, 6, 7, 8 })
+        {
+            Position pos(i, Position::QuarterNote);
+            pos.insertNote(Note(2, i));
+            voice.insertPosition(pos);
+        }
+        system.insertStaff(staff);
+
+        score.insertSystem(system);
+    }
+
+    MidiFile::LoadOptions options;
+    options.myRecordPositionChanges = true;
+    MidiFile file;
+    file.load(score, options);
+
+    SUBCASE("Second bar")
+    {
+        PlaybackLoop loop(file, SystemLocation(0, 4), SystemLocation(0, 8));
+        REQUIRE(!loop.isEmpty());
+        REQUIRE(loop.getDuration() == 2s);
+
+        // The player's instrument etc should be restored for each iteration.
+        REQUIRE(!loop.getSetupEvents().empty());
+        for (const MidiEvent &event : loop.getSetupEvents())
+            REQUIRE(!event.isNoteOnOff());
+
+        int note_ons = 0;
+        int note_offs = 0;
+        PlaybackLoop::Time prev_time(0);
+        for (const PlaybackLoop::Event &event : loop.getEvents())
+        {
+            REQUIRE(event.myTime >= prev_time);
+            REQUIRE(event.myTime <= loop.getDuration());
+            prev_time = event.myTime;
+
+            if (!event.myEvent.isNoteOnOff())
+                continue;
+
+            REQUIRE(event.myEvent.getLocation() >= SystemLocation(0, 5));
+            if (event.myEvent.getStatusByte() >= MidiEvent::NoteOn &&
+                event.myEvent.getData()[2] > 0)
+            {
+                REQUIRE(event.myTime == note_ons * 500ms);
+                ++note_ons;
+            }
+            else
+                ++note_offs;
+        }
+
+        REQUIRE(note_ons == 4);
+        REQUIRE(note_offs == 4);
+    }
+
+    SUBCASE("Single position")
+    {
+        PlaybackLoop loop(file, SystemLocation(0, 1), SystemLocation(0, 1));
+        REQUIRE(loop.getDuration() == 500ms);
+    }
+
+    SUBCASE("Empty range")
+    {
+        PlaybackLoop loop(file, SystemLocation(1, 0), SystemLocation(1, 8));
+        REQUIRE(loop.isEmpty());
+        REQUIRE(loop.getEvents().empty());
+    }
+}
@@ -0,0 +1,81 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <midi/midifile.h>
+#include <score/score.h>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Midi/PlaybackTimeline")
+{
+    // Two bars, where the first bar is repeated and the second bar has a
+    // tempo change to 60 bpm.
+    Score score;
+    {
+        System system;
+        system.getBarlines()[0].setBarType(Barline::RepeatStart);
+        system.insertBarline(Barline(10, Barline::RepeatEnd, 2));
+
+        TempoMarker marker(11);
+        marker.setBeatsPerMinute(60);
+        system.insertTempoMarker(marker);
+
+        Staff staff(6);
+        Voice &voice = staff.getVoices()[0];
+        voice.insertPosition(Position(0, Position::QuarterNote));
+        voice.insertPosition(Position(1, Position::QuarterNote));
+        voice.insertPosition(Position(12, Position::QuarterNote));
+        system.insertStaff(staff);
+
+        score.insertSystem(system);
+    }
+
+    MidiFile file;
+    file.load(score, MidiFile::LoadOptions());
+    const PlaybackTimeline &timeline = file.getTimeline();
+
+    // Each bar lasts for 4 beats.
+    auto &&bars = timeline.getBars();
+    REQUIRE(bars.size() == 3);
+    REQUIRE(bars[0].myLocation == SystemLocation(0, 0));
+    REQUIRE(bars[0].myStartTime == 0s);
+    REQUIRE(bars[1].myLocation == SystemLocation(0, 0));
+    REQUIRE(bars[1].myStartTime == 2s);
+    REQUIRE(bars[2].myLocation == SystemLocation(0, 10));
+    REQUIRE(bars[2].myStartTime == 4s);
+    REQUIRE(bars[2].myEndTime == 8s);
+    REQUIRE(timeline.getDuration() == 8s);
+
+    REQUIRE(timeline.getEntries().size() == 5);
+
+    // The first visit to a location is used.
+    REQUIRE(timeline.getTime(SystemLocation(0, 1)) == 500ms);
+    REQUIRE(timeline.getTime(SystemLocation(0, 12)) == 4s);
+    // Locations without any notes map to the start of the bar.
+    REQUIRE(timeline.getTime(SystemLocation(0, 15)) == 4s);
+    REQUIRE(!timeline.getTime(SystemLocation(1, 0)));
+
+    REQUIRE(timeline.getLocation(0s) == SystemLocation(0, 0));
+    REQUIRE(timeline.getLocation(2600ms) == SystemLocation(0, 1));
+    REQUIRE(timeline.getLocation(5s) == SystemLocation(0, 12));
+    REQUIRE(!timeline.getLocation(9s));
+
+    REQUIRE(timeline.getTick(timeline.getTime(3000)) == 3000);
+    REQUIRE(timeline.getTick(5s) == 4320);
+}
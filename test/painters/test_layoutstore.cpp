@@ -0,0 +1,122 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <painters/layoutstore.h>
+#include <score/score.h>
+
+static void initScore(Score &score)
+{
+    Player player;
+    score.insertPlayer(player);
+
+    System system;
+    Staff staff(6);
+    staff.getVoices()[0].insertPosition(Position(1));
+    system.insertStaff(staff);
+    system.insertStaff(staff);
+
+    PlayerChange change;
+    change.insertActivePlayer(0, ActivePlayer(0, 0));
+    system.insertPlayerChange(change);
+
+    score.insertSystem(system);
+    score.insertSystem(system);
+}
+
+TEST_CASE("Painters/LayoutStore/StaffKeys")
+{
+    Score score;
+    initScore(score);
+    const Score &const_score = score;
+
+    const std::vector<size_t> keys = LayoutStore::computeKeys(const_score, 0);
+    REQUIRE(keys.size() == 2);
+    REQUIRE(keys[0] != keys[1]);
+    REQUIRE(LayoutStore::computeKeys(const_score, 0) == keys);
+
+    // The same contents in another system has a different layout location.
+    const std::vector<size_t> next_keys =
+        LayoutStore::computeKeys(const_score, 1);
+    REQUIRE(next_keys != keys);
+
+    SUBCASE("Chord names")
+    {
+        // A system-level item that doesn't add positions to the system does
+        // not affect the layout of the staves.
+        score.getSystems()[0].insertChord(ChordText(5, ChordName()));
+        REQUIRE(LayoutStore::computeKeys(const_score, 0) == keys);
+
+        // Extending the system changes the spacing of every staff.
+        score.getSystems()[0].insertChord(ChordText(40, ChordName()));
+        const std::vector<size_t> new_keys =
+            LayoutStore::computeKeys(const_score, 0);
+        REQUIRE(new_keys[0] != keys[0]);
+        REQUIRE(new_keys[1] != keys[1]);
+    }
+
+    SUBCASE("Edited staff")
+    {
+        Staff &staff = score.getSystems()[0].getStaves()[1];
+        staff.getVoices()[0].getPositions()[0].insertNote(Note(2, 3));
+
+        const std::vector<size_t> new_keys =
+            LayoutStore::computeKeys(const_score, 0);
+        REQUIRE(new_keys[0] == keys[0]);
+        REQUIRE(new_keys[1] != keys[1]);
+    }
+
+    SUBCASE("Next system")
+    {
+        // The layout can depend on the same staff in the next system.
+        Staff &staff = score.getSystems()[1].getStaves()[0];
+        staff.getVoices()[0].getPositions()[0].insertNote(Note(2, 3));
+
+        const std::vector<size_t> new_keys =
+            LayoutStore::computeKeys(const_score, 0);
+        REQUIRE(new_keys[0] != keys[0]);
+        REQUIRE(new_keys[1] == keys[1]);
+    }
+
+    SUBCASE("Key signature")
+    {
+        score.getSystems()[0].getBarlines()[0].setKeySignature(
+            KeySignature(KeySignature::Major, 2, true));
+
+        const std::vector<size_t> new_keys =
+            LayoutStore::computeKeys(const_score, 0);
+        REQUIRE(new_keys[0] != keys[0]);
+        REQUIRE(new_keys[1] != keys[1]);
+    }
+
+    SUBCASE("Tuning")
+    {
+        Tuning tuning;
+        tuning.setNotes({ 62, 57, 53, 48, 43, 38 });
+        score.getPlayers()[0].setTuning(tuning);
+
+        REQUIRE(LayoutStore::computeKeys(const_score, 0) != keys);
+        REQUIRE(LayoutStore::computeKeys(const_score, 1) != next_keys);
+    }
+
+    SUBCASE("Line spacing")
+    {
+        score.setLineSpacing(score.getLineSpacing() + 1);
+        REQUIRE(LayoutStore::computeKeys(const_score, 0) != keys);
+    }
+}
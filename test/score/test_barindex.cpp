@@ -0,0 +1,117 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <score/score.h>
+#include <score/scorelocation.h>
+#include <stdexcept>
+#include <util/tostring.h>
+
+/// Creates a score with three bars in the first system, one in the second, and
+/// two in the third.
+static void initScore(Score &score)
+{
+    System system1;
+    system1.insertBarline(Barline(4, Barline::SingleBar));
+    system1.insertBarline(Barline(8, Barline::SingleBar));
+    score.insertSystem(system1);
+
+    System system2;
+    score.insertSystem(system2);
+
+    System system3;
+    system3.insertBarline(Barline(6, Barline::DoubleBar));
+    score.insertSystem(system3);
+}
+
+TEST_CASE("Score/BarIndex/BarNumbers")
+{
+    Score score;
+    initScore(score);
+
+    const BarIndex &index = score.getBarIndex();
+    REQUIRE(index.getBarCount() == 6);
+
+    REQUIRE(index.getFirstBarNumber(0) == 1);
+    REQUIRE(index.getFirstBarNumber(1) == 4);
+    REQUIRE(index.getFirstBarNumber(2) == 5);
+
+    REQUIRE(index.getBarNumber(0, 2) == 3);
+    REQUIRE(index.getBarNumber(2, 1) == 6);
+    // The end bar has the number of the next system's first bar.
+    REQUIRE(index.getBarNumber(0, 3) == 4);
+}
+
+TEST_CASE("Score/BarIndex/FindBar")
+{
+    Score score;
+    initScore(score);
+
+    const BarIndex &index = score.getBarIndex();
+    REQUIRE(index.findBar(1) == std::make_pair(0, 0));
+    REQUIRE(index.findBar(3) == std::make_pair(0, 2));
+    REQUIRE(index.findBar(4) == std::make_pair(1, 0));
+    REQUIRE(index.findBar(5) == std::make_pair(2, 0));
+    REQUIRE(index.findBar(6) == std::make_pair(2, 1));
+
+    REQUIRE_THROWS_AS(index.findBar(0), std::out_of_range);
+    REQUIRE_THROWS_AS(index.findBar(7), std::out_of_range);
+
+    for (int bar = 1; bar <= index.getBarCount(); ++bar)
+    {
+        auto [system, barline] = index.findBar(bar);
+        REQUIRE(index.getBarNumber(system, barline) == bar);
+    }
+}
+
+TEST_CASE("Score/BarIndex/Invalidation")
+{
+    Score score;
+    initScore(score);
+    REQUIRE(score.getBarIndex().getBarCount() == 6);
+
+    // Modifying a system should invalidate the cached index.
+    score.getSystems()[1].insertBarline(Barline(3, Barline::SingleBar));
+    REQUIRE(score.getBarIndex().getBarCount() == 7);
+    REQUIRE(score.getBarIndex().getFirstBarNumber(2) == 6);
+
+    score.removeSystem(0);
+    REQUIRE(score.getBarIndex().getBarCount() == 4);
+
+    score.insertSystem(System(), 0);
+    REQUIRE(score.getBarIndex().getBarCount() == 5);
+    REQUIRE(score.getBarIndex().getFirstBarNumber(1) == 2);
+}
+
+TEST_CASE("Score/BarIndex/LocationText")
+{
+    Score score;
+    initScore(score);
+
+    ScoreLocation location(score, 0, 0, 5);
+    REQUIRE(Util::toString(location).rfind("Bar: 2, System: 1", 0) == 0);
+
+    // The end bar is part of the system's last bar.
+    const System &system = score.getSystems()[0];
+    location.setPositionIndex(system.getBarlines().back().getPosition());
+    REQUIRE(Util::toString(location).rfind("Bar: 3, System: 1", 0) == 0);
+
+    location.setSystemIndex(2);
+    location.setPositionIndex(6);
+    REQUIRE(Util::toString(location).rfind("Bar: 6, System: 3", 0) == 0);
+}
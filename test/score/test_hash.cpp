@@ -0,0 +1,72 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <score/score.h>
+
+TEST_CASE("Score/Hash/Voice")
+{
+    Voice voice1;
+    Voice voice2;
+    REQUIRE(voice1.getHash() == voice2.getHash());
+
+    voice1.insertPosition(Position(3));
+    REQUIRE(voice1.getHash() != voice2.getHash());
+
+    voice2.insertPosition(Position(3));
+    REQUIRE(voice1.getHash() == voice2.getHash());
+
+    // Modifying a position through the voice should invalidate the hash.
+    voice1.getPositions()[0].insertNote(Note(2, 5));
+    REQUIRE(voice1.getHash() != voice2.getHash());
+}
+
+TEST_CASE("Score/Hash/Score")
+{
+    Score score;
+    {
+        System system;
+        Staff staff;
+        staff.getVoices()[0].insertPosition(Position(1));
+        system.insertStaff(staff);
+
+        score.insertSystem(system);
+        score.insertSystem(system);
+    }
+
+    const Score &const_score = score;
+    const size_t score_hash = const_score.getHash();
+    const size_t system_hash = const_score.getSystems()[1].getHash();
+    const size_t staff_hash =
+        const_score.getSystems()[1].getStaves()[0].getHash();
+    REQUIRE(const_score.getSystems()[0].getHash() == system_hash);
+
+    // Edit a note in the first system, and check that only the hashes along
+    // the path to the note are changed.
+    Voice &voice = score.getSystems()[0].getStaves()[0].getVoices()[0];
+    voice.getPositions()[0].insertNote(Note(0, 3));
+
+    REQUIRE(const_score.getHash() != score_hash);
+    REQUIRE(const_score.getSystems()[0].getHash() != system_hash);
+    REQUIRE(const_score.getSystems()[0].getStaves()[0].getHash() !=
+            staff_hash);
+    REQUIRE(const_score.getSystems()[1].getHash() == system_hash);
+
+    // Copies have the same hash.
+    REQUIRE(score.clone()->getHash() == const_score.getHash());
+}
@@ -194,3 +194,20 @@ TEST_CASE("Score/Position/Serialization")
 
     Serialization::test("position", position);
 }
+
+TEST_CASE("Score/Position/BinarySerialization/InvalidData")
+{
+    Position position(3, Position::QuarterNote);
+    position.insertNote(Note(2, 5));
+    const std::string data = ScoreUtils::saveBinary(position);
+
+    Position copy;
+    ScoreUtils::loadBinary(data, copy);
+    REQUIRE(copy == position);
+
+    // Truncated data, extra data, or data that isn't in the binary format.
+    REQUIRE_THROWS(
+        ScoreUtils::loadBinary(data.substr(0, data.size() - 1), copy));
+    REQUIRE_THROWS(ScoreUtils::loadBinary(data + "x", copy));
+    REQUIRE_THROWS(ScoreUtils::loadBinary("{\"version\": 8}", copy));
+}
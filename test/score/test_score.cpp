@@ -80,6 +80,22 @@ TEST_CASE("Score/Score/ViewFilters")
     REQUIRE(score.getViewFilters()[0] == filter1);
 }
 
+TEST_CASE("Score/Score/Clone")
+{
+    Score score;
+    score.insertSystem(System());
+    score.insertPlayer(Player());
+    score.setLineSpacing(12);
+
+    std::unique_ptr<Score> copy = score.clone();
+    REQUIRE(*copy == score);
+
+    // Modifying the original should not affect the copy.
+    score.removeSystem(0);
+    REQUIRE(copy->getSystems().size() == 1);
+    REQUIRE(copy->getLineSpacing() == 12);
+}
+
 // Verify that we don't rely on the order of JSON keys (see bug #294).
 TEST_CASE("Score/Score/Deserialization")
 {
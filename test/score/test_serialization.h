@@ -20,6 +20,7 @@
 
 #include <doctest/doctest.h>
 
+#include <score/binaryserialization.h>
 #include <score/serialization.h>
 #include <sstream>
 
@@ -38,6 +39,12 @@ namespace Serialization {
         ScoreUtils::load(input, name, copy);
 
         REQUIRE(original == copy);
+
+        // The binary format (e.g. for the clipboard) should also round trip.
+        T binary_copy;
+        ScoreUtils::loadBinary(ScoreUtils::saveBinary(original), binary_copy);
+
+        REQUIRE(original == binary_copy);
     }
 }
 
@@ -47,3 +47,28 @@ TEST_CASE("Score/Utils/GetCurrentPlayers")
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 0, 7));
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 1, 0));
 }
+
+TEST_CASE("Score/Utils/FindInRange")
+{
+    Voice voice;
+    for (int i : { 1, 3, 4, 8 })
+        voice.insertPosition(Position(i));
+
+    auto positions = ScoreUtils::findInRange(voice.getPositions(), 2, 8);
+    REQUIRE(positions.size() == 3);
+    REQUIRE(positions.front().getPosition() == 3);
+    REQUIRE(positions.back().getPosition() == 8);
+
+    REQUIRE(ScoreUtils::findInRange(voice.getPositions(), 5, 7).empty());
+    REQUIRE(ScoreUtils::findInRange(voice.getPositions(), 4, 3).empty());
+    REQUIRE(ScoreUtils::findInRange(voice.getPositions(), 0, 100).size() == 4);
+
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 4) == 2);
+    REQUIRE(ScoreUtils::findIndexByPosition(voice.getPositions(), 5) == -1);
+
+    REQUIRE(ScoreUtils::findNext(voice.getPositions(), 4)->getPosition() == 8);
+    REQUIRE(ScoreUtils::findNext(voice.getPositions(), 8) == nullptr);
+    REQUIRE(ScoreUtils::findPrevious(voice.getPositions(), 4)->getPosition() ==
+            3);
+    REQUIRE(ScoreUtils::findPrevious(voice.getPositions(), 1) == nullptr);
+}
@@ -0,0 +1,216 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include "allocationbudgets.h"
+
+#include <actions/addnote.h>
+#include <actions/addsystem.h>
+#include <actions/edittabnumber.h>
+#include <actions/insertnotes.h>
+#include <actions/removeposition.h>
+#include <algorithm>
+#include <app/appinfo.h>
+#include <formats/gp7/gp7importer.h>
+#include <formats/gpx/gpximporter.h>
+#include <formats/guitar_pro/guitarproimporter.h>
+#include <formats/powertab/powertabimporter.h>
+#include <formats/powertab_old/powertaboldimporter.h>
+#include <midi/midifile.h>
+#include <painters/layoutinfo.h>
+#include <score/score.h>
+
+static std::string getDataPath(const std::string &filename)
+{
+    return AppInfo::getAbsolutePath(("data/" + filename).c_str());
+}
+
+static void checkImport(FileFormatImporter &importer,
+                        std::initializer_list<const char *> filenames)
+{
+    for (const char *filename : filenames)
+    {
+        Score score;
+        const std::string path = getDataPath(filename);
+        CHECK_ALLOCATIONS(std::string("Import/") + filename,
+                          importer.load(path, score));
+    }
+}
+
+TEST_CASE("Allocations/Import/PowerTab")
+{
+    PowerTabImporter importer;
+    checkImport(importer, { "merge_multibar_rests_correct.pt2",
+                            "reordered.pt2", "test_editstaff.pt2",
+                            "test_shiftstring.pt2", "test_viewfilter.pt2" });
+}
+
+TEST_CASE("Allocations/Import/PowerTabOld")
+{
+    PowerTabOldImporter importer;
+    checkImport(importer,
+                { "alternate_endings.ptb", "barlines.ptb", "bends.ptb",
+                  "chordtext.ptb", "directions.ptb", "floating_text.ptb",
+                  "guitar_ins.ptb", "guitars.ptb", "merge_multibar_rests.ptb",
+                  "notes.ptb", "positions.ptb", "song_header.ptb",
+                  "staves.ptb", "tempo_markers.ptb", "tremolo_bars.ptb",
+                  "volume_swells.ptb" });
+}
+
+TEST_CASE("Allocations/Import/GuitarPro")
+{
+    GuitarProImporter importer;
+    checkImport(importer,
+                { "alt_endings.gp5", "barlines.gp5", "bends.gp5",
+                  "directions.gp5", "gracenote.gp5", "harmonics.gp5",
+                  "irregular.gp5", "keys.gp5", "notes.gp5", "positions.gp5",
+                  "rehearsal_signs.gp5", "tempos.gp5", "text.gp5",
+                  "time_signatures.gp5", "tremolo_bars.gp5" });
+}
+
+TEST_CASE("Allocations/Import/Gp7")
+{
+    Gp7Importer importer;
+    checkImport(importer,
+                { "alternate_endings.gp", "bars.gp", "bends.gp",
+                  "directions.gp", "fermatas.gp", "harmonics.gp",
+                  "irregular_groups.gp", "notes.gp", "score_info.gp",
+                  "text.gp", "tracks.gp", "tremolo_bars.gp",
+                  "words_and_music.gp" });
+}
+
+TEST_CASE("Allocations/Import/Gpx")
+{
+    GpxImporter importer;
+    checkImport(importer, { "text.gpx", "tremolo_bars.gpx" });
+}
+
+static void loadPowerTabOld(const char *filename, Score &score)
+{
+    PowerTabOldImporter importer;
+    importer.load(getDataPath(filename), score);
+}
+
+TEST_CASE("Allocations/MidiFile")
+{
+    // Use the same options as for playback.
+    MidiFile::LoadOptions options;
+    options.myEnableMetronome = true;
+    options.myRecordPositionChanges = true;
+
+    for (const char *filename :
+         { "notes.ptb", "bends.ptb", "alternate_endings.ptb" })
+    {
+        Score score;
+        loadPowerTabOld(filename, score);
+
+        MidiFile file;
+        CHECK_ALLOCATIONS(std::string("MidiFile::load/") + filename,
+                          file.load(score, options));
+    }
+}
+
+TEST_CASE("Allocations/LayoutInfo")
+{
+    for (const char *filename : { "notes.ptb", "positions.ptb" })
+    {
+        Score score;
+        loadPowerTabOld(filename, score);
+
+        auto layout_score = [&]() {
+            for (int i = 0, n = static_cast<int>(score.getSystems().size());
+                 i < n; ++i)
+            {
+                const System &system = score.getSystems()[i];
+                for (int j = 0, m = static_cast<int>(system.getStaves().size());
+                     j < m; ++j)
+                {
+                    LayoutInfo layout(ConstScoreLocation(score, i, j));
+                }
+            }
+        };
+
+        // Lay out the score once beforehand so that Qt's font caches are
+        // populated, and only the layout itself is measured.
+        layout_score();
+
+        CHECK_ALLOCATIONS(std::string("LayoutInfo/") + filename,
+                          layout_score());
+    }
+}
+
+TEST_CASE("Allocations/Actions")
+{
+    Score score;
+    loadPowerTabOld("notes.ptb", score);
+
+    const Voice &voice =
+        score.getSystems()[0].getStaves()[0].getVoices().front();
+    auto positions = voice.getPositions();
+    auto pos_it = std::find_if(
+        positions.begin(), positions.end(),
+        [](const Position &pos) { return !pos.getNotes().empty(); });
+    REQUIRE(pos_it != positions.end());
+    const int position_index = pos_it->getPosition();
+    const int string = pos_it->getNotes().front().getString();
+
+    // Each action is redone and then undone, so that they all operate on the
+    // original score.
+    ScoreLocation location(score, 0, 0, positions.back().getPosition() + 1);
+    CHECK_ALLOCATIONS("Actions/AddNote", {
+        AddNote action(location, Note(2, 3), Position::QuarterNote);
+        action.redo();
+        action.undo();
+    });
+
+    location.setPositionIndex(position_index);
+    location.setSelectionStart(position_index);
+    location.setString(string);
+
+    CHECK_ALLOCATIONS("Actions/EditTabNumber", {
+        EditTabNumber action(location, 7);
+        action.redo();
+        action.undo();
+    });
+
+    CHECK_ALLOCATIONS("Actions/RemovePosition", {
+        RemovePosition action(location);
+        action.redo();
+        action.undo();
+    });
+
+    CHECK_ALLOCATIONS("Actions/AddSystem", {
+        AddSystem action(score, 1);
+        action.redo();
+        action.undo();
+    });
+
+    std::vector<Position> new_positions;
+    for (int i = 0; i < 32; ++i)
+    {
+        Position pos(i, Position::EighthNote);
+        pos.insertNote(Note(i % 6, i % 12));
+        new_positions.push_back(pos);
+    }
+
+    CHECK_ALLOCATIONS("Actions/InsertNotes", {
+        InsertNotes action(location, new_positions, {});
+        action.redo();
+        action.undo();
+    });
+}
@@ -17,13 +17,51 @@
 
 #define DOCTEST_CONFIG_IMPLEMENT
 #include <doctest/doctest.h>
-#include <QCoreApplication>
+
+#include "allocationbudgets.h"
+
+#include <app/appinfo.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <QGuiApplication>
 
 int main(int argc, char *argv[])
 {
-    // Initialize QCoreApplication for any tests that use
-    // QCoreApplication::applicationDirPath().
-    QCoreApplication app(argc, argv);
+    // Initialize QGuiApplication for any tests that use
+    // QCoreApplication::applicationDirPath(), or fonts (e.g. for the layout
+    // of a staff). The offscreen platform is used unless QT_QPA_PLATFORM is
+    // set, so no display is required.
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+
+    AllocationBudgets::load(
+        AppInfo::getAbsolutePath("data/allocation_budgets.txt"));
+
+    // Check for --update-allocation-budgets=<file>, which doctest ignores.
+    static const char update_option[] = "--update-allocation-budgets=";
+    std::string budget_output;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], update_option, sizeof(update_option) - 1) ==
+            0)
+        {
+            budget_output = argv[i] + sizeof(update_option) - 1;
+        }
+    }
+
+    AllocationBudgets::setUpdating(!budget_output.empty());
+
+    const int result = doctest::Context(argc, argv).run();
+
+    if (!budget_output.empty() && !AllocationBudgets::save(budget_output))
+    {
+        std::cerr << "Failed to write allocation budgets to " << budget_output
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
 
-    return doctest::Context(argc, argv).run();
+    return result;
 }
@@ -0,0 +1,65 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <util/arena.h>
+
+TEST_CASE("Util/Arena/Alignment")
+{
+    Util::Arena arena(64);
+
+    for (size_t alignment : { 1, 2, 4, 8, 16, 32, 64 })
+    {
+        void *ptr = arena.allocate(3, alignment);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0);
+    }
+}
+
+TEST_CASE("Util/Arena/Blocks")
+{
+    Util::Arena arena(64);
+    REQUIRE(arena.getReservedBytes() == 0);
+
+    // Allocations are packed into the first block until it is full.
+    char *a = static_cast<char *>(arena.allocate(16, 1));
+    char *b = static_cast<char *>(arena.allocate(16, 1));
+    REQUIRE(b == a + 16);
+    REQUIRE(arena.getReservedBytes() == 64);
+
+    // Large allocations get a block of their own.
+    arena.allocate(1000, 8);
+    REQUIRE(arena.getReservedBytes() >= 1064);
+}
+
+TEST_CASE("Util/Arena/SharedPtr")
+{
+    Util::Arena arena;
+
+    std::shared_ptr<std::string> str = std::allocate_shared<std::string>(
+        Util::ArenaAllocator<std::string>(arena), "some text");
+    REQUIRE(*str == "some text");
+    REQUIRE(arena.getReservedBytes() > 0);
+
+    // Releasing the object doesn't free its memory, but the destructor is run.
+    std::weak_ptr<std::string> ref = str;
+    str.reset();
+    REQUIRE(ref.expired());
+}
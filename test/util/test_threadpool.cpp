@@ -0,0 +1,58 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <util/threadpool.h>
+
+TEST_CASE("Util/ThreadPool/Results")
+{
+    Util::ThreadPool pool(2);
+    REQUIRE(pool.getThreadCount() == 2);
+
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 10; ++i)
+        results.push_back(pool.submit([i]() { return i * i; }));
+
+    for (int i = 0; i < 10; ++i)
+        REQUIRE(results[i].get() == i * i);
+}
+
+TEST_CASE("Util/ThreadPool/Exceptions")
+{
+    Util::ThreadPool pool(1);
+
+    auto result = pool.submit([]() -> int {
+        throw std::runtime_error("error");
+    });
+
+    REQUIRE_THROWS_AS(result.get(), std::runtime_error);
+}
+
+TEST_CASE("Util/ThreadPool/WaitForAll")
+{
+    std::atomic<int> counter(0);
+
+    Util::ThreadPool pool(4);
+    for (int i = 0; i < 100; ++i)
+        pool.submit([&]() { ++counter; });
+
+    pool.waitForAll();
+    REQUIRE(counter == 100);
+}
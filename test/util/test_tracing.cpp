@@ -0,0 +1,108 @@
+/*
+  * Copyright (C) 2021 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <doctest/doctest.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <util/tracing.h>
+
+static std::string writeTrace()
+{
+    std::ostringstream os;
+    Util::Tracing::writeJson(os);
+    return os.str();
+}
+
+TEST_CASE("Util/Tracing/Disabled")
+{
+    Util::Tracing::start();
+    Util::Tracing::stop();
+    REQUIRE(!Util::Tracing::isEnabled());
+
+    bool built_detail = false;
+    auto get_detail = [&]() {
+        built_detail = true;
+        return std::string("detail");
+    };
+
+    {
+        PTE_TRACE_SCOPE("DisabledSpan");
+        PTE_TRACE_SCOPE_DETAIL("DisabledDetailSpan", get_detail());
+    }
+
+    REQUIRE(writeTrace().find("DisabledSpan") == std::string::npos);
+    // The detail isn't built when tracing is disabled.
+    REQUIRE(!built_detail);
+}
+
+TEST_CASE("Util/Tracing/Spans")
+{
+    Util::Tracing::start();
+    REQUIRE(Util::Tracing::isEnabled());
+
+    {
+        PTE_TRACE_SCOPE("Outer");
+        PTE_TRACE_SCOPE_DETAIL("Inner", "file \"a\\b\".pt2");
+    }
+
+    std::thread worker([]() {
+        Util::Tracing::setThreadName("Worker");
+        PTE_TRACE_SCOPE("WorkerSpan");
+    });
+    worker.join();
+
+    Util::Tracing::stop();
+
+    const std::string trace = writeTrace();
+    REQUIRE(trace.rfind("{\"traceEvents\":[", 0) == 0);
+    REQUIRE(trace.find("\"name\":\"Outer\",\"cat\":\"pte\",\"ph\":\"X\"") !=
+            std::string::npos);
+    REQUIRE(trace.find("\"name\":\"Inner\"") != std::string::npos);
+    REQUIRE(trace.find("\"detail\":\"file \\\"a\\\\b\\\".pt2\"") !=
+            std::string::npos);
+    REQUIRE(trace.find("\"name\":\"WorkerSpan\"") != std::string::npos);
+    REQUIRE(trace.find("\"args\":{\"name\":\"Worker\"}") != std::string::npos);
+
+    // Restarting the trace discards the previous events.
+    Util::Tracing::start();
+    Util::Tracing::stop();
+    REQUIRE(writeTrace().find("Outer") == std::string::npos);
+}
+
+TEST_CASE("Util/Tracing/TotalDurations")
+{
+    Util::Tracing::start();
+
+    for (int i = 0; i < 3; ++i)
+    {
+        PTE_TRACE_SCOPE("Repeated");
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::thread worker([]() { PTE_TRACE_SCOPE("Repeated"); });
+    worker.join();
+
+    Util::Tracing::stop();
+
+    const std::map<std::string, int64_t> durations =
+        Util::Tracing::getTotalDurations();
+    REQUIRE(durations.size() == 1);
+    REQUIRE(durations.count("Repeated") == 1);
+    REQUIRE(durations.at("Repeated") >= 3'000'000);
+}